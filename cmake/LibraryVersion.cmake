@@ -0,0 +1,31 @@
+#
+# Copyright (c) 2023 Vector Informatik GmbH
+# 
+# SPDX-License-Identifier: MIT
+#
+
+# Script (cmake -P) that writes the library version into a header, it is run on every build so the version follows the source tree.
+# Parameters: SOURCE_DIR (the directory of the git repository) and OUTPUT (the path of the header).
+# The header is only rewritten if the version changed, so the files that include it are not rebuilt otherwise.
+set(BTF_LIBRARY_VERSION "unknown")
+find_package(Git QUIET)
+if(GIT_FOUND)
+  execute_process(COMMAND ${GIT_EXECUTABLE} describe --tags --always --dirty
+                  WORKING_DIRECTORY "${SOURCE_DIR}"
+                  RESULT_VARIABLE GIT_DESCRIBE_RESULT
+                  OUTPUT_VARIABLE GIT_DESCRIBE_OUTPUT
+                  OUTPUT_STRIP_TRAILING_WHITESPACE
+                  ERROR_QUIET)
+  if(GIT_DESCRIBE_RESULT EQUAL 0)
+    set(BTF_LIBRARY_VERSION "${GIT_DESCRIBE_OUTPUT}")
+  endif()
+endif()
+
+set(CONTENT "#pragma once\n\n#define BTF_LIBRARY_VERSION \"${BTF_LIBRARY_VERSION}\"\n")
+set(OLD_CONTENT "")
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" OLD_CONTENT)
+endif()
+if(NOT CONTENT STREQUAL OLD_CONTENT)
+  file(WRITE "${OUTPUT}" "${CONTENT}")
+endif()
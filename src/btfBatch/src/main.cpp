@@ -0,0 +1,219 @@
+/* main.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/batch_conversion.h"
+
+#include "helper/helper.h"
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/*!
+    @brief Prints the usage of the command line tool.
+*/
+static void printUsage()
+{
+    std::cout << "Usage: btfbatch [options] -o <output directory> <input.btf>...\n"
+                 "Converts many BTF files concurrently. Each output file gets the name of its input file,\n"
+                 "the position of the input is appended to a name that is already used.\n"
+                 "Options:\n"
+                 "  -o <dir>              output directory (required)\n"
+                 "  -j <n>                number of files that are converted at the same time (default: one per hardware thread)\n"
+                 "  -t <ps|ns|us|ms>      timescale of the traces (default: ns)\n"
+                 "  -d <c>                delimiter of the input files (default: ,)\n"
+                 "  --source-is-process   runnable, OS, signal, scheduler and semaphore events have a process as source\n"
+                 "  --no-auto-suspend     do not suspend parent runnables at the start of a sub-runnable\n"
+                 "  --gzip, --zstd        compress the output files\n"
+                 "  -l <file>             write the log to a file instead of the standard output\n"
+                 "  --cache <dir>         take the output of unchanged inputs from a conversion cache in this directory\n"
+                 "  --cache-size <MiB>    maximum size of the cache, least recently used entries are removed (default: no limit)\n"
+                 "  --link-cached         link the output files to the cache instead of copying them\n";
+}
+
+/*!
+    @brief Gets the name of an output file: the name of the input file without compression extension and with the extension of the
+    output compression.
+    @param[in] input_path The path of the input file.
+    @param[in] compression The compression of the output file.
+    @param[in] suffix The suffix that is appended to the name before its extension, e.g. to make it unique.
+    @return The name of the output file.
+*/
+static std::string getOutputName(const std::filesystem::path& input_path, btf::Compressions compression, const std::string& suffix)
+{
+    auto name = input_path.filename().string();
+    for (const std::string_view extension : {".gz", ".zst"})
+    {
+        if (name.size() > extension.size() && name.ends_with(extension))
+        {
+            name.resize(name.size() - extension.size());
+        }
+    }
+    if (!suffix.empty())
+    {
+        const std::filesystem::path path(name);
+        name = path.stem().string() + suffix + path.extension().string();
+    }
+    if (compression == btf::Compressions::gzip)
+    {
+        name += ".gz";
+    }
+    else if (compression == btf::Compressions::zstd)
+    {
+        name += ".zst";
+    }
+    return name;
+}
+
+int main(int argc, char** argv)
+{
+    btf::BatchConversionOptions options;
+    std::filesystem::path output_directory;
+    std::string log_file;
+    std::vector<std::filesystem::path> inputs;
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool has_value = i + 1 < args.size();
+        if (arg == "-o" && has_value)
+        {
+            output_directory = args[++i];
+        }
+        else if (arg == "-j" && has_value)
+        {
+            options.number_of_threads_ = std::stoul(args[++i]);
+        }
+        else if (arg == "-t" && has_value)
+        {
+            const auto& scale = args[++i];
+            if (scale == "ps")
+            {
+                options.time_scale_ = btf::BtfFile::TimeScales::pico_seconds;
+            }
+            else if (scale == "ns")
+            {
+                options.time_scale_ = btf::BtfFile::TimeScales::nano_seconds;
+            }
+            else if (scale == "us")
+            {
+                options.time_scale_ = btf::BtfFile::TimeScales::micro_seconds;
+            }
+            else if (scale == "ms")
+            {
+                options.time_scale_ = btf::BtfFile::TimeScales::milli_seconds;
+            }
+            else
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (arg == "-d" && has_value && args[i + 1].size() == 1)
+        {
+            options.delimiter_ = args[++i][0];
+        }
+        else if (arg == "-l" && has_value)
+        {
+            log_file = args[++i];
+        }
+        else if (arg == "--cache" && has_value)
+        {
+            options.cache_directory_ = args[++i];
+        }
+        else if (arg == "--cache-size" && has_value)
+        {
+            options.cache_max_size_ = std::stoull(args[++i]) << 20U;
+        }
+        else if (arg == "--link-cached")
+        {
+            options.link_cached_outputs_ = true;
+        }
+        else if (arg == "--source-is-process")
+        {
+            options.source_is_core_ = false;
+        }
+        else if (arg == "--no-auto-suspend")
+        {
+            options.auto_suspend_parent_runnable_ = false;
+        }
+        else if (arg == "--gzip")
+        {
+            options.output_compression_ = btf::Compressions::gzip;
+        }
+        else if (arg == "--zstd")
+        {
+            options.output_compression_ = btf::Compressions::zstd;
+        }
+        else if (!arg.starts_with("-"))
+        {
+            inputs.emplace_back(arg);
+        }
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (output_directory.empty() || inputs.empty())
+    {
+        printUsage();
+        return 2;
+    }
+    if (!btf::isCompressionSupported(options.output_compression_))
+    {
+        std::cout << "The compression is not supported by this build.\n";
+        return 2;
+    }
+
+    helper::logging::initLogging(helper::logging::LogLevel::warning, log_file);
+    std::error_code error;
+    std::filesystem::create_directories(output_directory, error);
+
+    // inputs with the same name (e.g. a/trace.btf and b/trace.btf, or trace.btf and trace.btf.gz) would share an output file, the
+    // position of the later input in the list is appended to its name
+    std::vector<btf::BatchJob> jobs;
+    std::unordered_set<std::string> output_names;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        auto name = getOutputName(inputs[i], options.output_compression_, "");
+        if (!output_names.insert(name).second)
+        {
+            std::string suffix;
+            do
+            {
+                suffix += "_" + std::to_string(i + 1);
+                name = getOutputName(inputs[i], options.output_compression_, suffix);
+            } while (!output_names.insert(name).second);
+        }
+        jobs.push_back({inputs[i].string(), (output_directory / name).string()});
+    }
+
+    size_t failed_jobs{0};
+    // the results are printed through the logging, so they do not interleave with the warnings of the worker threads
+    btf::convertBatch(jobs, options, [&failed_jobs](const btf::BatchJobResult& result) {
+        std::ostringstream line;
+        if (result.is_success_)
+        {
+            line << (result.is_cache_hit_ ? "cached " : "converted ") << result.job_.input_path_ << " -> " << result.job_.output_path_ << " ("
+                 << result.import_.lines_ << " lines, " << result.import_.rejected_lines_ << " rejected, " << result.seconds_ << " s)\n";
+        }
+        else
+        {
+            ++failed_jobs;
+            line << "FAILED " << result.job_.input_path_ << ": " << result.error_ << "\n";
+        }
+        helper::logging::printOutput(line.str());
+    });
+    helper::logging::printOutput(std::to_string(jobs.size() - failed_jobs) + " of " + std::to_string(jobs.size()) + " files converted\n");
+    return failed_jobs == 0 ? 0 : 1;
+}
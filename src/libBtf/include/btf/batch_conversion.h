@@ -0,0 +1,115 @@
+#pragma once
+
+/* batch_conversion.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "btf.h"
+#include "conversion_cache.h"
+
+namespace btf
+{
+
+/*!
+    @brief Options of a batch conversion, see convertBatch(). They are applied to every job.
+*/
+struct BatchConversionOptions
+{
+    /// The timescale of the BTF traces.
+    BtfFile::TimeScales time_scale_{BtfFile::TimeScales::nano_seconds};
+
+    /// See the constructor of BtfFile.
+    bool auto_suspend_parent_runnable_{true};
+
+    /// See the constructor of BtfFile.
+    bool source_is_core_{true};
+
+    /// See the constructor of BtfFile.
+    bool auto_generate_core_events_{false};
+
+    /// See the constructor of BtfFile.
+    bool auto_wait_resume_os_events_{false};
+
+    /// The delimiter used in the input files.
+    char delimiter_{','};
+
+    /// The number of faulty lines that are kept as samples per category of problems.
+    size_t max_samples_per_category_{5};
+
+    /// The compression of the output files.
+    Compressions output_compression_{Compressions::none};
+
+    /// The number of jobs that are converted at the same time (0 for one per hardware thread).
+    size_t number_of_threads_{0};
+
+    /// The directory of the ConversionCache, an unchanged input is then not converted again (empty to disable the cache).
+    std::string cache_directory_;
+
+    /// The maximum size of the cache in bytes (0 for no limit).
+    uint64_t cache_max_size_{0};
+
+    /// True to link the output files to the cached files instead of copying them, see ConversionCache::setLinkOutputs().
+    bool link_cached_outputs_{false};
+};
+
+/*!
+    @brief A job of a batch conversion: an input file that is imported and written to an output file.
+*/
+struct BatchJob
+{
+    /// The path of the input BTF file.
+    std::string input_path_;
+
+    /// The path of the output BTF file.
+    std::string output_path_;
+};
+
+/*!
+    @brief The result of a job of a batch conversion.
+*/
+struct BatchJobResult
+{
+    /// The job.
+    BatchJob job_;
+
+    /// True if the output file was written. Faulty lines of the input do not fail a job, see import_.
+    bool is_success_{false};
+
+    /// The reason why the job failed (empty on success).
+    std::string error_;
+
+    /// The summary of the import (the stored summary if the output was taken from the cache).
+    ImportSummary import_;
+
+    /// True if the output was taken from the cache.
+    bool is_cache_hit_{false};
+
+    /// The duration of the job in seconds.
+    double seconds_{0.0};
+};
+
+/*!
+    @brief Converts many BTF files concurrently. Every worker thread converts one job after another with its own BtfFile,
+        which is reset() between the jobs. With a cache directory, the output of an input that was converted before with the same
+        options is taken from the ConversionCache. \n
+        A failing job (e.g. an input file that cannot be read or an output file that cannot be written) does not stop the other
+        jobs, the failure is reported in its result.
+    @param[in] jobs The jobs.
+    @param[in] options The options that are applied to every job.
+    @param[in] on_job_finished Called after each job with its result, e.g. to report the progress. The calls are serialized,
+               but they are made from the worker threads.
+    @return The results in the order of the jobs.
+*/
+std::vector<BatchJobResult> convertBatch(const std::vector<BatchJob>& jobs, const BatchConversionOptions& options = {},
+                                         const std::function<void(const BatchJobResult&)>& on_job_finished = {});
+} // namespace btf
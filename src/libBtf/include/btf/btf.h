@@ -11,8 +11,10 @@
 #include <algorithm>
 #include <any>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <ranges>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -21,10 +23,19 @@
 #include <vector>
 
 #include "btf_entity_types.h"
+#include "btf_index.h"
 #include "btf_signal.h"
+#include "checkpoint.h"
 #include "common.h"
+#include "compression.h"
 #include "core.h"
+#include "entity_hash.h"
+#include "import_diagnostics.h"
+#include "import_filter.h"
+#include "input_source.h"
+#include "line_scanner.h"
 #include "os.h"
+#include "output_rotation.h"
 #include "process.h"
 #include "runnable.h"
 #include "scheduler.h"
@@ -50,6 +61,8 @@
 namespace btf
 {
 
+class StateKeyframeBuilder;
+
 /*!
     @brief This struct generates a hash out of two values (uses a pair).
 */
@@ -185,7 +198,7 @@ class BtfEntry
     @param[in] hash_map Unordered map which contains all hash values of the current BtfEntry.
     @return String if type_ and Events type are valid, else a fatal error is triggered.
     */
-    std::string toString(std::unordered_map<size_t, std::string>& hash_map) const;
+    std::string toString(const std::unordered_map<size_t, std::string>& hash_map) const;
 
     /*!
     @brief Converts union Events into string according to the type_ of the BtfEntry.
@@ -194,6 +207,34 @@ class BtfEntry
     std::string eventToString() const;
 };
 
+/*!
+    @brief Function object that turns an iterator into the event store into a const reference to the BtfEntry.
+*/
+struct DereferenceEntry
+{
+    /*!
+        @brief Dereferences the iterator.
+        @param[in] it The iterator.
+        @return The BtfEntry.
+    */
+    const BtfEntry& operator()(std::list<BtfEntry>::iterator it) const
+    {
+        return *it;
+    }
+};
+
+/// Read-only view on all events of a BtfFile (bidirectional, the events are not copied).
+using EventsView = std::ranges::ref_view<const std::list<BtfEntry>>;
+
+/// Read-only view on the events of an entity of a BtfFile (bidirectional, the events are not copied).
+using EntityEventsView = std::ranges::transform_view<std::ranges::ref_view<const std::list<std::list<BtfEntry>::iterator>>, DereferenceEntry>;
+
+/// Read-only range of consecutive events of a BtfFile (bidirectional, the events are not copied).
+using EventsRange = std::ranges::subrange<std::list<BtfEntry>::const_iterator>;
+
+/// Read-only range of consecutive events of an entity of a BtfFile (bidirectional, the events are not copied).
+using EntityEventsRange = std::ranges::transform_view<std::ranges::subrange<std::list<std::list<BtfEntry>::iterator>::const_iterator>, DereferenceEntry>;
+
 /*!
     @brief Main class of the btf lib.
     It contains all necessary functions to import and export a BTF file.
@@ -243,17 +284,101 @@ class BtfFile
     explicit BtfFile(std::string path, TimeScales time_scale = TimeScales::nano_seconds, bool auto_suspend_parent_runnable = true,
                      bool source_is_core = true, bool auto_generate_core_events = false, bool auto_wait_resume_os_events = false);
 
+    /// Move Constructor, the events and the conversion state are moved. The moved-from BtfFile can be used again after reset().
+    BtfFile(BtfFile&&) = default;
+
+    /// Move assignment operator, see the Move Constructor.
+    BtfFile& operator=(BtfFile&&) = default;
+
+    /*!
+        @brief Discards the events and the conversion state, so the BtfFile can convert another trace into another file.
+            The options (time scale, auto generation, output settings, error sink, ...) are kept. The state tables keep their
+            capacity, so converting many traces one after another with the same BtfFile does not grow them again for every trace.
+        @param[in] path The path to the new output BTF file.
+    */
+    void reset(std::string path);
+
     /*!
         @brief Writes all BtfEntry instances to file.
     */
     void finish();
 
+    /*!
+        @brief Writes the complete conversion state (state machines, entity names and types, instance counters and all events that
+            were not written yet) into a compact binary snapshot, so a long conversion can be resumed with restore() after a crash.
+        @param[in] path The path of the snapshot.
+        @return True if the snapshot was written.
+    */
+    bool checkpoint(const std::string& path) const;
+
+    /*!
+        @brief Replaces the conversion state by a snapshot of checkpoint(). Continuing the conversion after restore() produces the
+            same output as an uninterrupted conversion. The BtfFile must be constructed with the same options and entity hasher as
+            the one that wrote the snapshot, the options are not part of the snapshot.
+        @param[in] path The path of the snapshot.
+        @return False if the snapshot cannot be read or is corrupted, the state is then unchanged.
+    */
+    bool restore(const std::string& path);
+
+    /*!
+        @brief Prepares appending new events to the existing BTF file at the path of this BtfFile. \n
+            The state at the end of the file (running tasks per core, runnable stacks, instance counters, last timestamp, ...)
+            is restored from the state trailer written by a previous finish() (see setWriteStateTrailer()). If there is no
+            trailer or it does not match the file, the state is rebuilt by importing the file, which requires options suitable
+            for the import. The events of the file are not kept in memory, finish() then appends the new events to the file
+            in place. In append mode, finish() ignores the header entries, the compression, the rotation and the split by core.
+            Events that would modify already written events (runnables whose task was not known yet, removed core execute events)
+            are left as they are in the file.
+        @return False if the file does not exist or is compressed.
+    */
+    bool openForAppend();
+
     /*!
         @brief Appends the data from a BTF file. Currently only import into an empty BTF file is supported.
+        gzip and zstd compressed files are detected by their magic bytes and decompressed while they are parsed.
+        @param[in] path The path to the BTF file ("-" for the standard input).
+        @param[in] delimiter The delimiter used in the BTF file.
+        @param[in] max_samples_per_category The number of faulty lines that are kept as samples per category of problems.
+        @param[in] filter Selects the imported events by entity type, entity name and time, see ImportFilter.
+        @return The summary of the import. Faulty lines are counted per category instead of being logged one by one,
+                a single aggregated warning is logged at the end of the import.
+    */
+    ImportSummary importFromFile(const std::string& path, char delimiter = ',', size_t max_samples_per_category = 5, const ImportFilter& filter = {});
+
+    /*!
+        @brief Appends the data from an input source, e.g. the standard input or a pipe, see importFromFile().
+        The source is read by a background thread, so reading overlaps with parsing.
+        @param[in] source The input source.
+        @param[in] delimiter The delimiter used in the BTF file.
+        @param[in] max_samples_per_category The number of faulty lines that are kept as samples per category of problems.
+        @param[in] filter Selects the imported events by entity type, entity name and time, see ImportFilter.
+        @return The summary of the import.
+    */
+    ImportSummary importFromSource(InputSource& source, char delimiter = ',', size_t max_samples_per_category = 5, const ImportFilter& filter = {});
+
+    /*!
+        @brief Appends the data from a BTF file like importFromFile(), but splits the file by time into partitions that are converted
+            in parallel. \n
+            The first partition is imported into this BtfFile, every other partition into a BtfFile of its own that starts in
+            unknown state. A reconciliation pass then stitches the partitions in order: events whose result depends on the state
+            at the start of the partition (e.g. tasks and runnables that were running at the boundary, stimulus instance IDs)
+            are replayed on the state of the previous partitions until the entities are in sync again, all other events are
+            taken over with their runnable instance IDs and pre-task runnable sources fixed up. Rejected lines are replayed as
+            well, since they may be valid on the state of the previous partitions. The result is identical to a serial import:
+            a partition with problems that do not reject their line (e.g. an invalid migration) is imported again serially,
+            and if a partition cannot be stitched exactly the whole file is imported serially. \n
+            The file is imported serially if this BtfFile is not empty, the file is compressed or the standard input, or core,
+            wait and resume events are generated automatically. \n
+            The stitching of runnables is only supported if the source of runnable events is a process (source_is_core is false):
+            with the default source_is_core, every partition except the first one that contains runnable events is imported
+            again serially (see ParallelImportSummary::reimported_partitions_), so only traces without runnables are sped up.
         @param[in] path The path to the BTF file.
+        @param[in] number_of_partitions The number of partitions (0 for one per hardware thread, at least 1 MiB per partition).
         @param[in] delimiter The delimiter used in the BTF file.
+        @param[in] max_samples_per_category The number of faulty lines that are kept as samples per category of problems.
+        @return The summary of the import and of the partitioning.
     */
-    void importFromFile(const std::string& path, char delimiter = ',');
+    ParallelImportSummary importFromFileParallel(const std::string& path, size_t number_of_partitions = 0, char delimiter = ',', size_t max_samples_per_category = 5);
 
     /*!
         @brief Sets the ID to name translation map. This should only be used for traces that use ID based APIs (e.g. for naming of events). \n
@@ -479,7 +604,20 @@ class BtfFile
     ErrorCodes stimulusEvent(uint64_t time, size_t stimulus_hash, Stimulus::Events stimulus_event);
     
     
+    /*!
+        @brief Gets a copy of the list of events for a entity. The per-entity index is built on the first query. \n
+           Kept for compatibility, prefer viewEventsForEntity() which does not copy the list.
+        @param[in] entity The entity.
+        @return The list of events for that entity.
+    */
     std::list<std::list<BtfEntry>::iterator> getEventsForEntity(const std::string& entity);
+
+    /*!
+        @brief Gets a copy of the list of events for a entity. The per-entity index is built on the first query. \n
+           Kept for compatibility, prefer viewEventsForEntity() which does not copy the list.
+        @param[in] entity_hash The ID of the entity.
+        @return The list of events for that entity.
+    */
     std::list<std::list<BtfEntry>::iterator> getEventsForEntity(size_t entity_hash);
 
     /*!
@@ -504,18 +642,75 @@ class BtfFile
     void insertEvent(std::list<std::list<BtfEntry>::iterator>::iterator pos, const BtfEntry& entry);
 
     /*!
-        @brief Gets the list of events for a entity.
+        @brief Gets the list of events for a entity. The per-entity index is built on the first query.
         @param[in] entity The entity.
         @return The list of events for that entity.
     */
     std::list<std::list<BtfEntry>::iterator>& getEntityEvents(const std::string& entity);
 
     /*!
-        @brief Gets a list of all events.
+        @brief Gets a copy of the list of all events. \n
+           Kept for compatibility, prefer viewAllEvents() which does not copy the events.
         @return All events.
     */
     std::list<BtfEntry> getAllEvents() const;
 
+    /*!
+        @brief Gets a view on all events without copying them. \n
+           The view is invalidated by finish().
+        @return View on all events in trace order.
+    */
+    EventsView viewAllEvents() const;
+
+    /*!
+        @brief Gets a view on the events of a entity without copying them. The per-entity index is built on the first query. \n
+           The view is invalidated by finish() and follows events emitted after the call, also for an entity without events yet.
+        @param[in] entity The entity.
+        @return View on the events of the entity in trace order (empty for an unknown entity).
+    */
+    EntityEventsView viewEventsForEntity(const std::string& entity);
+
+    /*!
+        @brief Gets a view on the events of a entity without copying them. The per-entity index is built on the first query. \n
+           The view is invalidated by finish() and follows events emitted after the call, also for an entity without events yet.
+        @param[in] entity_hash The ID of the entity.
+        @return View on the events of the entity in trace order (empty for an unknown entity).
+    */
+    EntityEventsView viewEventsForEntity(size_t entity_hash);
+
+    /*!
+        @brief Gets all events with a timestamp in [start_time, end_time) without copying them. \n
+           The sparse time index is searched, so the cost is O(log n + k) for k events in the range.
+           Comments have no timestamp: the comments between the events of the range are part of it, like in the written file.
+           The range is invalidated by finish().
+        @param[in] start_time The first timestamp of the range.
+        @param[in] end_time The timestamp after the range.
+        @return The events in trace order.
+    */
+    EventsRange eventsInRange(uint64_t start_time, uint64_t end_time) const;
+
+    /*!
+        @brief Gets the events of a entity with a timestamp in [start_time, end_time) without copying them. \n
+           The per-entity index is built on the first query. The cost is O(log n + k) for n events of the entity and k events in the range.
+           The range is invalidated by finish().
+        @param[in] entity The entity.
+        @param[in] start_time The first timestamp of the range.
+        @param[in] end_time The timestamp after the range.
+        @return The events of the entity in trace order.
+    */
+    EntityEventsRange eventsInRange(const std::string& entity, uint64_t start_time, uint64_t end_time);
+
+    /*!
+        @brief Gets the events of a entity with a timestamp in [start_time, end_time) without copying them. \n
+           The per-entity index is built on the first query. The cost is O(log n + k) for n events of the entity and k events in the range.
+           The range is invalidated by finish().
+        @param[in] entity_hash The ID of the entity.
+        @param[in] start_time The first timestamp of the range.
+        @param[in] end_time The timestamp after the range.
+        @return The events of the entity in trace order.
+    */
+    EntityEventsRange eventsInRange(size_t entity_hash, uint64_t start_time, uint64_t end_time);
+
     /*!
         @brief Gets the number of all events.
         @return The number of events.
@@ -576,22 +771,417 @@ class BtfFile
     */
     ErrorCodes simulationEventThreadCreation(uint64_t time, size_t thread_hash, uint64_t tid, uint64_t pid);
 
+    /*!
+        @brief Sets the function that hashes entity names into entity IDs (default: hashEntityName).
+               Must be called before the first event is emitted or imported.
+        @param[in] hasher The hash function.
+    */
+    void setEntityHasher(EntityHasher hasher);
+
+    /*!
+        @brief Gets the entity ID of an entity name, as it is used by the functions with entity names.
+        @param[in] name The entity name.
+        @return The entity ID.
+    */
+    size_t hashName(std::string_view name) const;
+
+    /*!
+        @brief Callback that receives the errors of emit calls.
+        @param[in] error The error code, that is also returned by the emit call.
+        @param[in] rejected_entry The event that could not be emitted. Source and target are the entities that were passed to the emit call,
+                                  instance IDs are only set if they are known at this point.
+        @param[in] is_generated True if the event was generated automatically by the library (e.g. a runnable suspend or a core idle event).
+    */
+    using ErrorSink = std::function<void(ErrorCodes error, const BtfEntry& rejected_entry, bool is_generated)>;
+
+    /*!
+        @brief Sets the error sink. Every emit call that fails passes its error to the error sink, in addition to returning the error code.
+               If an automatically generated event fails, the error is passed to the error sink and the conversion continues.
+               Without an error sink such a failure is a fatal error.
+        @param[in] error_sink The error sink. An empty function removes the error sink.
+    */
+    void setErrorSink(ErrorSink error_sink);
+
     /*!
        @brief Sets the option to ignore multiple releases on a waiting task.
        @param[in] value If true ignore multiple releases on a waiting task, else consider them.
      */
     void setIgnoreMultipleTaskReleases(bool value);
 
+    /*!
+       @brief Sets the option to write a sidecar index (see getSidecarIndexPath()) in finish(). \n
+           With the index, the BTF file is written in binary mode, i.e. with LF line endings on all platforms.
+       @param[in] value If true, finish() writes the sidecar index.
+     */
+    void setWriteSidecarIndex(bool value);
+
+    /*!
+       @brief Sets the compression of the file written by finish(). \n
+           The file is written in independently compressed blocks (gzip members or zstd frames) that are compressed in parallel,
+           it stays decodable by zcat/zstdcat. A block table (see getBlockTablePath()) is written alongside, so readers can seek
+           with CompressedBtfFile. The sidecar index (see setWriteSidecarIndex()) is not written for compressed files.
+       @param[in] compression The compression format, none writes plain text (default).
+       @param[in] block_size The uncompressed size of the blocks.
+       @return False if the compression format is not supported by the build, the setting is not changed.
+     */
+    bool setOutputCompression(Compressions compression, size_t block_size = size_t{4} << 20U);
+
+    /*!
+       @brief Sets the rotation of the output of finish(). \n
+           With any limit set, finish() splits the events into parts "name.000.btf", "name.001.btf", ... (see getRotationPartPath())
+           instead of writing one file. Each part has the complete header and can be loaded on its own, processes that run across a
+           cut start in the next part without their start event, like in a trace whose recording started late. A JSON manifest
+           (see getRotationManifestPath()) lists the parts. Compression and sidecar index settings apply to every part.
+       @param[in] rotation The limits of the parts, see OutputRotation.
+     */
+    void setOutputRotation(const OutputRotation& rotation);
+
+    /*!
+       @brief Sets the option that finish() writes one file per core instead of one file. \n
+           The file of a core (see getCoreSplitPath()) contains the core events and all events whose source runs on the core at the
+           time of the event, e.g. the task and ISR events of the core and the runnable, signal, semaphore and OS events of the
+           processes running on it. A migrated process moves to the file of its new core. Events whose source is not bound to a core
+           (e.g. stimuli and semaphore state changes) are not written. The files are formatted in parallel, compression and the
+           sidecar index apply to every file, the rotation is not applied. If the names of two cores map to the same file name,
+           the later core gets its ID appended to the name.
+       @param[in] value True to split the output by core.
+     */
+    void setSplitByCore(bool value);
+
+    /*!
+       @brief Sets the option that finish() additionally writes the state at the end of the file into a state trailer
+           (see getStateTrailerPath()), so openForAppend() can continue the file without importing it. The trailer is only
+           written for uncompressed output that is neither rotated nor split.
+       @param[in] value True to write the state trailer.
+     */
+    void setWriteStateTrailer(bool value);
+
+    /*!
+       @brief Sets the intervals of the state keyframes that finish() records while it writes the file. The keyframes are written
+           next to the file (see getStateKeyframesPath()) and allow StateKeyframes::stateAt() to jump to any time of the trace.
+           They are only recorded for uncompressed output that is neither rotated, split nor appended.
+       @param[in] event_interval The number of events between two keyframes (0 to disable).
+       @param[in] time_interval The time between two keyframes (0 to disable).
+     */
+    void setStateKeyframes(uint64_t event_interval, uint64_t time_interval = 0);
+
   private:
     /// Delete the Copy Constructor.
     BtfFile(BtfFile&) = delete;
-    /// Delete the Move Constructor.
-    BtfFile(BtfFile&&) = delete;
 
     /// Delete the copy assignment operator.
     void operator=(BtfFile&) = delete;
-    /// Delete the move assignment operator.
-    void operator=(BtfFile&&) = delete;
+
+    /*!
+        @brief State of an import that is carried from one line to the next.
+    */
+    struct ImportState
+    {
+        /// The filter of the import, nullptr if all lines are imported.
+        const ImportFilter* filter_{nullptr};
+
+        /// True if an event after the time window of the filter was read, the remaining lines are skipped.
+        bool is_after_window_{false};
+
+        /// True if the previous line was an enforced_migration event.
+        bool is_waiting_for_full_migration_event_{false};
+
+        /// The source core of the enforced_migration event.
+        std::string migration_source_core_;
+
+        /// The task of the enforced_migration event.
+        std::string migration_task_;
+
+        /// Buffer for the type field that is checked by the filter.
+        std::string filter_type_str_;
+    };
+
+    /*!
+        @brief A line of a partition of importFromFileParallel() and the events it produced.
+    */
+    struct PartitionLine
+    {
+        /// Offset of the line in the partition.
+        size_t offset_{0};
+
+        /// Length of the line without the newline.
+        size_t size_{0};
+
+        /// The entity type of the line, unknown if the line was skipped or could not be parsed.
+        EntityTypes type_{EntityTypes::unknown};
+
+        /// The ID of the task of a task or ISR line, the ID of the source of a runnable line.
+        size_t entity_hash_{0};
+
+        /// True if the line is an enforced_migration event that waits for its full_migration event.
+        bool is_migration_start_{false};
+
+        /// True if the line was rejected, e.g. the end of a runnable that started before the partition.
+        bool is_rejected_{false};
+
+        /// The first event of the line, only valid if the line produced events.
+        std::list<BtfEntry>::iterator first_entry_;
+
+        /// The number of events the line produced.
+        size_t number_of_entries_{0};
+    };
+
+    /*!
+        @brief Marks of the events of a partition that are needed to stitch the partition, see importFromFileParallel().
+    */
+    enum EntryMarks : uint8_t
+    {
+        /// The event was generated by the library, e.g. the suspend of a runnable at a preemption.
+        generated_entry = 1U,
+
+        /// The task event was the first allocating or deallocating event of its task or core, see trackDeAllocation().
+        first_de_allocation = 2U,
+
+        /// The runnable event got a new instance ID.
+        new_runnable_instance = 4U
+    };
+
+    /// State of importFromFileParallel() that is carried from one stitched partition to the next.
+    struct StitchState;
+
+    /*!
+       @brief Imports a line of a BTF file.
+       @param[in,out] line The line without newline, a carriage return at the end is removed.
+       @param[in] fields The positions of the delimiters of the line, see scanLines().
+       @param[in,out] diagnostics Collects the problems of the import.
+       @param[in,out] state The state of the import.
+       @return The entity type of the line, comment for comments and unknown if the line was skipped or could not be parsed.
+    */
+    EntityTypes importLine(std::string& line, const LineFields& fields, ImportDiagnostics& diagnostics, ImportState& state);
+
+    /*!
+       @brief Imports the lines of a partition of importFromFileParallel().
+       @param[in] data The lines of the partition, the last line must end with a newline.
+       @param[in] delimiter The delimiter used in the BTF file.
+       @param[in,out] diagnostics Collects the problems of the import.
+       @param[in,out] state The state of the import.
+       @param[out] partition_lines The lines with their events, nullptr if they are not recorded.
+    */
+    void importPartition(std::string_view data, char delimiter, ImportDiagnostics& diagnostics, ImportState& state, std::vector<PartitionLine>* partition_lines);
+
+    /*!
+       @brief Stitches a partition of importFromFileParallel() to the events and the state of this BtfFile.
+       @param[in,out] partition The BtfFile of the partition, its events are moved to this BtfFile.
+       @param[in] data The lines of the partition.
+       @param[in] partition_lines The lines of the partition with their events.
+       @param[in] delimiter The delimiter used in the BTF file.
+       @param[in,out] diagnostics Collects the problems of the replayed lines.
+       @param[in,out] state The state of the import.
+       @param[in,out] stitch_state The tasks that are known from the previous partitions.
+       @param[in,out] summary Counts the replayed lines.
+       @return False if the partition cannot be stitched exactly, the state of this BtfFile is then inconsistent.
+    */
+    bool mergePartition(BtfFile& partition, std::string_view data, const std::vector<PartitionLine>& partition_lines, char delimiter,
+                        ImportDiagnostics& diagnostics, ImportState& state, StitchState& stitch_state, ParallelImportSummary& summary);
+
+    /*!
+       @brief Checks if a task event is possible on the current core allocation, see emitProcessEvent().
+       @param[in] source_hash The ID of the source.
+       @param[in] task_id The ID and instance ID of the task.
+       @param[in] process_event The process event.
+       @return Success if the event is possible, else the error code.
+    */
+    ErrorCodes checkCoreAllocation(size_t source_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event);
+
+    /*!
+       @brief Updates the running task of the core and the core of the task after an emitted task event.
+       @param[in] source_hash The ID of the source.
+       @param[in] task_id The ID and instance ID of the task.
+       @param[in] process_event The process event.
+       @return True if it was the first allocating or deallocating event of the task or core, the runnables that were emitted
+               without task then belong to this task.
+    */
+    bool trackDeAllocation(size_t source_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event);
+
+    /*!
+       @brief Marks the last event of btf_entries_ while a partition of importFromFileParallel() is imported.
+       @param[in] mark The mark.
+    */
+    void markLastEntry(EntryMarks mark);
+
+    /*!
+       @brief Implementation of coreEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitCoreEvent(uint64_t time, const std::string& core, Core::Events core_event);
+
+    /*!
+       @brief Implementation of coreEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitCoreEvent(uint64_t time, size_t core_hash, Core::Events core_event);
+
+    /*!
+       @brief Implementation of osEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitOsEvent(uint64_t time, const std::string& process, const std::string& os, OS::Events os_event);
+
+    /*!
+       @brief Implementation of osEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitOsEvent(uint64_t time, size_t core_hash, size_t os_hash, OS::Events os_event);
+
+    /*!
+       @brief Implementation of taskMigrationEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitTaskMigrationEvent(uint64_t time, const std::string& source_core, const std::string& destination_core, const std::string& task, uint64_t task_instance_id);
+
+    /*!
+       @brief Implementation of taskMigrationEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitTaskMigrationEvent(uint64_t time, size_t source_core_hash, size_t destination_core_hash, size_t task_hash, uint64_t task_instance_id);
+
+    /*!
+       @brief Implementation of processEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitProcessEvent(uint64_t time, const std::string& source, const std::string& process, uint64_t process_instance_id, Process::Events process_event, bool is_isr = false);
+
+    /*!
+       @brief Implementation of processEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitProcessEvent(uint64_t time, size_t source_hash, size_t process_hash, uint64_t process_instance_id, Process::Events process_event, bool is_isr = false);
+
+    /*!
+       @brief Implementation of runnableEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitRunnableEvent(uint64_t time, const std::string& source, const std::string& runnable, Runnable::Events runnable_event);
+
+    /*!
+       @brief Implementation of runnableEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitRunnableEvent(uint64_t time, size_t core_hash, size_t process_hash, size_t runnable_hash, Runnable::Events runnable_event);
+
+    /*!
+       @brief Implementation of semaphoreEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSemaphoreEvent(uint64_t time, const std::string& source, const std::string& target, Semaphore::Events semaphore_event, uint64_t note);
+
+    /*!
+       @brief Implementation of semaphoreEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSemaphoreEvent(uint64_t time, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note);
+
+    /*!
+       @brief Implementation of semaphoreEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSemaphoreEvent(uint64_t time, size_t core_hash, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note);
+
+    /*!
+       @brief Implementation of schedulerEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSchedulerEvent(uint64_t time, const std::string& source, const std::string& scheduler, Scheduler::Events scheduler_event);
+
+    /*!
+       @brief Implementation of schedulerEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSchedulerEvent(uint64_t time, size_t core_hash, size_t scheduler_hash, Scheduler::Events scheduler_event);
+
+    /*!
+       @brief Implementation of schedulerEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSchedulerEvent(uint64_t time, size_t scheduler_hash, Scheduler::Events scheduler_event);
+
+    /*!
+       @brief Implementation of signalEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSignalEvent(uint64_t time, const std::string& source, const std::string& signal, Signal::Events signal_event, const std::string& signal_value = "");
+
+    /*!
+       @brief Implementation of signalEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSignalEvent(uint64_t time, size_t core_hash, size_t signal_hash, Signal::Events signal_event, const std::string& signal_value = "");
+
+    /*!
+       @brief Implementation of stimulusEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitStimulusEvent(uint64_t time, const std::string& source, const std::string& target, Stimulus::Events stimulus_event);
+
+    /*!
+       @brief Implementation of stimulusEvent (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitStimulusEvent(uint64_t time, size_t stimulus_hash, Stimulus::Events stimulus_event);
+
+    /*!
+       @brief Implementation of simulationEventProcessName (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventProcessName(uint64_t time, const std::string& process, const std::string& name);
+
+    /*!
+       @brief Implementation of simulationEventProcessName (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventProcessName(uint64_t time, size_t process_hash, const std::string& name);
+
+    /*!
+       @brief Implementation of simulationEventProcessCreation (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventProcessCreation(uint64_t time, const std::string& process, uint64_t pid, uint64_t ppid);
+
+    /*!
+       @brief Implementation of simulationEventProcessCreation (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventProcessCreation(uint64_t time, size_t process_hash, uint64_t pid, uint64_t ppid);
+
+    /*!
+       @brief Implementation of simulationEventThreadName (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventThreadName(uint64_t time, const std::string& thread, const std::string& name);
+
+    /*!
+       @brief Implementation of simulationEventThreadName (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventThreadName(uint64_t time, size_t thread_hash, const std::string& name);
+
+    /*!
+       @brief Implementation of simulationEventThreadCreation (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventThreadCreation(uint64_t time, const std::string& thread, uint64_t tid, uint64_t pid);
+
+    /*!
+       @brief Implementation of simulationEventThreadCreation (see there) that returns errors without reporting them to the error sink.
+    */
+    ErrorCodes emitSimulationEventThreadCreation(uint64_t time, size_t thread_hash, uint64_t tid, uint64_t pid);
+
+    /*!
+       @brief Generates a Runnable event (e.g. the suspend of a parent runnable).
+       @param[in] time The timestamp of the event.
+       @param[in] core_hash The ID of the core.
+       @param[in] process_hash The ID of the process.
+       @param[in] runnable_hash The ID of the runnable.
+       @param[in] runnable_event The runnable event.
+       @return True if the event was emitted or the error was passed to the error sink, else false.
+    */
+    bool generateRunnableEvent(uint64_t time, size_t core_hash, size_t process_hash, size_t runnable_hash, Runnable::Events runnable_event);
+
+    /*!
+       @brief Generates a Process event after an OS event (e.g. wait, release and resume). Errors are passed to the error sink, if available.
+       @param[in] time The timestamp of the event.
+       @param[in] core_hash The ID of the core.
+       @param[in] task_id The ID and instance ID of the task.
+       @param[in] process_event The process event.
+    */
+    void generateProcessEvent(uint64_t time, size_t core_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event);
+
+    /*!
+       @brief Passes an error to the error sink.
+       @param[in] error The error code.
+       @param[in] rejected_entry The event that could not be emitted.
+       @param[in] is_generated True if the event was generated automatically by the library.
+       @return True if an error sink is set, else false.
+    */
+    bool reportError(ErrorCodes error, const BtfEntry& rejected_entry, bool is_generated);
+
+    /*!
+       @brief Passes the error of an event of the public API to the error sink, see reportError(). The rejected event is only
+           built if there is an error.
+       @param[in] error The result of the emit function of the event.
+       @param[in] make_rejected_entry Function that returns the BtfEntry of the rejected event.
+       @return The error code.
+    */
+    template <typename MakeEntry>
+    ErrorCodes reported(ErrorCodes error, MakeEntry&& make_rejected_entry);
 
     /*!
        @brief Generates a Core event with the event type idle.
@@ -608,6 +1198,24 @@ class BtfFile
     */
     void generateCoreExecuteEvent(uint64_t time, size_t source_hash, Process::Events process_event);
 
+    /*!
+       @brief Adds the last event of btf_entries_ to the time index and, if it has already been built, to the per-entity index.
+       @param[in] entity_hash The ID of the entity the event belongs to.
+    */
+    void indexLastEvent(size_t entity_hash);
+
+    /*!
+       @brief Gets the entity an event is indexed for: the source of simulation events, otherwise the target.
+       @param[in] entry The event.
+       @return The ID of the entity.
+    */
+    static size_t getIndexedEntity(const BtfEntry& entry);
+
+    /*!
+       @brief Builds the per-entity index in one parallel pass over btf_entries_ (partitioned by entity), if not done yet.
+    */
+    void buildEntityIndex();
+
     /*!
        @brief Checks if the timestamps are ascending.
        @param[in] time The timestamp of the event.
@@ -623,6 +1231,45 @@ class BtfFile
     */
     ErrorCodes checkType(size_t hash, EntityTypes should_be_type);
 
+    /*!
+       @brief Adds the name of an entity to the ID to name translation map.
+       @param[in] hash The ID of the entity.
+       @param[in] name The name of the entity.
+       @return Success if the ID is new or already belongs to this name, else hash_collision ErrorCode.
+    */
+    ErrorCodes registerEntityName(size_t hash, const std::string& name);
+
+    /*!
+       @brief Writes the header and a range of the events to a file, as configured by setOutputCompression() and setWriteSidecarIndex().
+       @param[in] path The path of the file.
+       @param[in] first The first event (an iterator of BtfEntry or of const BtfEntry*).
+       @param[in] last The end of the range.
+       @param[in,out] keyframes Records the state keyframes of an uncompressed file, nullptr if no keyframes are recorded.
+       @return The uncompressed size of the file in bytes.
+    */
+    template <typename Iterator>
+    uint64_t writeEvents(const std::string& path, Iterator first, Iterator last, StateKeyframeBuilder* keyframes = nullptr);
+
+    /*!
+       @brief Clears the conversion state, i.e. the events and all data that requires much memory.
+    */
+    void clearState();
+
+    /*!
+       @brief Drops the events from memory after they were written, but keeps the state of the state machines.
+    */
+    void forgetWrittenEvents();
+
+    /*!
+       @brief Writes the events in parts as configured by setOutputRotation() and writes the manifest.
+    */
+    void writeRotatedParts();
+
+    /*!
+       @brief Assigns the events to the cores of their sources and writes one file per core in parallel.
+    */
+    void writeCoreFiles();
+
     /*!
        @brief Gets the Header of the BTF trace.
        @return Returns the three header lines as string.
@@ -667,9 +1314,28 @@ class BtfFile
     /// List that contains all BtfEntry objects.
     std::list<BtfEntry> btf_entries_;
 
-    /// Unordered map that keeps track of the BtfEntry objects per entity.
+    /// Unordered map that keeps track of the BtfEntry objects per entity. Only built on the first query, see buildEntityIndex().
     std::unordered_map<size_t, std::list<std::list<BtfEntry>::iterator>> btf_entries_per_entity_;
 
+    /// True if btf_entries_per_entity_ has been built and is kept up to date by the emit functions.
+    bool is_entity_index_built_{false};
+
+    /// Unordered map that keeps track of the last core event for each core.
+    std::unordered_map<size_t, std::list<BtfEntry>::iterator> last_core_events_;
+
+    /// Number of events between two entries of a time index.
+    static constexpr size_t time_index_interval_{64};
+
+    /// Sparse time index: timestamp and position of every time_index_interval_-th event (comments are not counted).
+    std::vector<std::pair<uint64_t, std::list<BtfEntry>::const_iterator>> time_index_;
+
+    /// Number of events that were emitted since the last entry of time_index_.
+    size_t events_since_time_index_entry_{0};
+
+    /// Sparse time index per entity: timestamp and position in btf_entries_per_entity_ of every time_index_interval_-th event of the entity.
+    /// Built and maintained together with btf_entries_per_entity_.
+    std::unordered_map<size_t, std::vector<std::pair<uint64_t, std::list<std::list<BtfEntry>::iterator>::const_iterator>>> entity_time_index_;
+
     /// Unordered map that keeps track of the type for each object (e.g. the hashed name).
     std::unordered_map<size_t, EntityTypes> type_map_; 
 
@@ -677,7 +1343,7 @@ class BtfFile
     std::unordered_map<size_t, std::pair<size_t, size_t>> current_running_tasks_;
 
     /// Pair value that is used if no task is running on a core.
-    const std::pair<size_t, size_t> no_running_task_{0, 0};
+    static constexpr std::pair<size_t, size_t> no_running_task_{0, 0};
 
     /// Unordered map that keeps track for each core if any allocating or deallocating task event occurred. 
     std::unordered_map<size_t, bool> did_de_allocated_task_event_occurred_on_core_; 
@@ -717,5 +1383,50 @@ class BtfFile
 
     ///  Boolean value that is false when multiple releases on task in state ready are ignored.
     bool ignore_multiple_task_releases_{ false };
+
+    /// Boolean value that is true when finish() writes a sidecar index.
+    bool write_sidecar_index_{false};
+
+    /// The compression of the file written by finish().
+    Compressions output_compression_{Compressions::none};
+
+    /// The uncompressed size of the compressed blocks.
+    size_t output_block_size_{size_t{4} << 20U};
+
+    /// The limits of the parts of a rotated output.
+    OutputRotation output_rotation_;
+
+    /// Boolean value that is true when finish() writes one file per core.
+    bool split_by_core_{false};
+
+    /// Boolean value that is true when finish() writes a state trailer.
+    bool write_state_trailer_{false};
+
+    /// Boolean value that is true when finish() appends to the existing file, see openForAppend().
+    bool is_appending_{false};
+
+    /// Size of the output file that is already written (in append mode).
+    uint64_t written_size_{0};
+
+    /// The number of events between two state keyframes (0 if disabled).
+    uint64_t keyframe_event_interval_{0};
+
+    /// The time between two state keyframes (0 if disabled).
+    uint64_t keyframe_time_interval_{0};
+
+    /// True while a partition of importFromFileParallel() is imported, its events are then marked.
+    bool is_marking_entries_{false};
+
+    /// True if a partition of importFromFileParallel() reached a state a serial import cannot reach, it is then imported again.
+    bool is_partition_unresolved_{false};
+
+    /// The marks of the events of a partition (bit mask of EntryMarks).
+    std::unordered_map<const BtfEntry*, uint8_t> entry_marks_;
+
+    /// The error sink (empty if not set).
+    ErrorSink error_sink_;
+
+    /// The function that hashes entity names into entity IDs.
+    EntityHasher hasher_{hashEntityName};
 };
 } // namespace btf
@@ -0,0 +1,218 @@
+#pragma once
+
+/* btf_index.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace btf
+{
+
+/*!
+    @brief Gets the path of the sidecar index of a BTF file ("trace.btf" -> "trace.btfidx", other paths get the suffix ".btfidx").
+    @param[in] btf_path The path of the BTF file.
+    @return The path of the sidecar index.
+*/
+std::string getSidecarIndexPath(const std::string& btf_path);
+
+/*!
+    @brief A block of consecutive event lines of a BTF file, as described by the sidecar index.
+*/
+struct BtfIndexBlock
+{
+    /// Number of bits of the entity bloom filter.
+    static constexpr size_t bloom_bits_{4096};
+
+    /// Byte offset of the first line of the block in the BTF file.
+    uint64_t offset_{0};
+
+    /// Size of the block in bytes.
+    uint64_t size_{0};
+
+    /// Number of lines (events and comments) in the block.
+    uint64_t number_of_lines_{0};
+
+    /// Smallest timestamp of the events in the block (comments are not considered, larger than max_time_ if the block has no events).
+    uint64_t min_time_{0};
+
+    /// Largest timestamp of the events in the block (comments are not considered).
+    uint64_t max_time_{0};
+
+    /// Checksum of the bytes of the block.
+    uint64_t checksum_{0};
+
+    /// Bloom filter over the IDs of the sources and targets of the events in the block.
+    std::array<uint64_t, bloom_bits_ / 64> bloom_{};
+
+    /*!
+        @brief Adds an entity to the bloom filter.
+        @param[in] entity_hash The ID of the entity.
+    */
+    void addEntity(size_t entity_hash);
+
+    /*!
+        @brief Checks if the block may contain events of an entity (false positives are possible, false negatives are not).
+        @param[in] entity_hash The ID of the entity.
+        @return False if the block does not contain events of the entity.
+    */
+    bool mayContainEntity(size_t entity_hash) const;
+};
+
+/*!
+    @brief Writes the event lines of a BTF file in blocks and collects the sidecar index of the file.
+*/
+class BtfIndexWriter
+{
+  public:
+    /// Number of lines per block.
+    static constexpr size_t lines_per_block_{4096};
+
+    /*!
+        @brief Constructor of the class BtfIndexWriter.
+        @param[in] out The stream of the BTF file (must be opened in binary mode, so the offsets match the file).
+    */
+    explicit BtfIndexWriter(std::ostream& out);
+
+    /*!
+        @brief Writes the header of the BTF file, must be called before the first line.
+        @param[in] header The header including the newline of the last header line.
+    */
+    void writeHeader(std::string_view header);
+
+    /*!
+        @brief Writes an event or comment line.
+        @param[in] line The line without newline.
+        @param[in] time The timestamp of the event.
+        @param[in] is_comment True if the line is a comment (neither the time nor the entities are indexed).
+        @param[in] source_hash The ID of the source.
+        @param[in] target_hash The ID of the target.
+    */
+    void writeLine(std::string_view line, uint64_t time, bool is_comment, size_t source_hash, size_t target_hash);
+
+    /*!
+        @brief Adds an entry to the entity name table of the index.
+        @param[in] entity_hash The ID of the entity.
+        @param[in] name The name of the entity.
+    */
+    void addEntityName(size_t entity_hash, std::string_view name);
+
+    /*!
+        @brief Writes the last block to the BTF file and the sidecar index.
+        @param[in] index_path The path of the sidecar index.
+        @return True if the index was written.
+    */
+    bool finish(const std::string& index_path);
+
+  private:
+    /*!
+        @brief Writes the current block to the BTF file.
+    */
+    void flushBlock();
+
+    /// The stream of the BTF file.
+    std::ostream& out_;
+
+    /// Number of bytes written to the BTF file.
+    uint64_t file_size_{0};
+
+    /// Size of the header in bytes.
+    uint64_t header_size_{0};
+
+    /// Checksum of the header.
+    uint64_t header_checksum_{0};
+
+    /// The lines of the current block.
+    std::string buffer_;
+
+    /// The current block.
+    BtfIndexBlock block_;
+
+    /// All written blocks.
+    std::vector<BtfIndexBlock> blocks_;
+
+    /// The entity name table.
+    std::unordered_map<size_t, std::string> names_;
+};
+
+/*!
+    @brief Sidecar index of a BTF file.
+
+    The index describes the event lines of the BTF file in blocks (byte range, time range and a bloom filter of the entities) and
+    contains the entity name table, hence readers can seek directly to the blocks relevant for a time window or a set of entities.
+*/
+class BtfIndex
+{
+  public:
+    /*!
+        @brief Loads the sidecar index of a BTF file and validates it against the file.
+        The size of the BTF file and the checksums of the header and of the last block are always checked.
+        @param[in] btf_path The path of the BTF file.
+        @param[in] verify_all_blocks If true, the checksums of all blocks are checked (reads the whole BTF file).
+        @return False if the index does not exist, is invalid or does not match the BTF file (e.g. the file was changed after the
+            index was written).
+    */
+    bool load(const std::string& btf_path, bool verify_all_blocks = false);
+
+    /*!
+        @brief Gets all blocks.
+        @return The blocks in file order.
+    */
+    const std::vector<BtfIndexBlock>& getBlocks() const;
+
+    /*!
+        @brief Gets the entity name table.
+        @return Unordered map from the ID to the name of the entities.
+    */
+    const std::unordered_map<size_t, std::string>& getEntityNames() const;
+
+    /*!
+        @brief Finds the blocks that may contain events in the time range [start_time, end_time) and of the given entities.
+        @param[in] start_time The first timestamp of the range.
+        @param[in] end_time The timestamp after the range.
+        @param[in] entities The names of the entities, if empty the blocks are not filtered by entity.
+        @return The indices of the blocks in file order.
+    */
+    std::vector<size_t> findBlocks(uint64_t start_time, uint64_t end_time, const std::vector<std::string>& entities = {}) const;
+
+    /*!
+        @brief Reads the lines of a block from the BTF file and verifies its checksum.
+        @param[in,out] file The BTF file (opened in binary mode).
+        @param[in] block The index of the block.
+        @param[out] lines The lines of the block, separated by newlines.
+        @return False if the block could not be read or its checksum does not match.
+    */
+    bool readBlock(std::ifstream& file, size_t block, std::string& lines) const;
+
+  private:
+    /// Size of the BTF file in bytes.
+    uint64_t file_size_{0};
+
+    /// Size of the header in bytes.
+    uint64_t header_size_{0};
+
+    /// Checksum of the header.
+    uint64_t header_checksum_{0};
+
+    /// The blocks in file order.
+    std::vector<BtfIndexBlock> blocks_;
+
+    /// The entity name table.
+    std::unordered_map<size_t, std::string> names_;
+
+    /// Reverse entity name table.
+    std::unordered_map<std::string, size_t> ids_;
+};
+} // namespace btf
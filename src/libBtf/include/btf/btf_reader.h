@@ -0,0 +1,265 @@
+#pragma once
+
+/* btf_reader.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "btf.h"
+
+namespace btf
+{
+
+/*!
+    @brief A decoded line of a BTF file. The views refer to the line buffer of the BtfReader and are only valid until the next record
+    is read.
+*/
+struct BtfRecord
+{
+    /// Timestamp of the event (0 for comments).
+    uint64_t time_{0};
+
+    /// Name of the source.
+    std::string_view source_;
+
+    /// Instance of the source.
+    uint64_t source_instance_{0};
+
+    /// Entity type of the target (comment for comment lines, unknown if the type is not supported).
+    EntityTypes type_{EntityTypes::unknown};
+
+    /// Name of the target.
+    std::string_view target_;
+
+    /// Instance of the target.
+    uint64_t target_instance_{0};
+
+    /// The event, the enumerator unknown of the type if the event is not supported.
+    BtfEntry::Events event_;
+
+    /// The event as written in the file.
+    std::string_view event_name_;
+
+    /// The note of the event, or the text of a comment.
+    std::string_view note_;
+};
+
+/*!
+    @brief Reader for BTF files.
+
+    The reader works directly on the text of the BTF file and does not validate the events. Since the events of a BTF file are sorted
+    by time, a timestamp can be found by bisection on the byte offsets without reading the whole file.
+    The records are decoded one line at a time into a single line buffer, hence the memory usage does not depend on the size of the file:
+    @code
+    btf::BtfReader reader("trace.btf");
+    reader.seekToTime(1000);
+    for (const auto& record : reader)
+    {
+        // record.time_, record.target_, record.event_, ...
+    }
+    @endcode
+*/
+class BtfReader
+{
+  public:
+    /*!
+        @brief Input iterator over the records of a BtfReader.
+    */
+    class Iterator
+    {
+      public:
+        /// Iterator category.
+        using iterator_category = std::input_iterator_tag;
+        /// Value type.
+        using value_type = BtfRecord;
+        /// Difference type.
+        using difference_type = std::ptrdiff_t;
+        /// Pointer type.
+        using pointer = const BtfRecord*;
+        /// Reference type.
+        using reference = const BtfRecord&;
+
+        /// @brief Default constructor, the iterator is at the end.
+        Iterator() = default;
+
+        /*!
+            @brief Constructor of the class Iterator, reads the first record.
+            @param[in] reader The reader.
+        */
+        explicit Iterator(BtfReader* reader);
+
+        /*!
+            @brief Gets the current record.
+            @return The record.
+        */
+        reference operator*() const;
+
+        /*!
+            @brief Gets the current record.
+            @return Pointer to the record.
+        */
+        pointer operator->() const;
+
+        /*!
+            @brief Reads the next record.
+            @return The iterator.
+        */
+        Iterator& operator++();
+
+        /*!
+            @brief Reads the next record.
+        */
+        void operator++(int);
+
+        /*!
+            @brief Checks if the iterator is at the end.
+            @param[in] it The iterator.
+            @return True if there are no more records.
+        */
+        friend bool operator==(const Iterator& it, std::default_sentinel_t /*unused*/)
+        {
+            return it.reader_ == nullptr;
+        }
+
+      private:
+        /// The reader, nullptr at the end.
+        BtfReader* reader_{nullptr};
+    };
+
+    /*!
+        @brief Constructor of the class BtfReader. Throws a std::runtime_error if the file cannot be opened.
+        @param[in] path The path of the BTF file.
+        @param[in] delimiter The delimiter of the fields.
+    */
+    explicit BtfReader(const std::string& path, char delimiter = ',');
+
+    /*!
+        @brief Gets the header of the file, i.e. all lines before the first event (including the newlines).
+        @return The header.
+    */
+    const std::string& getHeader() const;
+
+    /*!
+        @brief Gets the size of the file.
+        @return The size in bytes.
+    */
+    uint64_t getFileSize() const;
+
+    /*!
+        @brief Gets the byte offset of the first line after the header.
+        @return The offset.
+    */
+    uint64_t getDataOffset() const;
+
+    /*!
+        @brief Finds the first event with a timestamp equal to or later than the given time by bisection on the byte offsets.
+        Only O(log file size) short reads are necessary. Afterwards, the reader is positioned at the found event.
+        @param[in] time The timestamp.
+        @return The byte offset of the first line of the event, or the file size if all events are earlier.
+    */
+    uint64_t seekToTime(uint64_t time);
+
+    /*!
+        @brief Gets the byte offset of the next line that is read.
+        @return The offset, the file size at the end of the file.
+    */
+    uint64_t getPosition();
+
+    /*!
+        @brief Moves the reader to a byte offset, e.g. one of getPosition().
+        @param[in] offset The offset of the start of a line.
+    */
+    void seek(uint64_t offset);
+
+    /*!
+        @brief Reads the next record from the current position. Lines that cannot be decoded are skipped.
+        @param[out] record The record, the views are valid until the next call.
+        @return False if the end of the file is reached.
+    */
+    bool readRecord(BtfRecord& record);
+
+    /*!
+        @brief Gets an iterator that reads the records from the current position (after the header, or the position of seekToTime()).
+        @return The iterator.
+    */
+    Iterator begin();
+
+    /*!
+        @brief Gets the end of the records.
+        @return The sentinel.
+    */
+    std::default_sentinel_t end() const;
+
+    /*!
+        @brief Gets the number of lines that were skipped by readRecord(), because they could not be decoded.
+        @return The number of lines.
+    */
+    uint64_t getNumberOfSkippedLines() const;
+
+  private:
+    /*!
+        @brief Gets the start of the first line at or after an offset.
+        @param[in] offset The offset.
+        @return The offset of the line, or the file size if there is none.
+    */
+    uint64_t findLineStart(uint64_t offset);
+
+    /*!
+        @brief Finds the first event line at or after a line start and parses its timestamp (comments and empty lines are skipped).
+        @param[in] offset The offset of a line start.
+        @param[out] time The timestamp of the event.
+        @param[out] next_offset The offset of the line after the event.
+        @return The offset of the event line, or the file size if there is none.
+    */
+    uint64_t findEvent(uint64_t offset, uint64_t& time, uint64_t& next_offset);
+
+    /// The BTF file (opened in binary mode, so the offsets match the file).
+    std::ifstream file_;
+
+    /// The size of the file.
+    uint64_t file_size_{0};
+
+    /// The offset of the first line after the header.
+    uint64_t data_offset_{0};
+
+    /// The header.
+    std::string header_;
+
+    /// The delimiter of the fields.
+    char delimiter_;
+
+    /// The current line, the views of the current record refer to it.
+    std::string line_;
+
+    /// Buffer for the conversion of the event names.
+    std::string event_name_;
+
+    /// The current record of the iterator.
+    BtfRecord record_;
+
+    /// Number of lines that could not be decoded.
+    uint64_t skipped_lines_{0};
+};
+
+/*!
+    @brief Copies the header and all lines of the events with a timestamp in [start_time, end_time] of a BTF file into a new BTF file.
+    Only the header and the window are read, the start and the end of the window are found with BtfReader::seekToTime().
+    Throws a std::runtime_error if a file cannot be opened.
+    @param[in] btf_path The path of the BTF file.
+    @param[in] output_path The path of the new BTF file.
+    @param[in] start_time The first timestamp of the window.
+    @param[in] end_time The last timestamp of the window.
+    @return The number of bytes that were copied after the header.
+*/
+uint64_t extractWindow(const std::string& btf_path, const std::string& output_path, uint64_t start_time, uint64_t end_time);
+} // namespace btf
@@ -0,0 +1,106 @@
+#pragma once
+
+/* checkpoint.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace btf
+{
+
+/*!
+    @brief Gets the path of the state trailer of a BTF file ("trace.btf" -> "trace.btf.btfstate"), see
+    BtfFile::setWriteStateTrailer().
+    @param[in] path The path of the BTF file.
+    @return The path of the state trailer.
+*/
+std::string getStateTrailerPath(const std::string& path);
+
+/*!
+    @brief Builds the binary snapshot of BtfFile::checkpoint().
+
+    Numbers are stored as variable-length integers (7 bits per byte), so the small values that dominate the snapshot (instance
+    ids, time deltas, indices) take one or two bytes. The file starts with a magic number and ends with a checksum.
+*/
+class CheckpointWriter
+{
+  public:
+    /*!
+        @brief Appends an unsigned number.
+        @param[in] value The number.
+    */
+    void writeU64(uint64_t value);
+
+    /*!
+        @brief Appends a string with its length.
+        @param[in] value The string.
+    */
+    void writeString(std::string_view value);
+
+    /*!
+        @brief Writes the snapshot to a file. It is written to path + ".tmp" first, which then replaces the file, so the previous
+            snapshot is kept if the save fails.
+        @param[in] path The path of the file.
+        @return True if the file was written.
+    */
+    bool save(const std::string& path) const;
+
+  private:
+    /// The snapshot without magic number and checksum.
+    std::string buffer_;
+};
+
+/*!
+    @brief Reads the binary snapshot of BtfFile::restore(), see CheckpointWriter.
+*/
+class CheckpointReader
+{
+  public:
+    /*!
+        @brief Loads a snapshot and validates its magic number and checksum.
+        @param[in] path The path of the file.
+        @return False if the file cannot be read or is not a valid snapshot.
+    */
+    bool load(const std::string& path);
+
+    /*!
+        @brief Reads an unsigned number. Throws a std::runtime_error if the snapshot ends.
+        @return The number.
+    */
+    uint64_t readU64();
+
+    /*!
+        @brief Reads the number of elements of a sequence. Throws a std::runtime_error if the number exceeds the remaining bytes,
+            since every element takes at least one byte, so a corrupted count cannot allocate huge containers.
+        @return The number of elements.
+    */
+    uint64_t readCount();
+
+    /*!
+        @brief Reads a string. Throws a std::runtime_error if the snapshot ends.
+        @return The string.
+    */
+    std::string readString();
+
+    /*!
+        @brief Checks if the whole snapshot was read.
+        @return True if there are no more bytes.
+    */
+    bool isAtEnd() const;
+
+  private:
+    /// The snapshot without magic number and checksum.
+    std::string buffer_;
+
+    /// The offset of the next value.
+    size_t offset_{0};
+};
+} // namespace btf
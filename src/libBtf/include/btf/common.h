@@ -66,7 +66,10 @@ enum class ErrorCodes
     source_and_target_not_equal,
 
     // The given amount of semaphore accesses is invalid (see specification for more details).
-    amount_of_semaphore_accesses_invalid        
+    amount_of_semaphore_accesses_invalid,
+
+    /// The name of the entity has the same hash as another entity name.
+    hash_collision
 };
 
 /*!
@@ -0,0 +1,301 @@
+#pragma once
+
+/* compression.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "input_source.h"
+
+namespace btf
+{
+
+/*!
+    @brief Compression formats of BTF files.
+*/
+enum class Compressions
+{
+    /// Plain text.
+    none,
+    /// gzip (requires zlib at build time).
+    gzip,
+    /// Zstandard (requires libzstd at build time).
+    zstd
+};
+
+/*!
+    @brief Checks if a compression format is supported by the build.
+    @param[in] compression The compression format.
+    @return True if the format can be read.
+*/
+bool isCompressionSupported(Compressions compression);
+
+/*!
+    @brief Detects the compression format from the magic bytes at the beginning of a file.
+    @param[in] first_bytes The first bytes of the file (at least 4 bytes, unless the file is shorter).
+    @return The compression format, none if no magic bytes are found.
+*/
+Compressions detectCompression(std::string_view first_bytes);
+
+/*!
+    @brief Decompresses another input source. The compression format is detected from the magic bytes, input without magic bytes
+    is passed through unchanged. Concatenated gzip members and zstd frames are decoded one after another.
+
+    Wrapped in a PrefetchReader, the decompression runs in the background thread of the reader and overlaps with the parsing.
+*/
+class DecompressingInputSource : public InputSource
+{
+  public:
+    /// Decoder of a compression format.
+    struct Decoder;
+
+    /*!
+        @brief Constructor of the class DecompressingInputSource, reads the magic bytes. Throws a std::runtime_error if the
+        input is compressed in a format that is not supported by the build.
+        @param[in] source The compressed source.
+    */
+    explicit DecompressingInputSource(std::unique_ptr<InputSource> source);
+
+    /// @brief Destructor of the class DecompressingInputSource.
+    ~DecompressingInputSource() override;
+
+    DecompressingInputSource(const DecompressingInputSource&) = delete;
+    DecompressingInputSource& operator=(const DecompressingInputSource&) = delete;
+
+    /// @copydoc InputSource::read()
+    size_t read(char* buffer, size_t size) override;
+
+    /// @copydoc InputSource::getName()
+    std::string getName() const override;
+
+    /*!
+        @brief Gets the detected compression format.
+        @return The compression format.
+    */
+    Compressions getCompression() const;
+
+  private:
+    /*!
+        @brief Reads the next compressed bytes, if all previous bytes were consumed.
+        @return False if the end of the source is reached.
+    */
+    bool fillInput();
+
+    /// The compressed source.
+    std::unique_ptr<InputSource> source_;
+
+    /// The detected compression format.
+    Compressions compression_{Compressions::none};
+
+    /// Buffer for the compressed bytes.
+    std::vector<char> input_;
+
+    /// First byte of the buffer that was not consumed.
+    size_t input_begin_{0};
+
+    /// End of the bytes in the buffer.
+    size_t input_end_{0};
+
+    /// True if the current gzip member or zstd frame is complete.
+    bool is_frame_complete_{true};
+
+    /// The decoder, nullptr for plain text.
+    std::unique_ptr<Decoder> decoder_;
+};
+
+/*!
+    @brief An independently compressed block of a BTF file (a gzip member or a zstd frame).
+*/
+struct CompressedBlock
+{
+    /// Offset of the block in the uncompressed file.
+    uint64_t uncompressed_offset_{0};
+
+    /// Size of the uncompressed block.
+    uint64_t uncompressed_size_{0};
+
+    /// Offset of the block in the compressed file.
+    uint64_t compressed_offset_{0};
+
+    /// Size of the compressed block.
+    uint64_t compressed_size_{0};
+
+    /// Timestamp of the first event in the block (the last timestamp of the previous block if the block has no events).
+    uint64_t first_time_{0};
+
+    /// Timestamp of the last event in the block (the last timestamp of the previous block if the block has no events).
+    uint64_t last_time_{0};
+};
+
+/*!
+    @brief Compresses data into one gzip member or zstd frame. Throws a std::runtime_error if the compression is not supported.
+    @param[in] compression The compression format (not none).
+    @param[in] data The data.
+    @return The compressed data.
+*/
+std::string compressBlock(Compressions compression, std::string_view data);
+
+/*!
+    @brief Gets the path of the block table of a compressed BTF file ("trace.btf.gz" -> "trace.btf.gz.btfblk").
+    @param[in] path The path of the compressed BTF file.
+    @return The path of the block table.
+*/
+std::string getBlockTablePath(const std::string& path);
+
+/*!
+    @brief Writes the lines of a BTF file in independently compressed blocks, which are compressed in parallel.
+
+    Blocks are cut at line boundaries as soon as they reach the block size. The output is a sequence of gzip members or zstd
+    frames, hence it is decodable by standard tools (zcat, zstdcat) and by DecompressingInputSource.
+*/
+class CompressedBlockWriter
+{
+  public:
+    /*!
+        @brief Constructor of the class CompressedBlockWriter.
+        @param[in] out The stream of the compressed file (must be opened in binary mode).
+        @param[in] compression The compression format (not none, must be supported).
+        @param[in] block_size The uncompressed size at which a block is cut.
+        @param[in] number_of_threads The number of blocks that are compressed in parallel (0 for the number of hardware threads).
+    */
+    CompressedBlockWriter(std::ostream& out, Compressions compression, size_t block_size = size_t{4} << 20U, size_t number_of_threads = 0);
+
+    /*!
+        @brief Writes data without timestamp, e.g. the header.
+        @param[in] data The data.
+    */
+    void write(std::string_view data);
+
+    /*!
+        @brief Writes a line and a newline.
+        @param[in] line The line without newline.
+        @param[in] time The timestamp of the event.
+        @param[in] is_comment True if the line is a comment (the timestamp is not recorded).
+    */
+    void writeLine(std::string_view line, uint64_t time, bool is_comment);
+
+    /*!
+        @brief Compresses and writes the remaining data. Rethrows the exception of a failed compression.
+        @return The block table.
+    */
+    const std::vector<CompressedBlock>& finish();
+
+  private:
+    /*!
+        @brief Starts the compression of the current block.
+    */
+    void flushBlock();
+
+    /*!
+        @brief Waits for the compression of the oldest block and writes it.
+    */
+    void writePendingBlock();
+
+    /// The stream of the compressed file.
+    std::ostream& out_;
+
+    /// The compression format.
+    Compressions compression_;
+
+    /// The uncompressed size at which a block is cut.
+    size_t block_size_;
+
+    /// The maximum number of blocks that are compressed at the same time.
+    size_t number_of_threads_;
+
+    /// The uncompressed data of the current block.
+    std::string buffer_;
+
+    /// The current block.
+    CompressedBlock block_;
+
+    /// True if the current block contains an event.
+    bool block_has_events_{false};
+
+    /// Offset of the next block in the uncompressed file.
+    uint64_t uncompressed_offset_{0};
+
+    /// Offset of the next block in the compressed file.
+    uint64_t compressed_offset_{0};
+
+    /// Blocks whose compression was started, in file order.
+    std::deque<std::pair<CompressedBlock, std::future<std::string>>> pending_blocks_;
+
+    /// The written blocks.
+    std::vector<CompressedBlock> blocks_;
+};
+
+/*!
+    @brief Writes the block table of a compressed BTF file.
+    @param[in] path The path of the compressed BTF file.
+    @param[in] compression The compression format.
+    @param[in] blocks The blocks.
+    @return True if the block table was written.
+*/
+bool writeBlockTable(const std::string& path, Compressions compression, const std::vector<CompressedBlock>& blocks);
+
+/*!
+    @brief Random access to a compressed BTF file with a block table: only the blocks that are needed are decompressed.
+*/
+class CompressedBtfFile
+{
+  public:
+    /*!
+        @brief Loads the block table of a compressed BTF file and validates it against the size of the file.
+        @param[in] path The path of the compressed BTF file.
+        @return False if there is no valid block table for the file.
+    */
+    bool load(const std::string& path);
+
+    /*!
+        @brief Gets the compression format.
+        @return The compression format.
+    */
+    Compressions getCompression() const;
+
+    /*!
+        @brief Gets the blocks.
+        @return The blocks in file order.
+    */
+    const std::vector<CompressedBlock>& getBlocks() const;
+
+    /*!
+        @brief Finds the first block that contains events at or after a timestamp.
+        @param[in] time The timestamp.
+        @return The index of the block, the number of blocks if all events are earlier.
+    */
+    size_t findBlock(uint64_t time) const;
+
+    /*!
+        @brief Reads and decompresses a block.
+        @param[in] block The index of the block.
+        @param[out] lines The uncompressed lines of the block.
+        @return False if the block could not be read or decompressed.
+    */
+    bool readBlock(size_t block, std::string& lines) const;
+
+  private:
+    /// The path of the compressed BTF file.
+    std::string path_;
+
+    /// The compression format.
+    Compressions compression_{Compressions::none};
+
+    /// The blocks.
+    std::vector<CompressedBlock> blocks_;
+};
+} // namespace btf
@@ -0,0 +1,113 @@
+#pragma once
+
+/* conversion_cache.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstdint>
+#include <filesystem>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "import_diagnostics.h"
+
+namespace btf
+{
+
+/*!
+    @brief Gets the version of the library, which is part of the keys of the ConversionCache.
+    @return The version (git describe of the source tree at build time, "unknown" if it is not available).
+*/
+std::string getLibraryVersion();
+
+/*!
+    @brief Content-addressed cache of conversion outputs.
+
+    A conversion is identified by a key that is computed from the bytes of the input file, the conversion options and the library
+    version. An entry of the cache is a directory with copies of the output files and the import summary. If the cache
+    grows beyond its maximum size, the least recently used entries are removed. \n
+    The cache can be used by several threads at the same time. Entries are added by renaming a complete directory, so several
+    processes can share a cache directory as well.
+*/
+class ConversionCache
+{
+  public:
+    /*!
+        @brief Constructor of the class ConversionCache. The cache directory is created if it does not exist.
+        @param[in] directory The cache directory.
+        @param[in] max_size The maximum size of all entries in bytes (0 for no limit).
+    */
+    explicit ConversionCache(std::string directory, uint64_t max_size = 0);
+
+    /*!
+        @brief Computes the key of a conversion. Throws a std::runtime_error if the input file cannot be opened.
+        @param[in] input_path The path of the input file.
+        @param[in] options All options that change the output of the conversion, e.g. the options of the BtfFile.
+        @return The key.
+    */
+    static uint64_t computeKey(const std::string& input_path, std::string_view options);
+
+    /*!
+        @brief Sets the option that fetch() creates hard links to the cached files instead of copying them (it falls back to copying
+            if a link cannot be created). The cached files are made read-only, so a linked output is read-only as well and cannot be
+            modified in place, e.g. by BtfFile::openForAppend().
+        @param[in] value True to link the output files.
+    */
+    void setLinkOutputs(bool value);
+
+    /*!
+        @brief Restores the output files of a conversion from the cache.
+        @param[in] key The key of the conversion.
+        @param[in] output_paths The paths of the output files, in the order they were stored.
+        @param[out] summary The summary of the import, only set on a hit.
+        @return True if the conversion was cached and all output files were restored.
+    */
+    bool fetch(uint64_t key, const std::vector<std::string>& output_paths, ImportSummary& summary);
+
+    /*!
+        @brief Adds the output files of a conversion to the cache and removes the least recently used entries if the cache is too big.
+        @param[in] key The key of the conversion.
+        @param[in] output_paths The paths of the output files.
+        @param[in] summary The summary of the import.
+        @return True if the conversion is cached.
+    */
+    bool store(uint64_t key, const std::vector<std::string>& output_paths, const ImportSummary& summary);
+
+    /*!
+        @brief Gets the size of all entries.
+        @return The size in bytes.
+    */
+    uint64_t getSize() const;
+
+  private:
+    /*!
+        @brief Gets the directory of an entry.
+        @param[in] key The key of the conversion.
+        @return The directory of the entry.
+    */
+    std::filesystem::path getEntryPath(uint64_t key) const;
+
+    /*!
+        @brief Removes the least recently used entries until the cache is not bigger than its maximum size. The lock must be held exclusively.
+    */
+    void evict();
+
+    /// The cache directory.
+    std::filesystem::path directory_;
+
+    /// The maximum size of all entries in bytes (0 for no limit).
+    uint64_t max_size_;
+
+    /// Boolean value that is true when fetch() links the output files.
+    bool is_linking_outputs_{false};
+
+    /// Lock that keeps evict() from removing entries while they are restored.
+    mutable std::shared_mutex mutex_;
+};
+} // namespace btf
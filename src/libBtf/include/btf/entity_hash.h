@@ -0,0 +1,31 @@
+#pragma once
+
+/* entity_hash.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstdint>
+#include <string_view>
+
+namespace btf
+{
+
+/*!
+    @brief Function type for the hashing of entity names into entity IDs.
+*/
+using EntityHasher = uint64_t (*)(std::string_view name);
+
+/*!
+    @brief Hashes an entity name into a 64-bit entity ID.
+
+    The hash follows the wyhash algorithm (final version 4, default secret and seed 0). Unlike std::hash, the result does not depend on
+    the compiler, the standard library, the platform or the run, hence IDs can be persisted and precomputed (e.g. in Python).
+    @param[in] name The entity name.
+    @return The entity ID.
+*/
+uint64_t hashEntityName(std::string_view name);
+} // namespace btf
@@ -0,0 +1,179 @@
+#pragma once
+
+/* import_diagnostics.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "btf_entity_types.h"
+#include "common.h"
+
+namespace btf
+{
+
+/*!
+    @brief Kinds of problems that can occur while importing a line of a BTF file.
+*/
+enum class ImportIssues
+{
+    /// The line does not contain all required fields.
+    invalid_format,
+
+    /// The timestamp, an instance id or a note value could not be parsed as number.
+    invalid_number,
+
+    /// The entity type of the line is unknown.
+    unknown_entity_type,
+
+    /// The event of the line is unknown for its entity type.
+    unknown_event,
+
+    /// A migration event is not part of a valid enforcedmigration/fullmigration pair.
+    invalid_migration,
+
+    /// The event was parsed but rejected by the BtfFile (see the error code of the category).
+    rejected_event
+};
+
+/*!
+    @brief Converts the enum ImportIssues into string.
+    @param[in] issue ImportIssues enum that will be converted.
+    @return String if ImportIssues is valid, else a fatal error is triggered.
+*/
+std::string importIssueToString(ImportIssues issue);
+
+/*!
+    @brief One category of import problems, e.g. all task events that were rejected with invalid_state_transition.
+*/
+struct ImportDiagnosticsCategory
+{
+    /// The kind of problem.
+    ImportIssues issue_{ImportIssues::invalid_format};
+
+    /// The entity type of the affected lines (unknown if the type could not be parsed).
+    EntityTypes type_{EntityTypes::unknown};
+
+    /// The error code returned by the BtfFile (only set for rejected events, otherwise success).
+    ErrorCodes error_{ErrorCodes::success};
+
+    /// The event field of the affected lines (empty if it could not be located).
+    std::string event_;
+
+    /// Number of affected lines.
+    uint64_t count_{0};
+
+    /// The first lines of this category (at most the configured number of samples).
+    std::vector<std::string> sample_lines_;
+};
+
+/*!
+    @brief Summary of an import.
+*/
+struct ImportSummary
+{
+    /// Number of event lines (without header, comments and empty lines) that were read.
+    uint64_t lines_{0};
+
+    /// Number of lines that could not be imported.
+    uint64_t rejected_lines_{0};
+
+    /// Number of lines that were skipped by the ImportFilter.
+    uint64_t filtered_lines_{0};
+
+    /// All categories of problems that occurred, in the order of their first occurrence.
+    std::vector<ImportDiagnosticsCategory> categories_;
+
+    /*!
+        @brief Converts the summary into a human readable multi-line string.
+        @return The summary as string.
+    */
+    std::string toString() const;
+};
+
+/*!
+    @brief Summary of a parallel import, see BtfFile::importFromFileParallel().
+*/
+struct ParallelImportSummary
+{
+    /// The summary of the import, identical to the summary of a serial import.
+    ImportSummary import_;
+
+    /// Number of time partitions the file was split into (1 if the file was imported serially).
+    size_t partitions_{1};
+
+    /// Number of partitions that were imported again serially, e.g. because a problem in the partition did not reject its line.
+    size_t reimported_partitions_{0};
+
+    /// Number of lines that were replayed on the state of the previous partitions during the reconciliation.
+    uint64_t replayed_lines_{0};
+
+    /// True if the reconciliation found a partition it could not stitch exactly and the whole file was imported serially.
+    bool is_restarted_{false};
+};
+
+/*!
+    @brief Collects the problems of an import.
+
+    Instead of logging every faulty line, the problems are counted per category (kind of problem, entity type, error code and event).
+    Only the first lines of each category are kept as samples, so the cost of a faulty line does not depend on how many faulty lines
+    there are.
+*/
+class ImportDiagnostics
+{
+  public:
+    /*!
+        @brief Constructor of the class ImportDiagnostics.
+        @param[in] max_samples_per_category The number of sample lines that are kept per category.
+    */
+    explicit ImportDiagnostics(size_t max_samples_per_category = 5);
+
+    /*!
+        @brief Counts a line that was read.
+    */
+    void countLine();
+
+    /*!
+        @brief Counts a line that was skipped by the ImportFilter.
+    */
+    void countFilteredLine();
+
+    /*!
+        @brief Records a problem.
+        @param[in] issue The kind of problem.
+        @param[in] type The entity type of the line.
+        @param[in] error The error code (only relevant for rejected events).
+        @param[in] event The event field of the line.
+        @param[in] line The line.
+        @param[in] is_rejected True if the line was not imported because of the problem.
+    */
+    void record(ImportIssues issue, EntityTypes type, ErrorCodes error, std::string_view event, std::string_view line, bool is_rejected = true);
+
+    /*!
+        @brief Gets the summary of all recorded problems.
+        @return The summary.
+    */
+    const ImportSummary& getSummary() const;
+
+  private:
+    /// Maximum number of distinct event strings per bucket, further events are collected in one category.
+    static constexpr size_t max_events_per_bucket_{32};
+
+    /// The number of sample lines that are kept per category.
+    size_t max_samples_per_category_;
+
+    /// The summary with all categories.
+    ImportSummary summary_;
+
+    /// Unordered map from (issue, type, error) to the indices of the categories in the summary.
+    std::unordered_map<uint32_t, std::vector<size_t>> buckets_;
+};
+} // namespace btf
@@ -0,0 +1,157 @@
+#pragma once
+
+/* import_filter.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "btf_entity_types.h"
+
+namespace btf
+{
+
+/*!
+    @brief Filter for the selective import of a BTF file.
+
+    The filter consists of an entity type mask, an allowlist of entity names and a time window [start_time, end_time].
+    BtfFile::importFromFile() checks a line right after the type field was located, before any further parsing or hashing,
+    hence rejected lines cost little more than finding the delimiters. Since the events are sorted by time, the import stops
+    at the first event after the time window.
+
+    The state machines of some entity types depend on other entities, e.g. a runnable can only be started within a running task.
+    If dependencies are included (default), such entities are imported regardless of the filter (forced inclusion):
+    - Runnable, signal, OS, stimulus, scheduler and semaphore events force the task, ISR and core events.
+    - Task and ISR events force the core events.
+    - Forced entity types are not filtered by name and are also imported before the time window, so their state is known at
+      the start of the window.
+
+    Events of the selected entity types before the time window are dropped, e.g. a runnable that is running at the start of
+    the window is imported without its start event. The state machine of the BtfFile may reject such events, they are
+    reported in the ImportSummary.
+*/
+class ImportFilter
+{
+  public:
+    /*!
+        @brief Sets the entity types that are imported. By default, all entity types are imported.
+        @param[in] types The entity types.
+    */
+    void setEntityTypes(const std::vector<EntityTypes>& types);
+
+    /*!
+        @brief Adds an entity to the allowlist. An event is imported if its source or its target is in the allowlist.
+        If the allowlist is empty (default), the events are not filtered by name.
+        @param[in] name The name of the entity.
+    */
+    void addEntity(const std::string& name);
+
+    /*!
+        @brief Sets the time window of the import.
+        @param[in] start_time The first timestamp of the window.
+        @param[in] end_time The last timestamp of the window.
+    */
+    void setTimeWindow(uint64_t start_time, uint64_t end_time);
+
+    /*!
+        @brief Enables or disables the forced inclusion of the entities the selected entity types depend on.
+        @param[in] include_dependencies True to include the dependencies (default).
+    */
+    void setIncludeDependencies(bool include_dependencies);
+
+    /*!
+        @brief Checks if the filter rejects any line.
+        @return False if all lines are imported.
+    */
+    bool isActive() const;
+
+    /*!
+        @brief Checks if events of an entity type are imported, either because it is selected or because it is forced.
+        @param[in] type The entity type.
+        @return True if the events are imported.
+    */
+    bool acceptsType(EntityTypes type) const;
+
+    /*!
+        @brief Checks if an entity type is forced as dependency of the selected entity types.
+        @param[in] type The entity type.
+        @return True if the entity type is forced.
+    */
+    bool isDependency(EntityTypes type) const;
+
+    /*!
+        @brief Checks if an event is in the time window (events of forced entity types are accepted before the window).
+        @param[in] type The entity type of the event.
+        @param[in] time The timestamp of the event.
+        @return True if the event is imported.
+    */
+    bool acceptsTime(EntityTypes type, uint64_t time) const;
+
+    /*!
+        @brief Checks the source and the target of an event against the allowlist (events of forced entity types are accepted).
+        @param[in] type The entity type of the event.
+        @param[in] source The name of the source.
+        @param[in] target The name of the target.
+        @return True if the event is imported.
+    */
+    bool acceptsEntities(EntityTypes type, std::string_view source, std::string_view target) const;
+
+    /*!
+        @brief Gets the last timestamp of the time window.
+        @return The timestamp.
+    */
+    uint64_t getEndTime() const;
+
+  private:
+    /*!
+        @brief Hash that allows to look up std::string_view in the allowlist without creating a std::string.
+    */
+    struct NameHash
+    {
+        /// Enables heterogeneous lookup.
+        using is_transparent = void;
+
+        /*!
+            @brief Hashes a name.
+            @param[in] name The name.
+            @return The hash.
+        */
+        size_t operator()(std::string_view name) const
+        {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    /*!
+        @brief Gets the bit of an entity type in the mask.
+        @param[in] type The entity type.
+        @return The bit.
+    */
+    static uint32_t toBit(EntityTypes type);
+
+    /// Bit mask of the selected entity types.
+    uint32_t selected_types_{std::numeric_limits<uint32_t>::max()};
+
+    /// Allowlist of entity names.
+    std::unordered_set<std::string, NameHash, std::equal_to<>> entities_;
+
+    /// The first timestamp of the window.
+    uint64_t start_time_{0};
+
+    /// The last timestamp of the window.
+    uint64_t end_time_{std::numeric_limits<uint64_t>::max()};
+
+    /// True if the dependencies of the selected entity types are included.
+    bool include_dependencies_{true};
+};
+} // namespace btf
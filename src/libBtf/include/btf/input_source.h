@@ -0,0 +1,239 @@
+#pragma once
+
+/* input_source.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace btf
+{
+
+/*!
+    @brief Source of the bytes of a BTF file, e.g. a file, a pipe or a memory buffer.
+*/
+class InputSource
+{
+  public:
+    /// @brief Destructor of the class InputSource.
+    virtual ~InputSource() = default;
+
+    /*!
+        @brief Reads the next bytes. Throws a std::runtime_error if the source cannot be read.
+        @param[out] buffer The buffer.
+        @param[in] size The size of the buffer.
+        @return The number of bytes that were read, 0 at the end of the source.
+    */
+    virtual size_t read(char* buffer, size_t size) = 0;
+
+    /*!
+        @brief Gets a name of the source for messages.
+        @return The name.
+    */
+    virtual std::string getName() const = 0;
+};
+
+/*!
+    @brief Reads a regular file. The operating system is advised that the file is read sequentially.
+*/
+class FileInputSource : public InputSource
+{
+  public:
+    /*!
+        @brief Constructor of the class FileInputSource. Throws a std::runtime_error if the file cannot be opened.
+        @param[in] path The path of the file.
+    */
+    explicit FileInputSource(std::string path);
+
+    /// @brief Destructor of the class FileInputSource, closes the file.
+    ~FileInputSource() override;
+
+    FileInputSource(const FileInputSource&) = delete;
+    FileInputSource& operator=(const FileInputSource&) = delete;
+
+    /// @copydoc InputSource::read()
+    size_t read(char* buffer, size_t size) override;
+
+    /// @copydoc InputSource::getName()
+    std::string getName() const override;
+
+  private:
+    /// The path of the file.
+    std::string path_;
+
+    /// The file.
+    std::FILE* file_{nullptr};
+};
+
+/*!
+    @brief Reads from a file descriptor, e.g. a pipe or the standard input. The file descriptor is not closed.
+*/
+class FileDescriptorInputSource : public InputSource
+{
+  public:
+    /*!
+        @brief Constructor of the class FileDescriptorInputSource.
+        @param[in] fd The file descriptor (0 for the standard input).
+    */
+    explicit FileDescriptorInputSource(int fd);
+
+    /// @copydoc InputSource::read()
+    size_t read(char* buffer, size_t size) override;
+
+    /// @copydoc InputSource::getName()
+    std::string getName() const override;
+
+  private:
+    /// The file descriptor.
+    int fd_;
+};
+
+/*!
+    @brief Reads from a memory buffer. The buffer is not copied and must outlive the source.
+*/
+class MemoryInputSource : public InputSource
+{
+  public:
+    /*!
+        @brief Constructor of the class MemoryInputSource.
+        @param[in] data The buffer.
+    */
+    explicit MemoryInputSource(std::string_view data);
+
+    /// @copydoc InputSource::read()
+    size_t read(char* buffer, size_t size) override;
+
+    /// @copydoc InputSource::getName()
+    std::string getName() const override;
+
+  private:
+    /// The bytes that were not read yet.
+    std::string_view data_;
+};
+
+/*!
+    @brief Opens an input source for a path, "-" opens the standard input. gzip or zstd compressed input is decompressed,
+    see DecompressingInputSource. Throws a std::runtime_error if the file cannot be opened.
+    @param[in] path The path.
+    @return The input source.
+*/
+std::unique_ptr<InputSource> openInputSource(const std::string& path);
+
+/*!
+    @brief Reads an input source in a background thread into a ring of large blocks, so reading overlaps with parsing.
+
+    The consumer gets the blocks with next(). The unprocessed end of the previous block (usually an incomplete line) can be kept,
+    it is placed directly in front of the data of the next block, so a line is never split and the data is not copied again:
+    @code
+    btf::PrefetchReader reader(source);
+    std::string_view block;
+    size_t keep{0};
+    while (reader.next(block, keep))
+    {
+        // process the complete lines of block, keep the incomplete last line
+    }
+    // block contains the kept bytes without a newline at the end
+    @endcode
+*/
+class PrefetchReader
+{
+  public:
+    /*!
+        @brief Constructor of the class PrefetchReader, starts the background thread.
+        @param[in] source The input source, must outlive the reader.
+        @param[in] block_size The size of the blocks.
+        @param[in] number_of_blocks The number of blocks of the ring (at least 2).
+    */
+    explicit PrefetchReader(InputSource& source, size_t block_size = size_t{1} << 20U, size_t number_of_blocks = 4);
+
+    /// @brief Destructor of the class PrefetchReader, stops the background thread.
+    ~PrefetchReader();
+
+    PrefetchReader(const PrefetchReader&) = delete;
+    PrefetchReader& operator=(const PrefetchReader&) = delete;
+
+    /*!
+        @brief Gets the next block and releases the previous one. Rethrows the exception of the source if it could not be read.
+        @param[out] block The kept bytes of the previous block followed by the next bytes of the source, valid until the next call.
+        @param[in] keep The number of bytes at the end of the previous block that are placed in front of the next block.
+        @return False if the end of the source is reached, block then only contains the kept bytes.
+    */
+    bool next(std::string_view& block, size_t keep = 0);
+
+  private:
+    /*!
+        @brief A block of the ring.
+    */
+    struct Block
+    {
+        /// The buffer, the data starts after the space for the kept bytes.
+        std::vector<char> buffer_;
+
+        /// The number of bytes of the data.
+        size_t size_{0};
+    };
+
+    /*!
+        @brief Fills the blocks in the background thread.
+    */
+    void fill();
+
+    /// Space in front of the data of a block for the kept bytes, larger kept ranges are copied.
+    static constexpr size_t keep_capacity_{size_t{1} << 16U};
+
+    /// The input source.
+    InputSource& source_;
+
+    /// The size of the blocks.
+    size_t block_size_;
+
+    /// The ring of blocks.
+    std::vector<Block> blocks_;
+
+    /// Index of the next block that is filled by the background thread.
+    size_t fill_index_{0};
+
+    /// Index of the next block of the consumer.
+    size_t consume_index_{0};
+
+    /// Number of filled blocks that were not consumed.
+    size_t number_of_filled_blocks_{0};
+
+    /// True if the block of the consumer must be released with the next call of next().
+    bool is_holding_block_{false};
+
+    /// True if the source is completely read (or could not be read).
+    bool is_source_finished_{false};
+
+    /// True if the background thread must stop.
+    bool is_stopping_{false};
+
+    /// The exception of the source.
+    std::exception_ptr error_;
+
+    /// The current block if the kept bytes did not fit in front of the block.
+    std::string overflow_;
+
+    /// Protects the state of the ring.
+    std::mutex mutex_;
+
+    /// Signals filled and released blocks.
+    std::condition_variable condition_;
+
+    /// The background thread.
+    std::thread thread_;
+};
+} // namespace btf
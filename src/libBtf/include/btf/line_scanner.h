@@ -0,0 +1,76 @@
+#pragma once
+
+/* line_scanner.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace btf
+{
+
+/*!
+    @brief Implementations of the line scanner.
+*/
+enum class LineScanners
+{
+    /// Portable implementation, one byte at a time.
+    scalar,
+    /// SSE2, 16 bytes at a time (x86-64 only).
+    sse2,
+    /// AVX2, 32 bytes at a time (x86-64 only, selected at runtime if the CPU supports it).
+    avx2
+};
+
+/*!
+    @brief Positions of the delimiters of a line, as found by scanLines().
+*/
+struct LineFields
+{
+    /// Maximum number of delimiters that are recorded per line (time, source, source instance, type, target, target instance, event and note).
+    static constexpr size_t max_delimiters_{8};
+
+    /// Offset of the first character of the line in the block.
+    size_t offset_{0};
+
+    /// Length of the line without the newline.
+    size_t size_{0};
+
+    /// Number of recorded delimiters (at most max_delimiters_, further delimiters belong to the last field).
+    uint32_t number_of_delimiters_{0};
+
+    /// Positions of the delimiters relative to the start of the line.
+    std::array<uint32_t, max_delimiters_> delimiters_{};
+};
+
+/*!
+    @brief Gets the fastest line scanner supported by the CPU.
+    @return The line scanner.
+*/
+LineScanners getBestLineScanner();
+
+/*!
+    @brief Checks if a line scanner is supported by the build and the CPU.
+    @param[in] scanner The line scanner.
+    @return True if the line scanner can be used.
+*/
+bool isLineScannerSupported(LineScanners scanner);
+
+/*!
+    @brief Finds the newlines and the delimiters of all complete lines of a block in one pass.
+    @param[in] block The block.
+    @param[in] delimiter The delimiter of the fields.
+    @param[out] lines The lines, the previous content is replaced.
+    @param[in] scanner The implementation, the fastest one if not given. Must be supported (see isLineScannerSupported()).
+    @return The number of bytes up to and including the last newline, the rest of the block is an incomplete line.
+*/
+size_t scanLines(std::string_view block, char delimiter, std::vector<LineFields>& lines, LineScanners scanner = getBestLineScanner());
+} // namespace btf
@@ -0,0 +1,95 @@
+#pragma once
+
+/* output_rotation.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace btf
+{
+
+/*!
+    @brief Limits of the parts of a rotated output, see BtfFile::setOutputRotation().
+
+    The limits are soft: a part is only cut before an event with a new timestamp, so the events of one timestamp and
+    enforced_migration/full_migration pairs are never split. A value of 0 disables a limit.
+*/
+struct OutputRotation
+{
+    /// Maximum number of lines (events and comments) per part.
+    uint64_t max_events_{0};
+
+    /// Maximum uncompressed size of a part in bytes (including the header).
+    uint64_t max_bytes_{0};
+
+    /// Time window of a part, starting at the first event of the part.
+    uint64_t time_window_{0};
+
+    /*!
+        @brief Checks if any limit is set.
+        @return True if the output is rotated.
+    */
+    bool isActive() const;
+};
+
+/*!
+    @brief A part of a rotated output.
+*/
+struct RotationPart
+{
+    /// The path of the part.
+    std::string path_;
+
+    /// Number of lines (events and comments) of the part.
+    uint64_t number_of_events_{0};
+
+    /// Uncompressed size of the part in bytes (including the header).
+    uint64_t size_{0};
+
+    /// Timestamp of the first event of the part.
+    uint64_t first_time_{0};
+
+    /// Timestamp of the last event of the part.
+    uint64_t last_time_{0};
+};
+
+/*!
+    @brief Gets the path of a part of a rotated output ("trace.btf" -> "trace.000.btf", "trace.btf.gz" -> "trace.000.btf.gz").
+    @param[in] path The path of the output.
+    @param[in] part The number of the part.
+    @return The path of the part.
+*/
+std::string getRotationPartPath(const std::string& path, size_t part);
+
+/*!
+    @brief Gets the path of the manifest of a rotated output ("trace.btf" -> "trace.manifest.json").
+    @param[in] path The path of the output.
+    @return The path of the manifest.
+*/
+std::string getRotationManifestPath(const std::string& path);
+
+/*!
+    @brief Gets the path of the file of a core of a split output ("trace.btf", "Core1" -> "trace.Core1.btf"). Characters of the
+    core name that are not letters, digits, '-' or '_' are replaced by '_'.
+    @param[in] path The path of the output.
+    @param[in] core The name of the core.
+    @return The path of the file of the core.
+*/
+std::string getCoreSplitPath(const std::string& path, const std::string& core);
+
+/*!
+    @brief Writes the manifest of a rotated output, a JSON file that lists the parts in order.
+    @param[in] path The path of the output.
+    @param[in] parts The parts.
+    @return True if the manifest was written.
+*/
+bool writeRotationManifest(const std::string& path, const std::vector<RotationPart>& parts);
+} // namespace btf
@@ -10,6 +10,7 @@
 
 #include "btf_entity_types.h"
 #include "common.h"
+#include "state_transition.h"
 
 namespace btf
 {
@@ -128,6 +129,20 @@ class Process
     */
     ErrorCodes doStateTransition(Events ev);
 
+    /*!
+    @brief Gets the transition of the state machine for a state and an event (a lookup in the constexpr transition table).
+    @param[in] state The current state.
+    @param[in] ev The event.
+    @return The transition (next state, result and whether the transition marks the start).
+    */
+    static const StateTransition<States>& getTransition(States state, Events ev);
+
+    /*!
+    @brief Gets the current state.
+    @return States enum.
+    */
+    States getState() const;
+
     /*!
     @brief Converts the enum Events into string.
     @param[in] ev Events enum that will be converted.
@@ -187,6 +202,12 @@ class Process
     */
     void setwaitOSevent(bool wait);
 
+    /*!
+    @brief Allows to set if the process got a start event, e.g. when its state is restored from a checkpoint.
+    @param[in] started True if the process had a start event, else false.
+    */
+    void setWasStarted(bool started);
+
   private:
     /// States variable that keeps track of the current state.
     States state_;
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "common.h"
+#include "state_transition.h"
 
 namespace btf
 {
@@ -77,6 +78,20 @@ class Runnable
     */    
     ErrorCodes doStateTransition(Events core_event);
 
+    /*!
+    @brief Gets the transition of the state machine for a state and an event (a lookup in the constexpr transition table).
+    @param[in] state The current state.
+    @param[in] ev The event.
+    @return The transition (next state, result and whether the transition marks the start).
+    */
+    static const StateTransition<States>& getTransition(States state, Events ev);
+
+    /*!
+    @brief Gets the current state.
+    @return States enum.
+    */
+    States getState() const;
+
     /*!
     @brief Converts the enum Events into string.
     @param[in] ev Events enum that will be converted.
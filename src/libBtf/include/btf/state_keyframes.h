@@ -0,0 +1,198 @@
+#pragma once
+
+/* state_keyframes.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "btf_reader.h"
+
+namespace btf
+{
+
+/*!
+    @brief The logical state of a trace at a point in time: the states of the cores and processes, the running process of each
+    core and the open runnables of each process.
+
+    The state follows the events without validating them: an event that is not allowed in the current state (see the state
+    machines of Core, Process and Runnable) does not change the state.
+*/
+struct TraceState
+{
+    /// An instance of an entity: the name and the instance id.
+    using Instance = std::pair<std::string, uint64_t>;
+
+    /// The timestamp of the state.
+    uint64_t time_{0};
+
+    /// The states of the cores.
+    std::map<std::string, Core::States> cores_;
+
+    /// The states of the process instances (tasks and ISRs) that are not terminated.
+    std::map<Instance, Process::States> processes_;
+
+    /// The running process instance of each core (cores without a running process are not contained).
+    std::map<std::string, Instance> running_processes_;
+
+    /// The open (started, not terminated) runnable instances of each process instance, outermost first.
+    std::map<Instance, std::vector<Instance>> runnable_stacks_;
+
+    /*!
+        @brief Applies an event to the state.
+        @param[in] record The event.
+    */
+    void apply(const BtfRecord& record);
+
+    /*!
+        @brief Compares two states.
+        @param[in] other The other state.
+        @return True if the states are equal.
+    */
+    bool operator==(const TraceState& other) const = default;
+};
+
+/*!
+    @brief A snapshot of the TraceState at a position of a BTF file.
+*/
+struct StateKeyframe
+{
+    /// Byte offset of the first line after the events that are contained in the state.
+    uint64_t offset_{0};
+
+    /// The state after all events before offset_.
+    TraceState state_;
+};
+
+/*!
+    @brief Records keyframes while the events of a BTF file are written or read.
+
+    A keyframe is recorded after every event_interval events or when the time since the last keyframe reaches the time interval,
+    the first keyframe is the empty state at the beginning of the events.
+*/
+class StateKeyframeBuilder
+{
+  public:
+    /*!
+        @brief Constructor of the class StateKeyframeBuilder.
+        @param[in] event_interval The number of events between two keyframes (0 to disable).
+        @param[in] time_interval The time between two keyframes (0 to disable).
+        @param[in] data_offset The byte offset of the first event line (after the header).
+    */
+    StateKeyframeBuilder(uint64_t event_interval, uint64_t time_interval, uint64_t data_offset);
+
+    /*!
+        @brief Applies an event and records a keyframe if an interval is reached.
+        @param[in] record The event.
+        @param[in] next_offset The byte offset of the line after the event.
+    */
+    void add(const BtfRecord& record, uint64_t next_offset);
+
+    /*!
+        @brief Gets the recorded keyframes.
+        @return The keyframes in file order.
+    */
+    const std::vector<StateKeyframe>& getKeyframes() const;
+
+  private:
+    /// The number of events between two keyframes.
+    uint64_t event_interval_;
+
+    /// The time between two keyframes.
+    uint64_t time_interval_;
+
+    /// The current state.
+    TraceState state_;
+
+    /// Number of events since the last keyframe.
+    uint64_t events_since_keyframe_{0};
+
+    /// The keyframes.
+    std::vector<StateKeyframe> keyframes_;
+};
+
+/*!
+    @brief Gets the path of the keyframes of a BTF file ("trace.btf" -> "trace.btf.btfkey").
+    @param[in] btf_path The path of the BTF file.
+    @return The path of the keyframes.
+*/
+std::string getStateKeyframesPath(const std::string& btf_path);
+
+/*!
+    @brief Writes the keyframes of a BTF file (see getStateKeyframesPath()).
+    @param[in] btf_path The path of the BTF file.
+    @param[in] file_size The size of the BTF file, a mismatch invalidates the keyframes.
+    @param[in] keyframes The keyframes.
+    @return True if the keyframes were written.
+*/
+bool writeStateKeyframes(const std::string& btf_path, uint64_t file_size, const std::vector<StateKeyframe>& keyframes);
+
+/*!
+    @brief Random access to the logical state of a BTF file: stateAt() restores the nearest keyframe before a timestamp and replays
+    only the events between the keyframe and the timestamp.
+    @code
+    btf::StateKeyframes keyframes;
+    if (!keyframes.load("trace.btf"))
+    {
+        keyframes.build("trace.btf", 10000);
+        keyframes.save();
+    }
+    const auto state = keyframes.stateAt(1000000);
+    @endcode
+*/
+class StateKeyframes
+{
+  public:
+    /*!
+        @brief Reads a BTF file once and records keyframes. Throws a std::runtime_error if the file cannot be opened.
+        @param[in] btf_path The path of the BTF file.
+        @param[in] event_interval The number of events between two keyframes (0 to disable).
+        @param[in] time_interval The time between two keyframes (0 to disable).
+    */
+    void build(const std::string& btf_path, uint64_t event_interval, uint64_t time_interval = 0);
+
+    /*!
+        @brief Writes the keyframes next to the BTF file (see getStateKeyframesPath()).
+        @return True if the keyframes were written.
+    */
+    bool save() const;
+
+    /*!
+        @brief Loads the keyframes of a BTF file.
+        @param[in] btf_path The path of the BTF file.
+        @return False if there are no valid keyframes for the file.
+    */
+    bool load(const std::string& btf_path);
+
+    /*!
+        @brief Gets the keyframes.
+        @return The keyframes in file order.
+    */
+    const std::vector<StateKeyframe>& getKeyframes() const;
+
+    /*!
+        @brief Gets the state after all events up to a timestamp (inclusive). Throws a std::runtime_error if the BTF file cannot be opened.
+        @param[in] time The timestamp.
+        @return The state.
+    */
+    TraceState stateAt(uint64_t time) const;
+
+  private:
+    /// The path of the BTF file.
+    std::string btf_path_;
+
+    /// The size of the BTF file.
+    uint64_t file_size_{0};
+
+    /// The keyframes.
+    std::vector<StateKeyframe> keyframes_;
+};
+} // namespace btf
@@ -0,0 +1,107 @@
+#pragma once
+
+/* state_transition.h */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+
+#include "common.h"
+
+namespace btf
+{
+
+/*!
+    @brief Result of a state transition (one cell of a StateTransitionTable).
+*/
+template <typename States> struct StateTransition
+{
+    /// The state after the event (only relevant if result_ is success).
+    States next_state_{States::unknown};
+
+    /// Success if the event is allowed in the state, else the error code.
+    ErrorCodes result_{ErrorCodes::success};
+
+    /// True if the transition marks the entity as started (e.g. the start event of a process).
+    bool marks_started_{false};
+};
+
+/*!
+    @brief Constexpr transition matrix (state x event) of an entity state machine.
+
+    Both enums must be contiguous and end with the enumerator unknown, which is part of the matrix.
+    A state transition is a single lookup in the matrix.
+*/
+template <typename States, typename Events> class StateTransitionTable
+{
+  public:
+    /// Number of states (including unknown).
+    static constexpr size_t number_of_states_{static_cast<size_t>(States::unknown) + 1};
+
+    /// Number of events (including unknown).
+    static constexpr size_t number_of_events_{static_cast<size_t>(Events::unknown) + 1};
+
+    /*!
+        @brief Gets the transition of a state and an event.
+        @param[in] state The current state.
+        @param[in] ev The event.
+        @return The transition.
+    */
+    constexpr const StateTransition<States>& get(States state, Events ev) const
+    {
+        return table_[static_cast<size_t>(state)][static_cast<size_t>(ev)];
+    }
+
+    /*!
+        @brief Sets the default result of all events in a state. The state does not change on success.
+        @param[in] state The state.
+        @param[in] result The result for all events.
+    */
+    constexpr void setDefault(States state, ErrorCodes result)
+    {
+        for (auto& transition : table_[static_cast<size_t>(state)])
+        {
+            transition = {state, result, false};
+        }
+    }
+
+    /*!
+        @brief Allows the events in a state.
+        @param[in] state The current state.
+        @param[in] events The events.
+        @param[in] next_state The state after the events.
+        @param[in] marks_started True if the events mark the entity as started.
+    */
+    constexpr void allow(States state, std::initializer_list<Events> events, States next_state, bool marks_started = false)
+    {
+        for (auto ev : events)
+        {
+            table_[static_cast<size_t>(state)][static_cast<size_t>(ev)] = {next_state, ErrorCodes::success, marks_started};
+        }
+    }
+
+    /*!
+        @brief Rejects the events in a state.
+        @param[in] state The current state.
+        @param[in] events The events.
+        @param[in] result The error code for the events.
+    */
+    constexpr void reject(States state, std::initializer_list<Events> events, ErrorCodes result)
+    {
+        for (auto ev : events)
+        {
+            table_[static_cast<size_t>(state)][static_cast<size_t>(ev)] = {state, result, false};
+        }
+    }
+
+  private:
+    /// The matrix: first index is the state, second index the event.
+    std::array<std::array<StateTransition<States>, number_of_events_>, number_of_states_> table_{};
+};
+} // namespace btf
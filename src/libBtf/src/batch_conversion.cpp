@@ -0,0 +1,175 @@
+/* batch_conversion.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/batch_conversion.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace btf
+{
+
+/*!
+    @brief Gets the options of a batch conversion that change the output, as part of the key of the ConversionCache.
+    @param[in] options The options of the batch conversion.
+    @return The options as string.
+*/
+static std::string getCacheOptions(const BatchConversionOptions& options)
+{
+    std::ostringstream out;
+    out << "time_scale=" << static_cast<int>(options.time_scale_) << ";auto_suspend_parent_runnable=" << options.auto_suspend_parent_runnable_
+        << ";source_is_core=" << options.source_is_core_ << ";auto_generate_core_events=" << options.auto_generate_core_events_
+        << ";auto_wait_resume_os_events=" << options.auto_wait_resume_os_events_ << ";delimiter=" << options.delimiter_
+        << ";output_compression=" << static_cast<int>(options.output_compression_);
+    return out.str();
+}
+
+/*!
+    @brief Converts a job of a batch conversion.
+    @param[in,out] file The BtfFile of the worker thread, it is reset for the job.
+    @param[in] job The job.
+    @param[in] options The options of the batch conversion.
+    @param[in,out] cache The cache, nullptr if the cache is disabled.
+    @return The result of the job.
+*/
+static BatchJobResult convertJob(BtfFile& file, const BatchJob& job, const BatchConversionOptions& options, ConversionCache* cache)
+{
+    BatchJobResult result;
+    result.job_ = job;
+    const auto start = std::chrono::steady_clock::now();
+    bool is_output_opened{false};
+    try
+    {
+        file.reset(job.output_path_);
+        std::error_code error;
+        if (std::filesystem::equivalent(job.input_path_, job.output_path_, error))
+        {
+            throw std::runtime_error("input and output are the same file");
+        }
+
+        // the block table of a compressed output is cached as well
+        std::vector<std::string> output_paths{job.output_path_};
+        if (options.output_compression_ != Compressions::none)
+        {
+            output_paths.push_back(getBlockTablePath(job.output_path_));
+        }
+        uint64_t key{0};
+        const bool is_cached = cache != nullptr && job.input_path_ != "-";
+        if (is_cached)
+        {
+            key = ConversionCache::computeKey(job.input_path_, getCacheOptions(options));
+            result.is_cache_hit_ = cache->fetch(key, output_paths, result.import_);
+        }
+
+        if (!result.is_cache_hit_)
+        {
+            auto source = openInputSource(job.input_path_);
+
+            // an output linked to a cached file is replaced instead of being overwritten in place
+            for (const auto& output_path : output_paths)
+            {
+                std::filesystem::remove(output_path, error);
+            }
+
+            // finish() does not report write errors, hence the output is checked before the input is imported
+            if (!std::ofstream(job.output_path_).good())
+            {
+                throw std::runtime_error("could not open output file");
+            }
+            is_output_opened = true;
+
+            result.import_ = file.importFromSource(*source, options.delimiter_, options.max_samples_per_category_);
+            file.finish();
+            if (is_cached)
+            {
+                cache->store(key, output_paths, result.import_);
+            }
+        }
+        result.is_success_ = true;
+    }
+    catch (const std::exception& e)
+    {
+        result.error_ = e.what();
+        file.reset(job.output_path_);
+        if (is_output_opened)
+        {
+            std::error_code error;
+            std::filesystem::remove(job.output_path_, error);
+        }
+    }
+    result.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::vector<BatchJobResult> convertBatch(const std::vector<BatchJob>& jobs, const BatchConversionOptions& options,
+                                         const std::function<void(const BatchJobResult&)>& on_job_finished)
+{
+    std::vector<BatchJobResult> results(jobs.size());
+    if (jobs.empty())
+    {
+        return results;
+    }
+
+    const size_t number_of_threads = std::min(
+        jobs.size(), options.number_of_threads_ != 0 ? options.number_of_threads_ : std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+    std::unique_ptr<ConversionCache> cache;
+    if (!options.cache_directory_.empty())
+    {
+        cache = std::make_unique<ConversionCache>(options.cache_directory_, options.cache_max_size_);
+        cache->setLinkOutputs(options.link_cached_outputs_);
+    }
+
+    // one BtfFile per worker thread, its state tables are reused for all jobs of the thread
+    std::vector<BtfFile> files;
+    files.reserve(number_of_threads);
+    for (size_t t = 0; t < number_of_threads; ++t)
+    {
+        files.emplace_back("", options.time_scale_, options.auto_suspend_parent_runnable_, options.source_is_core_,
+                           options.auto_generate_core_events_, options.auto_wait_resume_os_events_);
+        if (options.output_compression_ != Compressions::none && !files.back().setOutputCompression(options.output_compression_))
+        {
+            throw std::runtime_error("compression is not supported");
+        }
+    }
+
+    // the worker threads take the next job until all jobs are taken
+    std::atomic<size_t> next_job{0};
+    std::mutex callback_mutex;
+    std::vector<std::future<void>> workers;
+    for (size_t t = 0; t < number_of_threads; ++t)
+    {
+        workers.push_back(std::async(std::launch::async, [&, t]() {
+            for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+            {
+                results[i] = convertJob(files[t], jobs[i], options, cache.get());
+                if (on_job_finished)
+                {
+                    std::lock_guard<std::mutex> lock(callback_mutex);
+                    on_job_finished(results[i]);
+                }
+            }
+        }));
+    }
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+    return results;
+}
+} // namespace btf
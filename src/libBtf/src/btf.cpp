@@ -7,17 +7,29 @@
 */
 
 #include "btf/btf.h"
+#include "btf/state_keyframes.h"
 
 #include "helper/helper.h"
 
+#include <charconv>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
 using helper::logging::printTrace;
 using helper::logging::printWarning;
 
 namespace btf
 {
 // cppcheck-suppress constParameter
-std::string BtfEntry::toString(std::unordered_map<size_t, std::string>& hash_map) const
+std::string BtfEntry::toString(const std::unordered_map<size_t, std::string>& hash_map) const
 {
+    const auto name = [&hash_map](size_t hash) -> std::string_view {
+        const auto it = hash_map.find(hash);
+        return it == hash_map.end() ? std::string_view{} : std::string_view{it->second};
+    };
     std::stringstream ret;
     if (type_ == EntityTypes::comment)
     {
@@ -33,8 +45,8 @@ std::string BtfEntry::toString(std::unordered_map<size_t, std::string>& hash_map
     }
     else
     {
-        ret << time_ << "," << hash_map[source_hash_] << "," << source_instance_ << "," << entityTypeToString(type_) << ",";
-        ret << hash_map[target_hash_] << "," << target_instance_ << "," << eventToString();
+        ret << time_ << "," << name(source_hash_) << "," << source_instance_ << "," << entityTypeToString(type_) << ",";
+        ret << name(target_hash_) << "," << target_instance_ << "," << eventToString();
 
         // notes are possible for:
         //  - target signal and event write
@@ -96,289 +108,509 @@ BtfFile::BtfFile(std::string path, TimeScales time_scale, bool auto_suspend_pare
 {
 }
 
-void BtfFile::importFromFile(const std::string& path, char delimiter)
+ImportSummary BtfFile::importFromFile(const std::string& path, char delimiter, size_t max_samples_per_category, const ImportFilter& filter)
+{
+    auto source = openInputSource(path);
+    return importFromSource(*source, delimiter, max_samples_per_category, filter);
+}
+
+ImportSummary BtfFile::importFromSource(InputSource& source, char delimiter, size_t max_samples_per_category, const ImportFilter& filter)
 {
     // disable auto generating events
     auto_generate_events_ = false;
-    
-    std::ifstream file(path);
 
-    if (!file.is_open() || !file.good())
+    std::string line;
+    ImportDiagnostics diagnostics(max_samples_per_category);
+    ImportState state;
+    if (filter.isActive())
     {
-        throw std::runtime_error("could not open file");
+        state.filter_ = &filter;
     }
 
-    std::string line;
-
-    bool is_waiting_for_full_migration_event{ false };
-    std::string migration_source_core{};
-    std::string migration_task{};
+    // the source is read in blocks by a background thread, the newlines and delimiters of all lines of a block are found in one pass
+    PrefetchReader reader(source);
+    std::string_view block;
+    size_t keep{0};
+    bool has_data{true};
+    std::string last_line;
+    std::vector<LineFields> lines;
 
-    while (file.good())
+    while (has_data && !state.is_after_window_)
     {
-        helper::util::getline(file, line);
-        if (line.empty())
+        has_data = reader.next(block, keep);
+        if (!has_data)
         {
-            continue;
-        }
-
-        // handle header and comments => keep comments and remove header
-        if (line[0] == '#')
-        {   
-            if(line.substr(1,7) == "version" || line.substr(1,7) == "creator" || line.substr(1,9) == "timescale")
+            if (block.empty())
             {
-                continue;
-            }
-            else
-            {
-            comment(line.substr(1));
-            continue;
+                break;
             }
+            // the last line has no newline
+            last_line.assign(block);
+            last_line.push_back('\n');
+            block = last_line;
         }
+        keep = block.size() - scanLines(block, delimiter, lines);
 
-        // make sure we do not have \r at the end
-        if (line.back() == '\r')
+        for (const auto& fields : lines)
         {
-            line.pop_back();
+            line.assign(block, fields.offset_, fields.size_);
+            importLine(line, fields, diagnostics, state);
+            if (state.is_after_window_)
+            {
+                break;
+            }
         }
+    }
 
-        // read time, source, source_instance_id, type, target, target_instance_id, event and note
-        auto time_end = line.find_first_of(delimiter);
-        auto source_end = line.find_first_of(delimiter, time_end + 1);
-        auto source_instance_id_end = line.find_first_of(delimiter, source_end + 1);
-        auto type_end = line.find_first_of(delimiter, source_instance_id_end + 1);
-        auto target_end = line.find_first_of(delimiter, type_end + 1);
-        auto target_instance_id_end = line.find_first_of(delimiter, target_end + 1);
-        auto event_end = line.find_first_of(delimiter, target_instance_id_end + 1);
-        auto note_end = line.find_first_of(delimiter, event_end +1);
+    // enable auto generating events again
+    auto_generate_events_ = true;
 
-        // event end and note_end is allowed to be npos
-        if (time_end == std::string::npos || source_end == std::string::npos || source_instance_id_end == std::string::npos || type_end == std::string::npos ||
-            target_end == std::string::npos || target_instance_id_end == std::string::npos)
-        {
-            printWarning() << "Could not import line: " << line << ": invalid format\n";
-            continue;
-        }
+    // one aggregated warning instead of one warning per faulty line
+    const auto& summary = diagnostics.getSummary();
+    if (!summary.categories_.empty())
+    {
+        printWarning() << "Import of " << source.getName() << ": " << summary.toString() << '\n';
+    }
+    return summary;
+}
+
+EntityTypes BtfFile::importLine(std::string& line, const LineFields& fields, ImportDiagnostics& diagnostics, ImportState& state)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.pop_back();
+    }
+    if (line.empty())
+    {
+        return EntityTypes::unknown;
+    }
 
-        auto time_str = line.substr(0, time_end);
-        auto source = line.substr(time_end + 1, source_end - time_end - 1);
-        auto sid_str = line.substr(source_end + 1, source_instance_id_end - source_end - 1);
-        auto type_str = line.substr(source_instance_id_end + 1, type_end - source_instance_id_end - 1);
-        auto target = line.substr(type_end + 1, target_end - type_end - 1);
-        auto tid_str = line.substr(target_end + 1, target_instance_id_end - target_end - 1);
-        std::string event_str;
-        if (event_end == std::string::npos)
+    // handle header and comments => keep comments and remove header
+    if (line[0] == '#')
+    {   
+        if(line.substr(1,7) == "version" || line.substr(1,7) == "creator" || line.substr(1,9) == "timescale")
         {
-            event_str = line.substr(target_instance_id_end + 1);
+            return EntityTypes::unknown;
         }
         else
         {
-            event_str = line.substr(target_instance_id_end + 1, event_end - target_instance_id_end - 1);
+        comment(line.substr(1));
+        return EntityTypes::comment;
         }
+    }
+
+    diagnostics.countLine();
 
-        std::string note_str;
-        if(note_end == std::string::npos)
+    // read time, source, source_instance_id, type, target, target_instance_id, event and note
+    const auto field_end = [&fields](size_t field) -> size_t {
+        return field < fields.number_of_delimiters_ ? fields.delimiters_[field] : std::string::npos;
+    };
+    auto time_end = field_end(0);
+    auto source_end = field_end(1);
+    auto source_instance_id_end = field_end(2);
+    auto type_end = field_end(3);
+
+    // check the filter before any further parsing, lines with an unknown type or an invalid format are reported below
+    if (state.filter_ != nullptr && type_end != std::string::npos)
+    {
+        state.filter_type_str_.assign(line, source_instance_id_end + 1, type_end - source_instance_id_end - 1);
+        const auto filter_type = stringToEntityType(state.filter_type_str_);
+        if (filter_type != EntityTypes::unknown)
         {
-            note_str = line.substr(event_end + 1);
+            if (!state.filter_->acceptsType(filter_type))
+            {
+                diagnostics.countFilteredLine();
+                return EntityTypes::unknown;
+            }
+            uint64_t filter_time{0};
+            auto [ptr, ec] = std::from_chars(line.data(), line.data() + time_end, filter_time);
+            if (ec == std::errc() && ptr == line.data() + time_end)
+            {
+                if (filter_time > state.filter_->getEndTime())
+                {
+                    // the events are sorted by time, all remaining events are after the window
+                    diagnostics.countFilteredLine();
+                    state.is_after_window_ = true;
+                    return EntityTypes::unknown;
+                }
+                if (!state.filter_->acceptsTime(filter_type, filter_time))
+                {
+                    diagnostics.countFilteredLine();
+                    return EntityTypes::unknown;
+                }
+            }
+            const auto filter_target_end = field_end(4);
+            const std::string_view line_view(line);
+            if (!state.filter_->acceptsEntities(filter_type, line_view.substr(time_end + 1, source_end - time_end - 1),
+                                        line_view.substr(type_end + 1, filter_target_end == std::string::npos ? std::string::npos : filter_target_end - type_end - 1)))
+            {
+                diagnostics.countFilteredLine();
+                return EntityTypes::unknown;
+            }
         }
-        else
+    }
+
+    auto target_end = field_end(4);
+    auto target_instance_id_end = field_end(5);
+    auto event_end = field_end(6);
+    auto note_end = field_end(7);
+
+    // event end and note_end is allowed to be npos
+    if (time_end == std::string::npos || source_end == std::string::npos || source_instance_id_end == std::string::npos || type_end == std::string::npos ||
+        target_end == std::string::npos || target_instance_id_end == std::string::npos)
+    {
+        diagnostics.record(ImportIssues::invalid_format, EntityTypes::unknown, ErrorCodes::success, {}, line);
+        return EntityTypes::unknown;
+    }
+
+    auto time_str = line.substr(0, time_end);
+    auto source = line.substr(time_end + 1, source_end - time_end - 1);
+    auto sid_str = line.substr(source_end + 1, source_instance_id_end - source_end - 1);
+    auto type_str = line.substr(source_instance_id_end + 1, type_end - source_instance_id_end - 1);
+    auto target = line.substr(type_end + 1, target_end - type_end - 1);
+    auto tid_str = line.substr(target_end + 1, target_instance_id_end - target_end - 1);
+    std::string event_str;
+    if (event_end == std::string::npos)
+    {
+        event_str = line.substr(target_instance_id_end + 1);
+    }
+    else
+    {
+        event_str = line.substr(target_instance_id_end + 1, event_end - target_instance_id_end - 1);
+    }
+
+    std::string note_str;
+    if(note_end == std::string::npos)
+    {
+        note_str = line.substr(event_end + 1);
+    }
+    else
+    {
+        note_str = line.substr(event_end +1, note_end - event_end -1);
+    }
+
+    uint64_t time{0};
+    uint64_t tid{0};
+    try
+    {
+        time = std::stoull(time_str);
+        tid = std::stoull(tid_str);
+    }
+    catch (const std::exception&)
+    {
+        diagnostics.record(ImportIssues::invalid_number, stringToEntityType(type_str), ErrorCodes::success, event_str, line);
+        return EntityTypes::unknown;
+    }
+
+    auto type = stringToEntityType(type_str);
+    if (type == EntityTypes::unknown)
+    {
+        diagnostics.record(ImportIssues::unknown_entity_type, type, ErrorCodes::success, type_str, line);
+        return EntityTypes::unknown;
+    }
+
+    if (state.is_waiting_for_full_migration_event_)
+    {
+        if (type != btf::EntityTypes::task && type != btf::EntityTypes::isr)
         {
-            note_str = line.substr(event_end +1, note_end - event_end -1);
+            // a enforced_migration event must be followed by a task or isr event
+            diagnostics.record(ImportIssues::invalid_migration, type, ErrorCodes::success, event_str, line, false);
+            state.is_waiting_for_full_migration_event_ = false;
         }
+    }
 
-        uint64_t time{0};
-        uint64_t tid{0};
-        try
+    ErrorCodes err = ErrorCodes::success;
+    switch (type)
+    {
+    case btf::EntityTypes::core: {
+        auto c_ev = Core::stringToEvent(event_str);
+        if (c_ev == Core::Events::unknown)
         {
-            time = std::stoull(time_str);
-            tid = std::stoull(tid_str);
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-        catch (const std::exception& e)
+        err = coreEvent(time, target, c_ev);
+        break;
+    }
+    case btf::EntityTypes::os: {
+        auto o_ev = OS::stringToEvent(event_str);
+        if(o_ev == OS::Events::unknown)
         {
-            printWarning() << "Could not prase time or instance id of line: " << line << " : " << e.what() << '\n';
-            continue;
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-
-        auto type = stringToEntityType(type_str);
-        if (type == EntityTypes::unknown)
+        err = osEvent(time, source, target, o_ev);
+        break;
+    }
+    case btf::EntityTypes::task:{
+        auto t_ev = Process::stringToEvent(event_str);
+        if (t_ev == Process::Events::unknown)
         {
-            printWarning() << "could not parse type: " << type_str << "\n";
-            continue;
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
 
-        if (is_waiting_for_full_migration_event)
+        // handle migration: only enforced_migration with immediately followed full_migration is allowed
+        if (t_ev == btf::Process::Events::enforced_migration)
         {
-            if (type != btf::EntityTypes::task && type != btf::EntityTypes::isr)
-            {
-                printWarning() << " [time: " << time << "] a enforced_migration event must be followed by a task or isr event\n";
-                is_waiting_for_full_migration_event = false;
-            }
+            // the next event must be a full_migration
+            state.is_waiting_for_full_migration_event_ = true;
+            state.migration_source_core_ = source;
+            state.migration_task_ = target;
         }
-
-        ErrorCodes err = ErrorCodes::success;
-        switch (type)
+        else if (t_ev == btf::Process::Events::full_migration)
         {
-        case btf::EntityTypes::core: {
-            auto c_ev = Core::stringToEvent(event_str);
-            if (c_ev == Core::Events::unknown)
-            {
-                printWarning() << "could not parse core event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-            err = coreEvent(time, target, c_ev);
-            break;
-        }
-        case btf::EntityTypes::os: {
-            auto o_ev = OS::stringToEvent(event_str);
-            if(o_ev == OS::Events::unknown)
-            {
-                printWarning() << "could not parse OS event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-            err = osEvent(time, source, target, o_ev);
-            break;
-        }
-        case btf::EntityTypes::task:{
-            auto t_ev = Process::stringToEvent(event_str);
-            if (t_ev == Process::Events::unknown)
+            if (state.is_waiting_for_full_migration_event_)
             {
-                printWarning() << "could not parse task event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-
-            // handle migration: only enforced_migration with immediately followed full_migration is allowed
-            if (t_ev == btf::Process::Events::enforced_migration)
-            {
-                // the next event must be a full_migration
-                is_waiting_for_full_migration_event = true;
-                migration_source_core = source;
-                migration_task = target;
-            }
-            else if (t_ev == btf::Process::Events::full_migration)
-            {
-                if (is_waiting_for_full_migration_event)
+                if (target == state.migration_task_)
                 {
-                    if (target == migration_task)
-                    {
-                        err = taskMigrationEvent(time, migration_source_core, source, target, tid);
-                    }
-                    else
-                    {
-                        printWarning() << " [time: " << time << "] got a full_migration event, but the previous enforced_migration had a different task\n";
-                    }
-                    is_waiting_for_full_migration_event = false;
+                    err = taskMigrationEvent(time, state.migration_source_core_, source, target, tid);
                 }
                 else
                 {
-                    printWarning() << " [time: " << time << "] got a full_migration event, but the previous event was not a enforced_migration\n";
+                    // the previous enforced_migration had a different task
+                    diagnostics.record(ImportIssues::invalid_migration, type, ErrorCodes::success, event_str, line);
                 }
+                state.is_waiting_for_full_migration_event_ = false;
             }
             else
             {
-                if (is_waiting_for_full_migration_event)
-                {
-                    printWarning() << " [time: " << time << "] was waiting for a full_migration event, but got a different event\n";
-                }
-                // normal events
-                err = processEvent(time, source, target, tid, t_ev);
-                
+                // the previous event was not a enforced_migration
+                diagnostics.record(ImportIssues::invalid_migration, type, ErrorCodes::success, event_str, line);
             }
-            break;
         }
-        case btf::EntityTypes::isr:{
-            auto isr_rev = Process::stringToEvent(event_str);
-            if(isr_rev == Process::Events::unknown)
+        else
+        {
+            if (state.is_waiting_for_full_migration_event_)
             {
-                printWarning() << "could not parse isr event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
+                // was waiting for a full_migration event, but got a different event
+                diagnostics.record(ImportIssues::invalid_migration, type, ErrorCodes::success, event_str, line, false);
             }
-            err = processEvent(time, source, target, tid, isr_rev, true);
-            break;
+            // normal events
+            err = processEvent(time, source, target, tid, t_ev);
+            
         }
-        case btf::EntityTypes::stimulus: {
-            auto sti_rev = Stimulus::stringToEvent(event_str);
-            if(sti_rev == Stimulus::Events::unknown)
-            {
-                printWarning() << "could not parse stimulus event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-            err = stimulusEvent(time, source, target, sti_rev);
-            break;
+        break;
+    }
+    case btf::EntityTypes::isr:{
+        auto isr_rev = Process::stringToEvent(event_str);
+        if(isr_rev == Process::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-        case btf::EntityTypes::semaphore: {
-            auto sem_rev = Semaphore::stringToEvent(event_str);
-            if(sem_rev == Semaphore::Events::unknown)
-            {
-                printWarning() << "could not parse semaphore event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-                err = semaphoreEvent(time, source, target, sem_rev, std::stoull(note_str));
-            break;
+        err = processEvent(time, source, target, tid, isr_rev, true);
+        break;
+    }
+    case btf::EntityTypes::stimulus: {
+        auto sti_rev = Stimulus::stringToEvent(event_str);
+        if(sti_rev == Stimulus::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-        case btf::EntityTypes::scheduler: {
-            auto sched_rev = Scheduler::stringToEvent(event_str);
-            if(sched_rev == Scheduler::Events::unknown)
-            {
-                printWarning() << "could not parse scheduler event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-                err = schedulerEvent(time, source, target, sched_rev);                  
-            break;
+        err = stimulusEvent(time, source, target, sti_rev);
+        break;
+    }
+    case btf::EntityTypes::semaphore: {
+        auto sem_rev = Semaphore::stringToEvent(event_str);
+        if(sem_rev == Semaphore::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-        case btf::EntityTypes::runnable: {
-            auto r_ev = Runnable::stringToEvent(event_str);
-            if (r_ev == Runnable::Events::unknown)
-            {
-                printWarning() << "could not parse runnable event (\"" << event_str << "\") of line: " << line << "\n";
-                continue;
-            }
-            err = runnableEvent(time, source, target, r_ev);
+        uint64_t note{0};
+        try
+        {
+            note = std::stoull(note_str);
+        }
+        catch (const std::exception&)
+        {
+            diagnostics.record(ImportIssues::invalid_number, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
+        }
+        err = semaphoreEvent(time, source, target, sem_rev, note);
+        break;
+    }
+    case btf::EntityTypes::scheduler: {
+        auto sched_rev = Scheduler::stringToEvent(event_str);
+        if(sched_rev == Scheduler::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
+        }
+            err = schedulerEvent(time, source, target, sched_rev);                  
+        break;
+    }
+    case btf::EntityTypes::runnable: {
+        auto r_ev = Runnable::stringToEvent(event_str);
+        if (r_ev == Runnable::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
+        }
+        err = runnableEvent(time, source, target, r_ev);
 
-            break;
+        break;
+    }
+    case btf::EntityTypes::signal: {
+        auto s_ev = Signal::stringToEvent(event_str);
+        if (s_ev == Signal::Events::unknown)
+        {
+            diagnostics.record(ImportIssues::unknown_event, type, ErrorCodes::success, event_str, line);
+            return EntityTypes::unknown;
         }
-        case btf::EntityTypes::signal: {
-            auto s_ev = Signal::stringToEvent(event_str);
-            if (s_ev == Signal::Events::unknown)
+        std::string signal_value;
+        if (s_ev == Signal::Events::write)
+        {
+            if (event_end != std::string::npos)
             {
-                printWarning() << "could not parse signal event (" << event_str << ") of line: " << line << "\n";
-                continue;
+                signal_value = line.substr(event_end + 1);
             }
-            std::string signal_value;
-            if (s_ev == Signal::Events::write)
+        }
+        err = signalEvent(time, source, target, s_ev, signal_value);
+        break;
+    }
+    default:
+        FATAL_INTERNAL_ERROR_MSG("unknown type");
+        break;
+    }
+
+    if (err != ErrorCodes::success)
+    {
+        diagnostics.record(ImportIssues::rejected_event, type, err, event_str, line);
+    }
+    return type;
+}
+
+void BtfFile::finish()
+{
+    bool is_plain_file{false};
+    if (is_appending_)
+    {
+        std::ofstream out(path_, std::ios::app);
+        for (const auto& e : btf_entries_)
+        {
+            const auto line = e.toString(hash_map_);
+            written_size_ += line.size() + 1;
+            out << line << '\n';
+        }
+        is_plain_file = true;
+    }
+    else if (split_by_core_)
+    {
+        writeCoreFiles();
+    }
+    else if (output_rotation_.isActive())
+    {
+        writeRotatedParts();
+    }
+    else
+    {
+        is_plain_file = output_compression_ == Compressions::none;
+        if (is_plain_file && (keyframe_event_interval_ > 0 || keyframe_time_interval_ > 0))
+        {
+            StateKeyframeBuilder keyframes(keyframe_event_interval_, keyframe_time_interval_, getHeader().size());
+            written_size_ = writeEvents(path_, btf_entries_.begin(), btf_entries_.end(), &keyframes);
+            if (!writeStateKeyframes(path_, written_size_, keyframes.getKeyframes()))
             {
-                if (event_end != std::string::npos)
-                {
-                    signal_value = line.substr(event_end + 1);
-                }
+                printWarning() << "could not write the state keyframes of " << path_ << "\n";
             }
-            err = signalEvent(time, source, target, s_ev, signal_value);
-            break;
         }
-        default:
-            FATAL_INTERNAL_ERROR_MSG("unknown type");
-            break;
+        else
+        {
+            written_size_ = writeEvents(path_, btf_entries_.begin(), btf_entries_.end());
         }
+    }
 
-        if (err != ErrorCodes::success)
+    if (write_state_trailer_ && is_plain_file)
+    {
+        forgetWrittenEvents();
+        if (!checkpoint(getStateTrailerPath(path_)))
         {
-            printWarning() << "Could not emit event of line: " << line << " : " << errorCodeToString(err) << '\n';
+            printWarning() << "could not write the state trailer of " << path_ << "\n";
         }
     }
 
-    // enable auto generating events again
-    auto_generate_events_ = true;
+    clearState();
+    is_appending_ = false;
 }
 
-void BtfFile::finish()
+bool BtfFile::openForAppend()
 {
-    std::ofstream out(path_);
-    out << getHeader();
-    for (const auto& e : btf_entries_)
-    {           
-        out << e.toString(hash_map_) << '\n';           
+    std::error_code error;
+    auto file_size = std::filesystem::file_size(path_, error);
+    if (error)
+    {
+        return false;
+    }
+    {
+        std::ifstream file(path_, std::ios::binary);
+        std::string first_bytes(4, '\0');
+        file.read(first_bytes.data(), static_cast<std::streamsize>(first_bytes.size()));
+        first_bytes.resize(static_cast<size_t>(file.gcount()));
+        if (detectCompression(first_bytes) != Compressions::none)
+        {
+            return false;
+        }
+
+        // the new events must not be appended to an unterminated last line, e.g. of a file written by another tool
+        char last_byte{'\n'};
+        if (file_size > 0)
+        {
+            file.clear();
+            file.seekg(-1, std::ios::end);
+            file.get(last_byte);
+        }
+        file.close();
+        if (last_byte != '\n')
+        {
+            std::ofstream out(path_, std::ios::app);
+            out << '\n';
+            ++file_size;
+        }
     }
 
-    // clear data that requires much memory
+    if (!restore(getStateTrailerPath(path_)) || written_size_ != file_size)
+    {
+        // no matching trailer, the state is rebuilt from the events of the file
+        clearState();
+        did_task_allocation_event_happen_on_core_.clear();
+        last_time_ = 0;
+        importFromFile(path_);
+    }
+    forgetWrittenEvents();
+    custom_header_entries_.clear();
+    written_size_ = file_size;
+    is_appending_ = true;
+    return true;
+}
+
+void BtfFile::reset(std::string path)
+{
+    clearState();
+    path_ = std::move(path);
+    last_time_ = 0;
+    did_task_allocation_event_happen_on_core_.clear();
+    entry_marks_.clear();
+    auto_generate_events_ = true;
+    is_appending_ = false;
+}
+
+void BtfFile::forgetWrittenEvents()
+{
+    btf_entries_.clear();
+    btf_entries_per_entity_.clear();
+    is_entity_index_built_ = false;
+    last_core_events_.clear();
+    time_index_.clear();
+    events_since_time_index_entry_ = 0;
+    entity_time_index_.clear();
+    runnable_without_task_buffers_.clear();
+}
+
+void BtfFile::clearState()
+{
     cores_.clear();
     tasks_.clear();
     semaphores_.clear();
@@ -389,6 +621,11 @@ void BtfFile::finish()
     hash_map_.clear();
     btf_entries_.clear();
     btf_entries_per_entity_.clear();
+    is_entity_index_built_ = false;
+    last_core_events_.clear();
+    time_index_.clear();
+    events_since_time_index_entry_ = 0;
+    entity_time_index_.clear();
     type_map_.clear();
     current_running_tasks_.clear();
     did_de_allocated_task_event_occurred_on_core_.clear();
@@ -397,6 +634,782 @@ void BtfFile::finish()
     runnable_without_task_stacks_.clear();
     runnable_instance_id_counters_.clear();
     custom_header_entries_.clear();
+    written_size_ = 0;
+}
+
+/*!
+    @brief Gets the event an iterator of BtfFile::writeEvents() points to.
+    @param[in] entry The event.
+    @return The event.
+*/
+static const BtfEntry& toEntry(const BtfEntry& entry)
+{
+    return entry;
+}
+
+/*!
+    @brief Gets the event an iterator of BtfFile::writeEvents() points to.
+    @param[in] entry Pointer to the event.
+    @return The event.
+*/
+static const BtfEntry& toEntry(const BtfEntry* entry)
+{
+    return *entry;
+}
+
+template <typename Iterator>
+uint64_t BtfFile::writeEvents(const std::string& path, Iterator first, Iterator last, StateKeyframeBuilder* keyframes)
+{
+    const std::string header = getHeader();
+    uint64_t size = header.size();
+    if (output_compression_ != Compressions::none)
+    {
+        std::ofstream out(path, std::ios::binary);
+        CompressedBlockWriter writer(out, output_compression_, output_block_size_);
+        writer.write(header);
+        for (auto it = first; it != last; ++it)
+        {
+            const BtfEntry& e = toEntry(*it);
+            const auto line = e.toString(hash_map_);
+            size += line.size() + 1;
+            writer.writeLine(line, e.time_, e.type_ == EntityTypes::comment);
+        }
+        if (!writeBlockTable(path, output_compression_, writer.finish()))
+        {
+            printWarning() << "could not write the block table of " << path << "\n";
+        }
+    }
+    else if (write_sidecar_index_)
+    {
+        std::ofstream out(path, std::ios::binary);
+        BtfIndexWriter writer(out);
+        writer.writeHeader(header);
+        for (auto it = first; it != last; ++it)
+        {
+            const BtfEntry& e = toEntry(*it);
+            const auto line = e.toString(hash_map_);
+            size += line.size() + 1;
+            writer.writeLine(line, e.time_, e.type_ == EntityTypes::comment, e.source_hash_, e.target_hash_);
+        }
+        for (const auto& [hash, name] : hash_map_)
+        {
+            writer.addEntityName(hash, name);
+        }
+        if (!writer.finish(getSidecarIndexPath(path)))
+        {
+            printWarning() << "could not write the sidecar index of " << path << "\n";
+        }
+    }
+    else
+    {
+        // IDs without name (ID based API without setStringHashMap()) are written as empty names, see BtfEntry::toString()
+        const auto name = [this](size_t hash) -> std::string_view {
+            const auto it = hash_map_.find(hash);
+            return it == hash_map_.end() ? std::string_view{} : std::string_view{it->second};
+        };
+        std::ofstream out(path);
+        out << header;
+        for (auto it = first; it != last; ++it)
+        {
+            const BtfEntry& e = toEntry(*it);
+            const auto line = e.toString(hash_map_);
+            size += line.size() + 1;
+            out << line << '\n';
+            if (keyframes != nullptr && e.type_ != EntityTypes::comment)
+            {
+                BtfRecord record;
+                record.time_ = e.time_;
+                record.type_ = e.type_;
+                record.source_ = name(e.source_hash_);
+                record.source_instance_ = e.source_instance_;
+                record.target_ = name(e.target_hash_);
+                record.target_instance_ = e.target_instance_;
+                record.event_ = e.event_;
+                keyframes->add(record, size);
+            }
+        }
+    }
+    return size;
+}
+
+void BtfFile::writeRotatedParts()
+{
+    const uint64_t header_size = getHeader().size();
+    std::vector<RotationPart> parts;
+    auto part_begin = btf_entries_.begin();
+    RotationPart part;
+    part.size_ = header_size;
+    bool part_has_events{false};
+    bool is_cut_allowed{false};
+
+    const auto write_part = [&](std::list<BtfEntry>::iterator part_end) {
+        part.path_ = getRotationPartPath(path_, parts.size());
+        part.size_ = writeEvents(part.path_, part_begin, part_end);
+        parts.push_back(part);
+        part = {};
+        part.size_ = header_size;
+        part_has_events = false;
+        part_begin = part_end;
+    };
+
+    for (auto it = btf_entries_.begin(); it != btf_entries_.end(); ++it)
+    {
+        const bool is_comment = it->type_ == EntityTypes::comment;
+        const uint64_t line_size = output_rotation_.max_bytes_ > 0 ? it->toString(hash_map_).size() + 1 : 0;
+
+        // parts are cut before the first event of a new timestamp, but never within a migration pair
+        if (!is_comment && is_cut_allowed && part_has_events && it->time_ != part.last_time_)
+        {
+            const bool is_full = (output_rotation_.max_events_ > 0 && part.number_of_events_ >= output_rotation_.max_events_) ||
+                                 (output_rotation_.max_bytes_ > 0 && part.size_ + line_size > output_rotation_.max_bytes_) ||
+                                 (output_rotation_.time_window_ > 0 && it->time_ - part.first_time_ >= output_rotation_.time_window_);
+            if (is_full)
+            {
+                write_part(it);
+            }
+        }
+
+        ++part.number_of_events_;
+        part.size_ += line_size;
+        if (!is_comment)
+        {
+            if (!part_has_events)
+            {
+                part.first_time_ = it->time_;
+                part_has_events = true;
+            }
+            part.last_time_ = it->time_;
+            is_cut_allowed = !((it->type_ == EntityTypes::task || it->type_ == EntityTypes::isr) &&
+                               it->event_.process_event == Process::Events::enforced_migration);
+        }
+    }
+    if (part_begin != btf_entries_.end() || parts.empty())
+    {
+        write_part(btf_entries_.end());
+    }
+
+    if (!writeRotationManifest(path_, parts))
+    {
+        printWarning() << "could not write the manifest of " << path_ << "\n";
+    }
+}
+
+void BtfFile::writeCoreFiles()
+{
+    const auto is_core = [this](size_t hash) {
+        const auto it = type_map_.find(hash);
+        return it != type_map_.end() && it->second == EntityTypes::core;
+    };
+
+    // core of the processes and runnables as of the current event
+    std::unordered_map<size_t, size_t> entity_cores;
+    const auto get_core = [&](size_t hash) -> size_t {
+        if (is_core(hash))
+        {
+            return hash;
+        }
+        if (const auto it = entity_cores.find(hash); it != entity_cores.end())
+        {
+            return it->second;
+        }
+        // the process has not been allocated yet (e.g. it was only activated), use the core it ran on
+        if (const auto name = hash_map_.find(hash); name != hash_map_.end())
+        {
+            if (const auto core = task_core_map_.find(name->second); core != task_core_map_.end())
+            {
+                return hashName(core->second);
+            }
+        }
+        return 0;
+    };
+
+    std::vector<size_t> cores;
+    std::unordered_map<size_t, std::vector<const BtfEntry*>> core_events;
+    std::vector<const BtfEntry*> comments;
+    for (const auto& e : btf_entries_)
+    {
+        size_t core{0};
+        switch (e.type_)
+        {
+        case EntityTypes::comment:
+            comments.push_back(&e);
+            for (auto& [c, events] : core_events)
+            {
+                events.push_back(&e);
+            }
+            continue;
+        case EntityTypes::core:
+            core = e.target_hash_;
+            break;
+        case EntityTypes::task:
+        case EntityTypes::isr:
+            if (is_core(e.source_hash_))
+            {
+                core = e.source_hash_;
+                entity_cores[e.target_hash_] = core;
+            }
+            else
+            {
+                core = get_core(e.target_hash_);
+            }
+            break;
+        case EntityTypes::runnable:
+            core = get_core(e.source_hash_);
+            entity_cores[e.target_hash_] = core;
+            break;
+        default:
+            core = get_core(e.source_hash_);
+            break;
+        }
+        if (core == 0)
+        {
+            continue;
+        }
+        auto [it, is_new] = core_events.try_emplace(core, comments);
+        if (is_new)
+        {
+            cores.push_back(core);
+        }
+        it->second.push_back(&e);
+    }
+
+    // names that only differ in replaced characters (e.g. "Core 1" and "Core_1") would share a file, the ID of the core is appended
+    std::vector<std::string> paths;
+    std::unordered_set<std::string> used_paths;
+    for (const auto core : cores)
+    {
+        const auto name = hash_map_.find(core);
+        auto core_name = name == hash_map_.end() ? std::to_string(core) : name->second;
+        auto path = getCoreSplitPath(path_, core_name);
+        while (!used_paths.insert(path).second)
+        {
+            core_name += "_" + std::to_string(core);
+            path = getCoreSplitPath(path_, core_name);
+        }
+        paths.push_back(std::move(path));
+    }
+
+    // the files are formatted and written in parallel, each thread takes every number_of_threads-th core
+    const size_t number_of_threads = std::min<size_t>(cores.size(), std::max(1U, std::thread::hardware_concurrency()));
+    std::vector<std::future<void>> workers;
+    for (size_t t = 0; t < number_of_threads; ++t)
+    {
+        workers.push_back(std::async(std::launch::async, [&, t]() {
+            for (size_t i = t; i < cores.size(); i += number_of_threads)
+            {
+                const auto& events = core_events.at(cores[i]);
+                writeEvents(paths[i], events.cbegin(), events.cend());
+            }
+        }));
+    }
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+/*!
+    @brief Converts the event of a BtfEntry into a number for a checkpoint.
+    @param[in] entry The BtfEntry.
+    @return The number of the event.
+*/
+static uint64_t eventToNumber(const BtfEntry& entry)
+{
+    switch (entry.type_)
+    {
+    case EntityTypes::core:
+        return static_cast<uint64_t>(entry.event_.core_event);
+    case EntityTypes::os:
+        return static_cast<uint64_t>(entry.event_.os_event);
+    case EntityTypes::runnable:
+    case EntityTypes::syscall:
+        return static_cast<uint64_t>(entry.event_.runnable_event);
+    case EntityTypes::scheduler:
+        return static_cast<uint64_t>(entry.event_.scheduler_event);
+    case EntityTypes::semaphore:
+        return static_cast<uint64_t>(entry.event_.semaphore_event);
+    case EntityTypes::signal:
+        return static_cast<uint64_t>(entry.event_.signal_event);
+    case EntityTypes::simulation:
+        return static_cast<uint64_t>(entry.event_.simulation_event);
+    case EntityTypes::stimulus:
+        return static_cast<uint64_t>(entry.event_.stimulus_event);
+    default:
+        return static_cast<uint64_t>(entry.event_.process_event);
+    }
+}
+
+/*!
+    @brief Converts a number of a checkpoint into the event of a BtfEntry, see eventToNumber().
+    @param[in] type The entity type of the BtfEntry.
+    @param[in] number The number of the event.
+    @return The event.
+*/
+static BtfEntry::Events numberToEvent(EntityTypes type, uint64_t number)
+{
+    switch (type)
+    {
+    case EntityTypes::core:
+        return BtfEntry::Events{static_cast<Core::Events>(number)};
+    case EntityTypes::os:
+        return BtfEntry::Events{static_cast<OS::Events>(number)};
+    case EntityTypes::runnable:
+    case EntityTypes::syscall:
+        return BtfEntry::Events{static_cast<Runnable::Events>(number)};
+    case EntityTypes::scheduler:
+        return BtfEntry::Events{static_cast<Scheduler::Events>(number)};
+    case EntityTypes::semaphore:
+        return BtfEntry::Events{static_cast<Semaphore::Events>(number)};
+    case EntityTypes::signal:
+        return BtfEntry::Events{static_cast<Signal::Events>(number)};
+    case EntityTypes::simulation:
+        return BtfEntry::Events{static_cast<Simulation::Events>(number)};
+    case EntityTypes::stimulus:
+        return BtfEntry::Events{static_cast<Stimulus::Events>(number)};
+    default:
+        return BtfEntry::Events{static_cast<Process::Events>(number)};
+    }
+}
+
+bool BtfFile::checkpoint(const std::string& path) const
+{
+    CheckpointWriter out;
+
+    // the entities are referenced by their index in the name table (0 is followed by a hash without name)
+    std::unordered_map<size_t, uint64_t> entity_ids;
+    out.writeU64(hash_map_.size());
+    for (const auto& [hash, name] : hash_map_)
+    {
+        entity_ids.emplace(hash, entity_ids.size() + 1);
+        out.writeU64(hash);
+        out.writeString(name);
+    }
+    const auto write_entity = [&](size_t hash) {
+        const auto it = entity_ids.find(hash);
+        out.writeU64(it == entity_ids.end() ? 0 : it->second);
+        if (it == entity_ids.end())
+        {
+            out.writeU64(hash);
+        }
+    };
+
+    // positions of the events that are referenced by iterators
+    std::unordered_map<const BtfEntry*, uint64_t> positions;
+    for (const auto& [core, it] : last_core_events_)
+    {
+        positions.emplace(&*it, 0);
+    }
+    for (const auto& [core, buffer] : runnable_without_task_buffers_)
+    {
+        for (const auto& it : buffer)
+        {
+            positions.emplace(&*it, 0);
+        }
+    }
+    for (const auto& [time, it] : time_index_)
+    {
+        positions.emplace(&*it, 0);
+    }
+
+    // the timestamps are stored as (zigzag encoded) differences to the previous event
+    out.writeU64(btf_entries_.size());
+    uint64_t position{0};
+    uint64_t previous_time{0};
+    for (const auto& e : btf_entries_)
+    {
+        if (const auto it = positions.find(&e); it != positions.end())
+        {
+            it->second = position;
+        }
+        ++position;
+        const auto delta = static_cast<int64_t>(e.time_ - previous_time);
+        previous_time = e.time_;
+        out.writeU64(static_cast<uint64_t>(e.type_));
+        out.writeU64((static_cast<uint64_t>(delta) << 1U) ^ static_cast<uint64_t>(delta >> 63));
+        write_entity(e.source_hash_);
+        out.writeU64(e.source_instance_);
+        write_entity(e.target_hash_);
+        out.writeU64(e.target_instance_);
+        out.writeU64(eventToNumber(e));
+        out.writeString(e.note_);
+    }
+
+    out.writeU64(last_time_);
+    out.writeU64(cores_.size());
+    for (const auto& [hash, core] : cores_)
+    {
+        write_entity(hash);
+        out.writeU64(static_cast<uint64_t>(core.getState()));
+    }
+    out.writeU64(tasks_.size());
+    for (const auto& [id, task] : tasks_)
+    {
+        write_entity(id.first);
+        out.writeU64(id.second);
+        out.writeU64(static_cast<uint64_t>(task.getState()));
+        out.writeU64(task.wasStarted() ? 1 : 0);
+        out.writeU64(task.waitOSevent() ? 1 : 0);
+    }
+    out.writeU64(runnables_.size());
+    for (const auto& [id, runnable] : runnables_)
+    {
+        write_entity(id.first);
+        out.writeU64(id.second);
+        out.writeU64(static_cast<uint64_t>(runnable.getState()));
+        out.writeU64(runnable.wasSuspendedByTaskPreempt() ? 1 : 0);
+    }
+    out.writeU64(semaphores_.size());
+    for (const auto& [hash, semaphore] : semaphores_)
+    {
+        write_entity(hash);
+        out.writeU64(static_cast<uint64_t>(semaphore.getState()));
+    }
+    out.writeU64(task_core_map_.size());
+    for (const auto& [task, core] : task_core_map_)
+    {
+        out.writeString(task);
+        out.writeString(core);
+    }
+    out.writeU64(runnable_stacks_.size());
+    for (const auto& [id, stack] : runnable_stacks_)
+    {
+        write_entity(id.first);
+        out.writeU64(id.second);
+        out.writeU64(stack.size());
+        for (const auto& [runnable, instance] : stack)
+        {
+            write_entity(runnable);
+            out.writeU64(instance);
+        }
+    }
+    out.writeU64(os_iswait_.size());
+    for (const auto& [id, is_waiting] : os_iswait_)
+    {
+        write_entity(std::get<0>(id.first));
+        out.writeU64(std::get<1>(id.first));
+        write_entity(std::get<2>(id.first));
+        write_entity(id.second);
+        out.writeU64(is_waiting ? 1 : 0);
+    }
+    out.writeU64(type_map_.size());
+    for (const auto& [hash, type] : type_map_)
+    {
+        write_entity(hash);
+        out.writeU64(static_cast<uint64_t>(type));
+    }
+    out.writeU64(current_running_tasks_.size());
+    for (const auto& [core, task] : current_running_tasks_)
+    {
+        write_entity(core);
+        write_entity(task.first);
+        out.writeU64(task.second);
+    }
+    out.writeU64(did_de_allocated_task_event_occurred_on_core_.size());
+    for (const auto& [core, occurred] : did_de_allocated_task_event_occurred_on_core_)
+    {
+        write_entity(core);
+        out.writeU64(occurred ? 1 : 0);
+    }
+    out.writeU64(stimuli_instance_ids_map_.size());
+    for (const auto& [stimulus, instance] : stimuli_instance_ids_map_)
+    {
+        write_entity(stimulus);
+        out.writeU64(instance);
+    }
+    out.writeU64(runnable_without_task_buffers_.size());
+    for (const auto& [core, buffer] : runnable_without_task_buffers_)
+    {
+        write_entity(core);
+        out.writeU64(buffer.size());
+        for (const auto& it : buffer)
+        {
+            out.writeU64(positions.at(&*it));
+        }
+    }
+    out.writeU64(runnable_without_task_stacks_.size());
+    for (const auto& [core, stack] : runnable_without_task_stacks_)
+    {
+        write_entity(core);
+        out.writeU64(stack.size());
+        for (const auto& [runnable, instance] : stack)
+        {
+            write_entity(runnable);
+            out.writeU64(instance);
+        }
+    }
+    out.writeU64(runnable_instance_id_counters_.size());
+    for (const auto& [runnable, counter] : runnable_instance_id_counters_)
+    {
+        write_entity(runnable);
+        out.writeU64(counter);
+    }
+    out.writeU64(custom_header_entries_.size());
+    for (const auto& entry : custom_header_entries_)
+    {
+        out.writeString(entry);
+    }
+    out.writeU64(did_task_allocation_event_happen_on_core_.size());
+    for (const auto& [core, happened] : did_task_allocation_event_happen_on_core_)
+    {
+        write_entity(core);
+        out.writeU64(happened ? 1 : 0);
+    }
+    out.writeU64(last_core_events_.size());
+    for (const auto& [core, it] : last_core_events_)
+    {
+        write_entity(core);
+        out.writeU64(positions.at(&*it));
+    }
+    out.writeU64(time_index_.size());
+    for (const auto& [time, it] : time_index_)
+    {
+        out.writeU64(positions.at(&*it));
+    }
+    out.writeU64(events_since_time_index_entry_);
+    out.writeU64(written_size_);
+    out.writeU64(is_appending_ ? 1 : 0);
+
+    return out.save(path);
+}
+
+bool BtfFile::restore(const std::string& path)
+{
+    CheckpointReader in;
+    if (!in.load(path))
+    {
+        return false;
+    }
+
+    // the snapshot is decoded into local containers, they replace the state only if the whole snapshot is valid
+    decltype(hash_map_) hash_map;
+    decltype(btf_entries_) btf_entries;
+    decltype(cores_) cores;
+    decltype(tasks_) tasks;
+    decltype(runnables_) runnables;
+    decltype(semaphores_) semaphores;
+    decltype(task_core_map_) task_core_map;
+    decltype(runnable_stacks_) runnable_stacks;
+    decltype(os_iswait_) os_iswait;
+    decltype(type_map_) type_map;
+    decltype(current_running_tasks_) current_running_tasks;
+    decltype(did_de_allocated_task_event_occurred_on_core_) did_de_allocated_task_event_occurred_on_core;
+    decltype(stimuli_instance_ids_map_) stimuli_instance_ids_map;
+    decltype(runnable_without_task_buffers_) runnable_without_task_buffers;
+    decltype(runnable_without_task_stacks_) runnable_without_task_stacks;
+    decltype(runnable_instance_id_counters_) runnable_instance_id_counters;
+    decltype(custom_header_entries_) custom_header_entries;
+    decltype(did_task_allocation_event_happen_on_core_) did_task_allocation_event_happen_on_core;
+    decltype(last_core_events_) last_core_events;
+    decltype(time_index_) time_index;
+    uint64_t last_time{0};
+    uint64_t events_since_time_index_entry{0};
+    uint64_t written_size{0};
+    bool is_appending{false};
+    try
+    {
+        std::vector<size_t> entity_hashes(in.readCount());
+        for (auto& hash : entity_hashes)
+        {
+            hash = in.readU64();
+            hash_map[hash] = in.readString();
+        }
+        const auto read_entity = [&]() -> size_t {
+            const uint64_t id = in.readU64();
+            if (id == 0)
+            {
+                return in.readU64();
+            }
+            if (id > entity_hashes.size())
+            {
+                throw std::runtime_error("checkpoint is corrupted");
+            }
+            return entity_hashes[id - 1];
+        };
+        const auto read_bool = [&]() {
+            return in.readU64() != 0;
+        };
+
+        std::vector<std::list<BtfEntry>::iterator> entries(in.readCount());
+        uint64_t time{0};
+        for (auto& it : entries)
+        {
+            BtfEntry e;
+            e.type_ = static_cast<EntityTypes>(in.readU64());
+            const uint64_t delta = in.readU64();
+            time += (delta >> 1U) ^ (0 - (delta & 1U));
+            e.time_ = time;
+            e.source_hash_ = read_entity();
+            e.source_instance_ = in.readU64();
+            e.target_hash_ = read_entity();
+            e.target_instance_ = in.readU64();
+            e.event_ = numberToEvent(e.type_, in.readU64());
+            e.note_ = in.readString();
+            btf_entries.push_back(std::move(e));
+            it = std::prev(btf_entries.end());
+        }
+        const auto read_position = [&]() {
+            const uint64_t position = in.readU64();
+            if (position >= entries.size())
+            {
+                throw std::runtime_error("checkpoint is corrupted");
+            }
+            return entries[position];
+        };
+
+        last_time = in.readU64();
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            cores.emplace(hash, Core(static_cast<Core::States>(in.readU64())));
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            const uint64_t instance = in.readU64();
+            Process task(static_cast<Process::States>(in.readU64()));
+            task.setWasStarted(read_bool());
+            task.setwaitOSevent(read_bool());
+            tasks.emplace(std::make_pair(hash, instance), task);
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            const uint64_t instance = in.readU64();
+            Runnable runnable(static_cast<Runnable::States>(in.readU64()));
+            runnable.setWasSuspendedByTaskPreempt(read_bool());
+            runnables.emplace(std::make_pair(hash, instance), runnable);
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            semaphores.emplace(hash, Semaphore(static_cast<Semaphore::States>(in.readU64())));
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            auto task = in.readString();
+            task_core_map[std::move(task)] = in.readString();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            const uint64_t instance = in.readU64();
+            auto& stack = runnable_stacks[{hash, instance}];
+            for (uint64_t i = in.readCount(); i > 0; --i)
+            {
+                const size_t runnable = read_entity();
+                stack.emplace_back(runnable, in.readU64());
+            }
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t task = read_entity();
+            const uint64_t instance = in.readU64();
+            const size_t core = read_entity();
+            const size_t os_event = read_entity();
+            os_iswait[{{task, instance, core}, os_event}] = read_bool();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t hash = read_entity();
+            type_map[hash] = static_cast<EntityTypes>(in.readU64());
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t core = read_entity();
+            const size_t task = read_entity();
+            current_running_tasks[core] = {task, in.readU64()};
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t core = read_entity();
+            did_de_allocated_task_event_occurred_on_core[core] = read_bool();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t stimulus = read_entity();
+            stimuli_instance_ids_map[stimulus] = in.readU64();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            auto& buffer = runnable_without_task_buffers[read_entity()];
+            for (uint64_t i = in.readCount(); i > 0; --i)
+            {
+                buffer.push_back(read_position());
+            }
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            auto& stack = runnable_without_task_stacks[read_entity()];
+            for (uint64_t i = in.readCount(); i > 0; --i)
+            {
+                const size_t runnable = read_entity();
+                stack.emplace_back(runnable, in.readU64());
+            }
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t runnable = read_entity();
+            runnable_instance_id_counters[runnable] = in.readU64();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            custom_header_entries.push_back(in.readString());
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t core = read_entity();
+            did_task_allocation_event_happen_on_core[core] = read_bool();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const size_t core = read_entity();
+            last_core_events[core] = read_position();
+        }
+        for (uint64_t n = in.readCount(); n > 0; --n)
+        {
+            const auto it = read_position();
+            time_index.emplace_back(it->time_, it);
+        }
+        events_since_time_index_entry = in.readU64();
+        written_size = in.readU64();
+        is_appending = read_bool();
+        if (!in.isAtEnd())
+        {
+            return false;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    // the iterators into the local list stay valid when the lists are swapped
+    clearState();
+    hash_map_.swap(hash_map);
+    btf_entries_.swap(btf_entries);
+    cores_.swap(cores);
+    tasks_.swap(tasks);
+    runnables_.swap(runnables);
+    semaphores_.swap(semaphores);
+    task_core_map_.swap(task_core_map);
+    runnable_stacks_.swap(runnable_stacks);
+    os_iswait_.swap(os_iswait);
+    type_map_.swap(type_map);
+    current_running_tasks_.swap(current_running_tasks);
+    did_de_allocated_task_event_occurred_on_core_.swap(did_de_allocated_task_event_occurred_on_core);
+    stimuli_instance_ids_map_.swap(stimuli_instance_ids_map);
+    runnable_without_task_buffers_.swap(runnable_without_task_buffers);
+    runnable_without_task_stacks_.swap(runnable_without_task_stacks);
+    runnable_instance_id_counters_.swap(runnable_instance_id_counters);
+    custom_header_entries_.swap(custom_header_entries);
+    did_task_allocation_event_happen_on_core_.swap(did_task_allocation_event_happen_on_core);
+    last_core_events_.swap(last_core_events);
+    time_index_.swap(time_index);
+    last_time_ = last_time;
+    events_since_time_index_entry_ = events_since_time_index_entry;
+    written_size_ = written_size;
+    is_appending_ = is_appending;
+    return true;
 }
 
 void BtfFile::setStringHashMap(std::unordered_map<size_t, std::string> hash_map)
@@ -404,23 +1417,49 @@ void BtfFile::setStringHashMap(std::unordered_map<size_t, std::string> hash_map)
     hash_map_ = std::move(hash_map);
 }
 
+template <typename MakeEntry>
+ErrorCodes BtfFile::reported(ErrorCodes error, MakeEntry&& make_rejected_entry)
+{
+    if (error != ErrorCodes::success)
+    {
+        reportError(error, make_rejected_entry(), false);
+    }
+    return error;
+}
+
 ErrorCodes BtfFile::coreEvent(uint64_t time, const std::string& core, Core::Events core_event)
+{
+    return reported(emitCoreEvent(time, core, core_event), [&] {
+        return BtfEntry{time, EntityTypes::core, hashName(core), 0, hashName(core), 0, core_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitCoreEvent(uint64_t time, const std::string& core, Core::Events core_event)
 {
     printTrace() << time << "," << core << "," << Core::eventToString(core_event) << "\n";
 
-    size_t core_hash = std::hash<std::string>{}(core);
-    // we must do here a type check, otherwise we mess up our hash map
-    ErrorCodes er = checkType(core_hash, EntityTypes::core);
+    size_t core_hash = hashName(core);
+    // we must do here a type check, otherwise we mess up our hash map
+    ErrorCodes er = checkType(core_hash, EntityTypes::core);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+
+    er = registerEntityName(core_hash, core);
     if (er != ErrorCodes::success)
     {
         return er;
     }
-
-    hash_map_[core_hash] = core;
-    return coreEvent(time, core_hash, core_event);
+    return emitCoreEvent(time, core_hash, core_event);
 }
 
 ErrorCodes BtfFile::coreEvent(uint64_t time, size_t core_hash, Core::Events core_event)
+{
+    return reported(emitCoreEvent(time, core_hash, core_event), [&] { return BtfEntry{time, EntityTypes::core, core_hash, 0, core_hash, 0, core_event, ""}; });
+}
+
+ErrorCodes BtfFile::emitCoreEvent(uint64_t time, size_t core_hash, Core::Events core_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -448,22 +1487,30 @@ ErrorCodes BtfFile::coreEvent(uint64_t time, size_t core_hash, Core::Events core
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::core, core_hash, 0, core_hash, 0, core_event, ""});
-    btf_entries_per_entity_[core_hash].push_back((--btf_entries_.end()));
+    last_core_events_[core_hash] = std::prev(btf_entries_.end());
+    indexLastEvent(core_hash);
 
     return er;
 }
 
 ErrorCodes BtfFile::osEvent(uint64_t time, const std::string& source, const std::string& os, OS::Events os_event)
+{
+    return reported(emitOsEvent(time, source, os, os_event), [&] {
+        return BtfEntry{time, EntityTypes::os, hashName(source), 0, hashName(os), 0, os_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitOsEvent(uint64_t time, const std::string& source, const std::string& os, OS::Events os_event)
 {
     printTrace() << time << "," << source << "," << os << "," << OS::eventToString(os_event) << "\n";
     size_t core_hash;
     if(source_is_core_)
     {
-        core_hash = std::hash<std::string>{}(source);
+        core_hash = hashName(source);
     }
     else
     {
-        core_hash = std::hash<std::string>{}(task_core_map_[source]);
+        core_hash = hashName(task_core_map_[source]);
     }
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(core_hash, EntityTypes::core);
@@ -472,7 +1519,7 @@ ErrorCodes BtfFile::osEvent(uint64_t time, const std::string& source, const std:
         return er;
     }
 
-    size_t os_hash = std::hash<std::string>{}(os);
+    size_t os_hash = hashName(os);
     // we must do here a type check, otherwise we mess up our hash map
     er = checkType(os_hash, EntityTypes::os);
     if (er != ErrorCodes::success)
@@ -480,19 +1527,25 @@ ErrorCodes BtfFile::osEvent(uint64_t time, const std::string& source, const std:
         return er;
     }
 
-    if(source_is_core_)
+    er = registerEntityName(core_hash, source_is_core_ ? source : task_core_map_[source]);
+    if (er != ErrorCodes::success)
     {
-        hash_map_[core_hash] = source;
+        return er;
     }
-    else
+    er = registerEntityName(os_hash, os);
+    if (er != ErrorCodes::success)
     {
-        hash_map_[core_hash] = task_core_map_[source];
+        return er;
     }
-    hash_map_[os_hash] = os;
-    return osEvent(time, core_hash, os_hash, os_event);
+    return emitOsEvent(time, core_hash, os_hash, os_event);
 }
 
 ErrorCodes BtfFile::osEvent(uint64_t time, size_t core_hash, size_t os_hash, OS::Events os_event)
+{
+    return reported(emitOsEvent(time, core_hash, os_hash, os_event), [&] { return BtfEntry{time, EntityTypes::os, core_hash, 0, os_hash, 0, os_event, ""}; });
+}
+
+ErrorCodes BtfFile::emitOsEvent(uint64_t time, size_t core_hash, size_t os_hash, OS::Events os_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -519,7 +1572,7 @@ ErrorCodes BtfFile::osEvent(uint64_t time, size_t core_hash, size_t os_hash, OS:
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::os, task_id.first, task_id.second, os_hash, 0, BtfEntry::Events{os_event}, ""});
-    btf_entries_per_entity_[os_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(os_hash);
 
     if(auto_wait_resume_os_events_)
     {
@@ -530,7 +1583,7 @@ ErrorCodes BtfFile::osEvent(uint64_t time, size_t core_hash, size_t os_hash, OS:
         if(OS::eventToString(os_event) == "wait_event")
         {
             os_iswait_[os_quadruple] = true;
-            processEvent(time, core_hash, task_id.first, task_id.second, Process::Events::wait);
+            generateProcessEvent(time, core_hash, task_id, Process::Events::wait);
             tasks_[task_id].setwaitOSevent(true);
         }
         else if(OS::eventToString(os_event) == "set_event")
@@ -541,8 +1594,9 @@ ErrorCodes BtfFile::osEvent(uint64_t time, size_t core_hash, size_t os_hash, OS:
                 {
                     if(count.first.second == os_hash)
                     {
-                        processEvent(time, std::get<2>(count.first.first), std::get<0>(count.first.first), std::get<1>(count.first.first), Process::Events::release);
-                        processEvent(time, std::get<2>(count.first.first), std::get<0>(count.first.first), std::get<1>(count.first.first), Process::Events::resume);
+                        const auto waiting_task_id = std::make_pair(std::get<0>(count.first.first), std::get<1>(count.first.first));
+                        generateProcessEvent(time, std::get<2>(count.first.first), waiting_task_id, Process::Events::release);
+                        generateProcessEvent(time, std::get<2>(count.first.first), waiting_task_id, Process::Events::resume);
                         tasks_[task_id].setwaitOSevent(false);
                     }
                 }
@@ -555,12 +1609,20 @@ ErrorCodes BtfFile::osEvent(uint64_t time, size_t core_hash, size_t os_hash, OS:
 
 ErrorCodes BtfFile::taskMigrationEvent(uint64_t time, const std::string& source_core, const std::string& destination_core, const std::string& task,
                                        uint64_t task_instance_id)
+{
+    return reported(emitTaskMigrationEvent(time, source_core, destination_core, task, task_instance_id), [&] {
+        return BtfEntry{time, EntityTypes::task, hashName(source_core), 0, hashName(task), task_instance_id, Process::Events::enforced_migration, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitTaskMigrationEvent(uint64_t time, const std::string& source_core, const std::string& destination_core, const std::string& task,
+                                           uint64_t task_instance_id)
 {
     printTrace() << time << "," << task << "," << task_instance_id << " from " << source_core << " to " << destination_core << "\n";
 
-    size_t source_core_hash = std::hash<std::string>{}(source_core);
-    size_t destination_core_hash = std::hash<std::string>{}(destination_core);
-    size_t task_hash = std::hash<std::string>{}(task);
+    size_t source_core_hash = hashName(source_core);
+    size_t destination_core_hash = hashName(destination_core);
+    size_t task_hash = hashName(task);
 
     // check types
     ErrorCodes er = checkType(source_core_hash, EntityTypes::core);
@@ -579,13 +1641,32 @@ ErrorCodes BtfFile::taskMigrationEvent(uint64_t time, const std::string& source_
         return er;
     }
 
-    hash_map_[source_core_hash] = source_core;
-    hash_map_[destination_core_hash] = destination_core;
-    hash_map_[task_hash] = task;
-    return taskMigrationEvent(time, source_core_hash, destination_core_hash, task_hash, task_instance_id);
+    er = registerEntityName(source_core_hash, source_core);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    er = registerEntityName(destination_core_hash, destination_core);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    er = registerEntityName(task_hash, task);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitTaskMigrationEvent(time, source_core_hash, destination_core_hash, task_hash, task_instance_id);
 }
 
 ErrorCodes BtfFile::taskMigrationEvent(uint64_t time, size_t source_core_hash, size_t destination_core_hash, size_t task_hash, uint64_t task_instance_id)
+{
+    return reported(emitTaskMigrationEvent(time, source_core_hash, destination_core_hash, task_hash, task_instance_id), [&] {
+        return BtfEntry{time, EntityTypes::task, source_core_hash, 0, task_hash, task_instance_id, Process::Events::enforced_migration, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitTaskMigrationEvent(uint64_t time, size_t source_core_hash, size_t destination_core_hash, size_t task_hash, uint64_t task_instance_id)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -627,21 +1708,29 @@ ErrorCodes BtfFile::taskMigrationEvent(uint64_t time, size_t source_core_hash, s
     // emit events
     btf_entries_.push_back(
         {time, EntityTypes::task, source_core_hash, 0, task_id.first, task_id.second, BtfEntry::Events{Process::Events::enforced_migration}, ""});
-    btf_entries_per_entity_[task_id.first].push_back((--btf_entries_.end()));
+    indexLastEvent(task_id.first);
     btf_entries_.push_back(
         {time, EntityTypes::task, destination_core_hash, 0, task_id.first, task_id.second, BtfEntry::Events{Process::Events::full_migration}, ""});
-    btf_entries_per_entity_[task_id.first].push_back((--btf_entries_.end()));
+    indexLastEvent(task_id.first);
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::processEvent(uint64_t time, const std::string& source, const std::string& process, uint64_t process_instance_id, Process::Events process_event,
                               bool is_isr)
+{
+    return reported(emitProcessEvent(time, source, process, process_instance_id, process_event, is_isr), [&] {
+        return BtfEntry{time, is_isr ? EntityTypes::isr : EntityTypes::task, hashName(source), 0, hashName(process), process_instance_id, process_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitProcessEvent(uint64_t time, const std::string& source, const std::string& process, uint64_t process_instance_id, Process::Events process_event,
+                                     bool is_isr)
 {
     printTrace() << time << "," << source << "," << process << "," << process_instance_id << "," << Process::eventToString(process_event) << "\n";
 
-    size_t source_hash = std::hash<std::string>{}(source);
-    size_t process_hash = std::hash<std::string>{}(process);
+    size_t source_hash = hashName(source);
+    size_t process_hash = hashName(process);
 
     // check types
     ErrorCodes er = checkType(source_hash, Process::getSourceType(process_event));
@@ -656,12 +1745,27 @@ ErrorCodes BtfFile::processEvent(uint64_t time, const std::string& source, const
     }
 
     //add source and task to the hash map.
-    hash_map_[source_hash] = source;
-    hash_map_[process_hash] = process;
-    return processEvent(time, source_hash, process_hash, process_instance_id, process_event, is_isr);
+    er = registerEntityName(source_hash, source);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    er = registerEntityName(process_hash, process);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitProcessEvent(time, source_hash, process_hash, process_instance_id, process_event, is_isr);
 }
 
 ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t process_hash, uint64_t process_instance_id, Process::Events process_event, bool is_isr)
+{
+    return reported(emitProcessEvent(time, source_hash, process_hash, process_instance_id, process_event, is_isr), [&] {
+        return BtfEntry{time, is_isr ? EntityTypes::isr : EntityTypes::task, source_hash, 0, process_hash, process_instance_id, process_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitProcessEvent(uint64_t time, size_t source_hash, size_t process_hash, uint64_t process_instance_id, Process::Events process_event, bool is_isr)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -680,52 +1784,10 @@ ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t proce
     }
 
     auto task_id = std::make_pair(process_hash, process_instance_id);
-
-    if (Process::getSourceType(process_event) == EntityTypes::core)
-    {
-        // check if core is idle (only if no auto generation)
-        if (!auto_generate_core_events_ && cores_[source_hash].isIdle())
-        {
-            return ErrorCodes::event_on_idle_core;
-        }
-
-        // check if another task is running
-        if (current_running_tasks_[source_hash] != no_running_task_ && Process::isEventAllocatingCore(process_event))
-        {
-            // if the task of this event is running --> invalid state transition
-            if (task_id == current_running_tasks_[source_hash])
-            {
-                return ErrorCodes::invalid_state_transition;
-            }
-            return ErrorCodes::multiple_tasks_running;
-        }
-
-        // if the task is deallocating the core it must be running on it
-        // do not check this if this is the very first event on a core
-        if (did_task_allocation_event_happen_on_core_[source_hash])
-        {
-            if (Process::isEventDeallocatingCore(process_event))
-            {
-                if (task_id != current_running_tasks_[source_hash])
-                {
-                    return ErrorCodes::invalid_state_transition;
-                }
-            }
-        }
-
-        if (Process::isEventAllocatingCore(process_event))
-        {
-            did_task_allocation_event_happen_on_core_[source_hash] = true;
-        }
-    }
-
-    // check if this task is currently allocated to another core
-    for (const auto& [s, t] : current_running_tasks_)
+    er = checkCoreAllocation(source_hash, task_id, process_event);
+    if (er != ErrorCodes::success)
     {
-        if (s != source_hash && task_id == t)
-        {
-            return ErrorCodes::allocated_to_different_core;
-        }
+        return er;
     }
 
     // if terminate -> check if there are still runnables
@@ -750,7 +1812,7 @@ ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t proce
                 const auto r_id = *it;
                 if (runnables_[r_id].isRunning())
                 {
-                    if (runnableEvent(time, source_hash, process_hash, r_id.first, Runnable::Events::suspend) != ErrorCodes::success)
+                    if (!generateRunnableEvent(time, source_hash, process_hash, r_id.first, Runnable::Events::suspend))
                     {
                         FATAL_INTERNAL_ERROR_MSG("could not suspend runnable");
                     }
@@ -767,84 +1829,16 @@ ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t proce
 
         btf_entries_.push_back(
             {time, is_isr ? EntityTypes::isr : EntityTypes::task, source_hash, source_id, process_hash, process_instance_id, BtfEntry::Events{process_event}, ""});
-        btf_entries_per_entity_[process_hash].push_back((--btf_entries_.end()));
+        indexLastEvent(process_hash);
 
-        bool was_first_de_alloc{false};
-        if(source_is_core_)
-        {
-            if (!did_de_allocated_task_event_occurred_on_core_[source_hash])
-            {
-                // first allocating task event on a core -> poll and run indicates a already running task
-                if (process_event == Process::Events::poll || process_event == Process::Events::run || Process::isEventAllocatingCore(process_event))
-                {
-                    did_de_allocated_task_event_occurred_on_core_[source_hash] = true;
-                    was_first_de_alloc = true;
-                    current_running_tasks_[source_hash] = task_id;
-                    // map the core to the process
-                    task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
-                }
-            }
-            else
-            {
-                if (Process::isEventAllocatingCore(process_event))
-                {
-                    current_running_tasks_[source_hash] = task_id;
-                    // map the core to the process
-                    task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
-                }
-            }
-        }
-        else
+        const bool was_first_de_alloc = trackDeAllocation(source_hash, task_id, process_event);
+        if (was_first_de_alloc)
         {
-            if (!did_de_allocated_task_event_occurred_on_core_[process_hash])
-            {
-                // first allocating task event on a core -> poll and run indicates a already running task
-                if (process_event == Process::Events::poll || process_event == Process::Events::run || Process::isEventAllocatingCore(process_event))
-                {
-                    did_de_allocated_task_event_occurred_on_core_[process_hash] = true;
-                    was_first_de_alloc = true;
-                    current_running_tasks_[source_hash] = task_id;
-                    // map the core to the process
-                    task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
-                }
-            }
-            else
-            {
-                if (Process::isEventAllocatingCore(process_event))
-                {
-                    current_running_tasks_[source_hash] = task_id;
-                    // map the core to the process
-                    task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
-                }
-            }
+            markLastEntry(first_de_allocation);
         }
-        
-
-        if (Process::isEventDeallocatingCore(process_event))
+        if (Process::isEventDeallocatingCore(process_event) && auto_generate_core_events_)
         {
-            current_running_tasks_[source_hash] = no_running_task_;
-            if(source_is_core_)
-            {
-                if (!did_de_allocated_task_event_occurred_on_core_[process_hash])
-                {
-                    did_de_allocated_task_event_occurred_on_core_[process_hash] = true;
-                    was_first_de_alloc = true;
-                }
-            }
-            else
-            {
-                if (!did_de_allocated_task_event_occurred_on_core_[source_hash])
-                {
-                    did_de_allocated_task_event_occurred_on_core_[source_hash] = true;
-                    was_first_de_alloc = true;
-                }
-            }
-            
-
-            if (auto_generate_core_events_)
-            {
-                generateCoreIdleEvent(time, source_hash);
-            }
+            generateCoreIdleEvent(time, source_hash);
         }
 
         // if the task did his first (De)allocation we must look if we have "loose" runnables
@@ -888,7 +1882,7 @@ ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t proce
                 const auto r_hash = runnable.first;
                 if (runnables_[runnable].wasSuspendedByTaskPreempt())
                 {
-                    if (runnableEvent(time, source_hash, process_hash, r_hash, Runnable::Events::resume) != ErrorCodes::success)
+                    if (!generateRunnableEvent(time, source_hash, process_hash, r_hash, Runnable::Events::resume))
                     {
                         FATAL_INTERNAL_ERROR_MSG("could not resume runnable");
                     }
@@ -917,22 +1911,167 @@ ErrorCodes BtfFile::processEvent(uint64_t time, size_t source_hash, size_t proce
     return er;
 }
 
+ErrorCodes BtfFile::checkCoreAllocation(size_t source_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event)
+{
+    if (Process::getSourceType(process_event) == EntityTypes::core)
+    {
+        // check if core is idle (only if no auto generation)
+        if (!auto_generate_core_events_ && cores_[source_hash].isIdle())
+        {
+            return ErrorCodes::event_on_idle_core;
+        }
+
+        // check if another task is running
+        if (current_running_tasks_[source_hash] != no_running_task_ && Process::isEventAllocatingCore(process_event))
+        {
+            // if the task of this event is running --> invalid state transition
+            if (task_id == current_running_tasks_[source_hash])
+            {
+                return ErrorCodes::invalid_state_transition;
+            }
+            return ErrorCodes::multiple_tasks_running;
+        }
+
+        // if the task is deallocating the core it must be running on it
+        // do not check this if this is the very first event on a core
+        if (did_task_allocation_event_happen_on_core_[source_hash])
+        {
+            if (Process::isEventDeallocatingCore(process_event))
+            {
+                if (task_id != current_running_tasks_[source_hash])
+                {
+                    return ErrorCodes::invalid_state_transition;
+                }
+            }
+        }
+
+        if (Process::isEventAllocatingCore(process_event))
+        {
+            did_task_allocation_event_happen_on_core_[source_hash] = true;
+        }
+    }
+
+    // check if this task is currently allocated to another core
+    for (const auto& [s, t] : current_running_tasks_)
+    {
+        if (s != source_hash && task_id == t)
+        {
+            return ErrorCodes::allocated_to_different_core;
+        }
+    }
+
+    return ErrorCodes::success;
+}
+
+bool BtfFile::trackDeAllocation(size_t source_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event)
+{
+    const auto process_hash = task_id.first;
+    bool was_first_de_alloc{false};
+    if(source_is_core_)
+    {
+        if (!did_de_allocated_task_event_occurred_on_core_[source_hash])
+        {
+            // first allocating task event on a core -> poll and run indicates a already running task
+            if (process_event == Process::Events::poll || process_event == Process::Events::run || Process::isEventAllocatingCore(process_event))
+            {
+                did_de_allocated_task_event_occurred_on_core_[source_hash] = true;
+                was_first_de_alloc = true;
+                current_running_tasks_[source_hash] = task_id;
+                // map the core to the process
+                task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
+            }
+        }
+        else
+        {
+            if (Process::isEventAllocatingCore(process_event))
+            {
+                current_running_tasks_[source_hash] = task_id;
+                // map the core to the process
+                task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
+            }
+        }
+    }
+    else
+    {
+        if (!did_de_allocated_task_event_occurred_on_core_[process_hash])
+        {
+            // first allocating task event on a core -> poll and run indicates a already running task
+            if (process_event == Process::Events::poll || process_event == Process::Events::run || Process::isEventAllocatingCore(process_event))
+            {
+                did_de_allocated_task_event_occurred_on_core_[process_hash] = true;
+                was_first_de_alloc = true;
+                current_running_tasks_[source_hash] = task_id;
+                // map the core to the process
+                task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
+            }
+        }
+        else
+        {
+            if (Process::isEventAllocatingCore(process_event))
+            {
+                current_running_tasks_[source_hash] = task_id;
+                // map the core to the process
+                task_core_map_[hash_map_[process_hash]] = hash_map_[source_hash];
+            }
+        }
+    }
+    
+
+    if (Process::isEventDeallocatingCore(process_event))
+    {
+        current_running_tasks_[source_hash] = no_running_task_;
+        if(source_is_core_)
+        {
+            if (!did_de_allocated_task_event_occurred_on_core_[process_hash])
+            {
+                did_de_allocated_task_event_occurred_on_core_[process_hash] = true;
+                was_first_de_alloc = true;
+            }
+        }
+        else
+        {
+            if (!did_de_allocated_task_event_occurred_on_core_[source_hash])
+            {
+                did_de_allocated_task_event_occurred_on_core_[source_hash] = true;
+                was_first_de_alloc = true;
+            }
+        }
+    }
+
+    return was_first_de_alloc;
+}
+
+void BtfFile::markLastEntry(EntryMarks mark)
+{
+    if (is_marking_entries_)
+    {
+        entry_marks_[&btf_entries_.back()] |= mark;
+    }
+}
+
 ErrorCodes BtfFile::runnableEvent(uint64_t time, const std::string& source, const std::string& runnable, Runnable::Events runnable_event)
+{
+    return reported(emitRunnableEvent(time, source, runnable, runnable_event), [&] {
+        return BtfEntry{time, EntityTypes::runnable, hashName(source), 0, hashName(runnable), 0, runnable_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitRunnableEvent(uint64_t time, const std::string& source, const std::string& runnable, Runnable::Events runnable_event)
 {
     printTrace() << time << "," << source << "," << runnable << "," << Runnable::eventToString(runnable_event) << "\n";
 
     size_t core_hash;
     size_t process_hash;
-    size_t runnable_hash = std::hash<std::string>{}(runnable);
+    size_t runnable_hash = hashName(runnable);
     if(source_is_core_)
     {
-        core_hash = std::hash<std::string>{}(source);
-        process_hash = std::hash<std::string>{}(hash_map_[current_running_tasks_[core_hash].first]);
+        core_hash = hashName(source);
+        process_hash = hashName(hash_map_[current_running_tasks_[core_hash].first]);
     }
     else
     {
-        core_hash = std::hash<std::string>{}(task_core_map_[source]);
-        process_hash = std::hash<std::string>{}(source);
+        core_hash = hashName(task_core_map_[source]);
+        process_hash = hashName(source);
     }
     
 
@@ -948,20 +2087,28 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, const std::string& source, cons
         return er;
     }
 
-    if(source_is_core_)
+    er = registerEntityName(core_hash, source_is_core_ ? source : task_core_map_[source]);
+    if (er != ErrorCodes::success)
     {
-        hash_map_[core_hash] = task_core_map_[source];
+        return er;
     }
-    else
+
+    er = registerEntityName(runnable_hash, runnable);
+    if (er != ErrorCodes::success)
     {
-        hash_map_[core_hash] = source;
+        return er;
     }
-    
-    hash_map_[runnable_hash] = runnable;
-    return runnableEvent(time, core_hash, process_hash, runnable_hash, runnable_event);
+    return emitRunnableEvent(time, core_hash, process_hash, runnable_hash, runnable_event);
 }
 
 ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t process_hash, size_t runnable_hash, Runnable::Events runnable_event)
+{
+    return reported(emitRunnableEvent(time, core_hash, process_hash, runnable_hash, runnable_event), [&] {
+        return BtfEntry{time, EntityTypes::runnable, process_hash, 0, runnable_hash, 0, runnable_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitRunnableEvent(uint64_t time, size_t core_hash, size_t process_hash, size_t runnable_hash, Runnable::Events runnable_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1081,7 +2228,7 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
                         }
                         else
                         {
-                          runnableEvent(time, core_hash, process_hash, runnable_stack_copy[i-1].first, btf::Runnable::Events::terminate);
+                          generateRunnableEvent(time, core_hash, process_hash, runnable_stack_copy[i-1].first, btf::Runnable::Events::terminate);
                         }
                       }
                     }
@@ -1202,6 +2349,12 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
             // check if it is already in the stack
             if (std::find(runnable_stack.begin(), runnable_stack.end(), runnable_id) != runnable_stack.end())
             {
+                // a partition of importFromFileParallel() starts in unknown state, so its stacks can be inconsistent
+                if (is_marking_entries_)
+                {
+                    is_partition_unresolved_ = true;
+                    return ErrorCodes::invalid_state_transition;
+                }
                 FATAL_INTERNAL_ERROR_MSG("starting runnable already in runnable stack");
             }
 
@@ -1210,7 +2363,7 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
                 auto parent_runnable_id = runnable_stack.back();
                 if (runnables_[parent_runnable_id].isRunning())
                 {
-                    if (runnableEvent(time, core_hash, process_hash, parent_runnable_id.first, Runnable::Events::suspend) != ErrorCodes::success) // NOLINT
+                    if (!generateRunnableEvent(time, core_hash, process_hash, parent_runnable_id.first, Runnable::Events::suspend)) // NOLINT
                     {
                         FATAL_INTERNAL_ERROR_MSG("error while generation runnable suspend");
                     }
@@ -1237,7 +2390,11 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
 
         btf_entries_.push_back(
             {time, EntityTypes::runnable, task_id.first, task_id.second, runnable_hash, runnable_instance_id, BtfEntry::Events{runnable_event}, ""});
-        btf_entries_per_entity_[runnable_hash].push_back((--btf_entries_.end()));
+        indexLastEvent(runnable_hash);
+        if (get_new_instance_id)
+        {
+            markLastEntry(new_runnable_instance);
+        }
         if (is_pre_task_event)
         {
             if(source_is_core_)
@@ -1286,7 +2443,7 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
                 {
                     FATAL_INTERNAL_ERROR_MSG("previous runnable still running");
                 }
-                if (runnableEvent(time, core_hash, process_hash, previous_runnable_id.first, Runnable::Events::resume) != ErrorCodes::success)
+                if (!generateRunnableEvent(time, core_hash, process_hash, previous_runnable_id.first, Runnable::Events::resume))
                 {
                     FATAL_INTERNAL_ERROR_MSG("error while generation runnable resume");
                 }
@@ -1297,11 +2454,18 @@ ErrorCodes BtfFile::runnableEvent(uint64_t time, size_t core_hash, size_t proces
 }
 
 ErrorCodes BtfFile::schedulerEvent(uint64_t time, const std::string& source, const std::string& scheduler, Scheduler::Events scheduler_event)
+{
+    return reported(emitSchedulerEvent(time, source, scheduler, scheduler_event), [&] {
+        return BtfEntry{time, EntityTypes::scheduler, hashName(source), 0, hashName(scheduler), 0, scheduler_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitSchedulerEvent(uint64_t time, const std::string& source, const std::string& scheduler, Scheduler::Events scheduler_event)
 {
     printTrace() << time << "," << source << "," << scheduler << "," << Scheduler::eventToString(scheduler_event) << "\n";
 
-    size_t source_hash = std::hash<std::string>{}(source);
-    size_t scheduler_hash = std::hash<std::string>{}(scheduler);
+    size_t source_hash = hashName(source);
+    size_t scheduler_hash = hashName(scheduler);
     ErrorCodes er;
 
     // check if it is a schedule event or a schedulepoint event
@@ -1318,8 +2482,12 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, const std::string& source, con
         {
             return er;
         }
-        hash_map_[scheduler_hash] = scheduler;
-        return schedulerEvent(time, scheduler_hash, scheduler_event);
+        er = registerEntityName(scheduler_hash, scheduler);
+        if (er != ErrorCodes::success)
+        {
+            return er;
+        }
+        return emitSchedulerEvent(time, scheduler_hash, scheduler_event);
     }
     else if(Scheduler::eventToString(scheduler_event)=="schedulepoint")
     {   
@@ -1328,13 +2496,13 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, const std::string& source, con
         if(source_is_core_)
         {
             er = checkType(source_hash, EntityTypes::core);
-            core_hash = std::hash<std::string>{}(source);
+            core_hash = hashName(source);
         }
         else
         {
             er = checkType(source_hash, EntityTypes::task);
             //here we must get the core from the source which is a task!
-            core_hash = std::hash<std::string>{}(task_core_map_[source]);
+            core_hash = hashName(task_core_map_[source]);
         }
         if (er != ErrorCodes::success)
         {   
@@ -1352,17 +2520,18 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, const std::string& source, con
         {   
             return er;   
         }
-        if(source_is_core_)
+        er = registerEntityName(core_hash, source_is_core_ ? source : task_core_map_[source]);
+        if (er != ErrorCodes::success)
         {
-            hash_map_[core_hash] = source;
+            return er;
         }
-        else
+        er = registerEntityName(scheduler_hash, scheduler);
+        if (er != ErrorCodes::success)
         {
-            hash_map_[core_hash] = task_core_map_[source];
+            return er;
         }
-        hash_map_[scheduler_hash] = scheduler;
         
-        return schedulerEvent(time, core_hash, scheduler_hash, scheduler_event);
+        return emitSchedulerEvent(time, core_hash, scheduler_hash, scheduler_event);
     }
     else
     {
@@ -1372,6 +2541,13 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, const std::string& source, con
 }
 
 ErrorCodes BtfFile::schedulerEvent(uint64_t time, size_t scheduler_hash, Scheduler::Events scheduler_event)
+{
+    return reported(emitSchedulerEvent(time, scheduler_hash, scheduler_event), [&] {
+        return BtfEntry{time, EntityTypes::scheduler, scheduler_hash, 0, scheduler_hash, 0, scheduler_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitSchedulerEvent(uint64_t time, size_t scheduler_hash, Scheduler::Events scheduler_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1386,13 +2562,20 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, size_t scheduler_hash, Schedul
     
 
     btf_entries_.push_back({time, EntityTypes::scheduler, scheduler_hash, 0, scheduler_hash, 0, BtfEntry::Events{scheduler_event}, ""});
-    btf_entries_per_entity_[scheduler_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(scheduler_hash);
 
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::schedulerEvent(uint64_t time, size_t core_hash, size_t scheduler_hash, Scheduler::Events scheduler_event)
+{
+    return reported(emitSchedulerEvent(time, core_hash, scheduler_hash, scheduler_event), [&] {
+        return BtfEntry{time, EntityTypes::scheduler, core_hash, 0, scheduler_hash, 0, scheduler_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitSchedulerEvent(uint64_t time, size_t core_hash, size_t scheduler_hash, Scheduler::Events scheduler_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1418,18 +2601,25 @@ ErrorCodes BtfFile::schedulerEvent(uint64_t time, size_t core_hash, size_t sched
     }
 
     btf_entries_.push_back({time, EntityTypes::scheduler, task_id.first, task_id.second, scheduler_hash, 0, BtfEntry::Events{scheduler_event}, ""});
-    btf_entries_per_entity_[scheduler_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(scheduler_hash);
 
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::semaphoreEvent(uint64_t time, const std::string& source, const std::string& target, Semaphore::Events semaphore_event, uint64_t note)
+{
+    return reported(emitSemaphoreEvent(time, source, target, semaphore_event, note), [&] {
+        return BtfEntry{time, EntityTypes::semaphore, hashName(source), 0, hashName(target), 0, semaphore_event, std::to_string(note)};
+    });
+}
+
+ErrorCodes BtfFile::emitSemaphoreEvent(uint64_t time, const std::string& source, const std::string& target, Semaphore::Events semaphore_event, uint64_t note)
 {
     printTrace() << time << "," << source << "," << target << "," << "," << Semaphore::eventToString(semaphore_event) << "\n";
 
-    size_t source_hash = std::hash<std::string>{}(source);
-    size_t target_hash = std::hash<std::string>{}(target);
+    size_t source_hash = hashName(source);
+    size_t target_hash = hashName(target);
     ErrorCodes er = ErrorCodes::success;
 
     //this event check is necessary to determine which source type to expect.
@@ -1459,8 +2649,12 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, const std::string& source, con
                 return ErrorCodes::source_and_target_not_equal;
             }
 
-            hash_map_[target_hash] = target;
-            return semaphoreEvent(time, target_hash, semaphore_event, note); 
+            er = registerEntityName(target_hash, target);
+            if (er != ErrorCodes::success)
+            {
+                return er;
+            }
+            return emitSemaphoreEvent(time, target_hash, semaphore_event, note); 
             break;
         case Semaphore::Events::decrement:
         case Semaphore::Events::increment:
@@ -1482,13 +2676,21 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, const std::string& source, con
                 {
                     return er;
                 }             
-                hash_map_[source_hash] = source;
-                hash_map_[target_hash] = target;
-                return semaphoreEvent(time, source_hash, target_hash, semaphore_event, note);
+                er = registerEntityName(source_hash, source);
+                if (er != ErrorCodes::success)
+                {
+                    return er;
+                }
+                er = registerEntityName(target_hash, target);
+                if (er != ErrorCodes::success)
+                {
+                    return er;
+                }
+                return emitSemaphoreEvent(time, source_hash, target_hash, semaphore_event, note);
             }
             else
             {
-                size_t core_hash = std::hash<std::string>{}(task_core_map_[source]);
+                size_t core_hash = hashName(task_core_map_[source]);
 
                 // check types before adding to hash_map
                 er = checkType(source_hash, EntityTypes::task);
@@ -1511,9 +2713,17 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, const std::string& source, con
                     return er;
                 }
 
-                hash_map_[core_hash] = task_core_map_[source];
-                hash_map_[target_hash] = target;
-                return semaphoreEvent(time, core_hash, target_hash, semaphore_event, note);
+                er = registerEntityName(core_hash, task_core_map_[source]);
+                if (er != ErrorCodes::success)
+                {
+                    return er;
+                }
+                er = registerEntityName(target_hash, target);
+                if (er != ErrorCodes::success)
+                {
+                    return er;
+                }
+                return emitSemaphoreEvent(time, core_hash, target_hash, semaphore_event, note);
             }
             break;
         default:
@@ -1523,6 +2733,13 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, const std::string& source, con
 }
 
 ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note)
+{
+    return reported(emitSemaphoreEvent(time, semaphore_hash, semaphore_event, note), [&] {
+        return BtfEntry{time, EntityTypes::semaphore, semaphore_hash, 0, semaphore_hash, 0, semaphore_event, std::to_string(note)};
+    });
+}
+
+ErrorCodes BtfFile::emitSemaphoreEvent(uint64_t time, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1559,7 +2776,7 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t semaphore_hash, Semapho
     semaphores_[semaphore_hash].doStateTransition(semaphore_event);
 
     btf_entries_.push_back({time, EntityTypes::semaphore, semaphore_hash, 0, semaphore_hash, 0, BtfEntry::Events{semaphore_event}, ""});
-    btf_entries_per_entity_[semaphore_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(semaphore_hash);
 
     //add the note
     btf_entries_.back().note_ = std::to_string(note);
@@ -1568,6 +2785,13 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t semaphore_hash, Semapho
 }
 
 ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t core_hash, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note)
+{
+    return reported(emitSemaphoreEvent(time, core_hash, semaphore_hash, semaphore_event, note), [&] {
+        return BtfEntry{time, EntityTypes::semaphore, core_hash, 0, semaphore_hash, 0, semaphore_event, std::to_string(note)};
+    });
+}
+
+ErrorCodes BtfFile::emitSemaphoreEvent(uint64_t time, size_t core_hash, size_t semaphore_hash, Semaphore::Events semaphore_event, uint64_t note)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1607,7 +2831,7 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t core_hash, size_t semap
     semaphores_[semaphore_hash].doStateTransition(semaphore_event);
     if(note==1){}
     btf_entries_.push_back({time, EntityTypes::semaphore, task_id.first, task_id.second, semaphore_hash, 0, BtfEntry::Events{semaphore_event}, ""});
-    btf_entries_per_entity_[semaphore_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(semaphore_hash);
     
     //add the note
     btf_entries_.back().note_ = std::to_string(note);
@@ -1616,19 +2840,26 @@ ErrorCodes BtfFile::semaphoreEvent(uint64_t time, size_t core_hash, size_t semap
 }
 
 ErrorCodes BtfFile::signalEvent(uint64_t time, const std::string& source, const std::string& signal, Signal::Events signal_event, const std::string& signal_value)
+{
+    return reported(emitSignalEvent(time, source, signal, signal_event, signal_value), [&] {
+        return BtfEntry{time, EntityTypes::signal, hashName(source), 0, hashName(signal), 0, signal_event, signal_value};
+    });
+}
+
+ErrorCodes BtfFile::emitSignalEvent(uint64_t time, const std::string& source, const std::string& signal, Signal::Events signal_event, const std::string& signal_value)
 {
     printTrace() << time << "," << source << "," << signal << "," << Signal::eventToString(signal_event) << "," << signal_value << "\n";
 
     size_t core_hash;
-    size_t signal_hash = std::hash<std::string>{}(signal);
+    size_t signal_hash = hashName(signal);
 
     if(source_is_core_)
     {
-        core_hash = std::hash<std::string>{}(source);
+        core_hash = hashName(source);
     }
     else
     {
-        core_hash = std::hash<std::string>{}(task_core_map_[source]);
+        core_hash = hashName(task_core_map_[source]);
     }
 
     // we must do here a type check, otherwise we mess up our hash map
@@ -1643,19 +2874,27 @@ ErrorCodes BtfFile::signalEvent(uint64_t time, const std::string& source, const
         return er;
     }
 
-    if(source_is_core_)
+    er = registerEntityName(core_hash, source_is_core_ ? source : task_core_map_[source]);
+    if (er != ErrorCodes::success)
     {
-    hash_map_[core_hash] = source;
+        return er;
     }
-    else
+    er = registerEntityName(signal_hash, signal);
+    if (er != ErrorCodes::success)
     {
-    hash_map_[core_hash] = task_core_map_[source];
+        return er;
     }
-    hash_map_[signal_hash] = signal;
-    return signalEvent(time, core_hash, signal_hash, signal_event, signal_value);
+    return emitSignalEvent(time, core_hash, signal_hash, signal_event, signal_value);
 }
 
 ErrorCodes BtfFile::signalEvent(uint64_t time, size_t core_hash, size_t signal_hash, Signal::Events signal_event, const std::string& signal_value)
+{
+    return reported(emitSignalEvent(time, core_hash, signal_hash, signal_event, signal_value), [&] {
+        return BtfEntry{time, EntityTypes::signal, core_hash, 0, signal_hash, 0, signal_event, signal_value};
+    });
+}
+
+ErrorCodes BtfFile::emitSignalEvent(uint64_t time, size_t core_hash, size_t signal_hash, Signal::Events signal_event, const std::string& signal_value)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1680,7 +2919,7 @@ ErrorCodes BtfFile::signalEvent(uint64_t time, size_t core_hash, size_t signal_h
     }
 
     btf_entries_.push_back({time, EntityTypes::signal, task_id.first, task_id.second, signal_hash, 0, BtfEntry::Events{signal_event}, ""});
-    btf_entries_per_entity_[signal_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(signal_hash);
 
     if (!signal_value.empty())
     {
@@ -1701,10 +2940,17 @@ ErrorCodes BtfFile::signalEvent(uint64_t time, size_t core_hash, size_t signal_h
 }
 
 ErrorCodes BtfFile::stimulusEvent(uint64_t time, const std::string& source, const std::string& target, Stimulus::Events stimulus_event)
+{
+    return reported(emitStimulusEvent(time, source, target, stimulus_event), [&] {
+        return BtfEntry{time, EntityTypes::stimulus, hashName(source), 0, hashName(target), 0, stimulus_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitStimulusEvent(uint64_t time, const std::string& source, const std::string& target, Stimulus::Events stimulus_event)
 {
     printTrace() << time << "," << source << "," << target << "," << Stimulus::eventToString(stimulus_event) << "\n";
 
-    size_t stimulus_hash = std::hash<std::string>{}(source);
+    size_t stimulus_hash = hashName(source);
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(stimulus_hash, EntityTypes::stimulus);
     if (er != ErrorCodes::success)
@@ -1718,11 +2964,22 @@ ErrorCodes BtfFile::stimulusEvent(uint64_t time, const std::string& source, cons
         return ErrorCodes::source_and_target_not_equal;
     }
 
-    hash_map_[stimulus_hash] = source;
-    return stimulusEvent(time, stimulus_hash, stimulus_event);
+    er = registerEntityName(stimulus_hash, source);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitStimulusEvent(time, stimulus_hash, stimulus_event);
 }
 
 ErrorCodes BtfFile::stimulusEvent(uint64_t time, size_t stimulus_hash, Stimulus::Events stimulus_event)
+{
+    return reported(emitStimulusEvent(time, stimulus_hash, stimulus_event), [&] {
+        return BtfEntry{time, EntityTypes::stimulus, stimulus_hash, 0, stimulus_hash, 0, stimulus_event, ""};
+    });
+}
+
+ErrorCodes BtfFile::emitStimulusEvent(uint64_t time, size_t stimulus_hash, Stimulus::Events stimulus_event)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1738,13 +2995,13 @@ ErrorCodes BtfFile::stimulusEvent(uint64_t time, size_t stimulus_hash, Stimulus:
     {
         stimuli_instance_ids_map_[stimulus_hash]=0;
         btf_entries_.push_back({time, EntityTypes::stimulus, stimulus_hash, stimuli_instance_ids_map_[stimulus_hash], stimulus_hash, stimuli_instance_ids_map_[stimulus_hash], BtfEntry::Events{stimulus_event}, ""});
-        btf_entries_per_entity_[stimulus_hash].push_back((--btf_entries_.end()));
+        indexLastEvent(stimulus_hash);
     }
     else
     {
         stimuli_instance_ids_map_[stimulus_hash]= stimuli_instance_ids_map_[stimulus_hash]+1;
         btf_entries_.push_back({time, EntityTypes::stimulus, stimulus_hash, stimuli_instance_ids_map_[stimulus_hash], stimulus_hash, stimuli_instance_ids_map_[stimulus_hash], BtfEntry::Events{stimulus_event}, ""});
-        btf_entries_per_entity_[stimulus_hash].push_back((--btf_entries_.end()));
+        indexLastEvent(stimulus_hash);
     }
 
 
@@ -1787,33 +3044,153 @@ void BtfFile::headerEntry(const std::string& header_entry)
 
 void BtfFile::insertEvent(std::list<std::list<BtfEntry>::iterator>::iterator pos, const BtfEntry& entry)
 {
+    buildEntityIndex();
     auto new_it = btf_entries_.insert(*pos, entry);
     btf_entries_per_entity_[entry.source_hash_].insert(pos, new_it);
 }
 
 std::list<std::list<BtfEntry>::iterator>& BtfFile::getEntityEvents(const std::string& entity)
 {
-    size_t hash = std::hash<std::string>{}(entity);
+    buildEntityIndex();
+    size_t hash = hashName(entity);
     return btf_entries_per_entity_[hash];
 }
 
 std::list<std::list<BtfEntry>::iterator> BtfFile::getEventsForEntity(const std::string& entity)
 {
-    return getEventsForEntity(std::hash<std::string>{}(entity));
+    return getEventsForEntity(hashName(entity));
 }
 
 std::list<std::list<BtfEntry>::iterator> BtfFile::getEventsForEntity(size_t entity_hash)
 {
-    if (btf_entries_per_entity_.count(entity_hash) > 0)
+    buildEntityIndex();
+    auto it = btf_entries_per_entity_.find(entity_hash);
+    if (it != btf_entries_per_entity_.end())
     {
-        return btf_entries_per_entity_[entity_hash];
+        return it->second;
     }
     return {};
 }
 
+/*!
+    @brief Finds the first element with a timestamp equal to or later than the given time with a sparse time index.
+    @param[in] index The sparse time index (ascending timestamps).
+    @param[in] begin The first element.
+    @param[in] end The element after the last element.
+    @param[in] time The timestamp.
+    @param[in] get_time Function that gets the timestamp of an element.
+    @return The first element at or after the time, or end.
+*/
+template <typename Iterator, typename GetTime>
+static Iterator findFirstAtOrAfter(const std::vector<std::pair<uint64_t, Iterator>>& index, Iterator begin, Iterator end, uint64_t time, GetTime get_time)
+{
+    // start at the last index entry before the time, the element follows within one interval (or a few more with equal timestamps)
+    auto it = std::partition_point(index.begin(), index.end(), [time](const auto& entry) { return entry.first < time; });
+    auto pos = it == index.begin() ? begin : std::prev(it)->second;
+    while (pos != end && get_time(*pos) < time)
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+void BtfFile::indexLastEvent(size_t entity_hash)
+{
+    const auto last = std::prev(btf_entries_.end());
+    if (time_index_.empty() || ++events_since_time_index_entry_ == time_index_interval_)
+    {
+        time_index_.emplace_back(last->time_, last);
+        events_since_time_index_entry_ = 0;
+    }
+
+    if (is_entity_index_built_)
+    {
+        auto& events = btf_entries_per_entity_[entity_hash];
+        events.push_back(last);
+        if ((events.size() - 1) % time_index_interval_ == 0)
+        {
+            entity_time_index_[entity_hash].emplace_back(last->time_, std::prev(events.cend()));
+        }
+    }
+}
+
+size_t BtfFile::getIndexedEntity(const BtfEntry& entry)
+{
+    return entry.type_ == EntityTypes::simulation ? entry.source_hash_ : entry.target_hash_;
+}
+
+void BtfFile::buildEntityIndex()
+{
+    if (is_entity_index_built_)
+    {
+        return;
+    }
+
+    // collect the entity of each event once, so that the partitions only read a contiguous vector (comments have no entity)
+    std::vector<std::pair<size_t, std::list<BtfEntry>::iterator>> entries;
+    entries.reserve(btf_entries_.size());
+    for (auto it = btf_entries_.begin(); it != btf_entries_.end(); ++it)
+    {
+        if (it->type_ != EntityTypes::comment)
+        {
+            entries.emplace_back(getIndexedEntity(*it), it);
+        }
+    }
+
+    // partition by entity: each thread builds the complete event lists of its entities in trace order
+    constexpr size_t min_events_per_thread{1U << 16U};
+    const size_t number_of_threads = std::clamp<size_t>(std::min<size_t>(std::thread::hardware_concurrency(), entries.size() / min_events_per_thread), 1, 64);
+    std::vector<std::unordered_map<size_t, std::list<std::list<BtfEntry>::iterator>>> partitions(number_of_threads);
+    std::vector<decltype(entity_time_index_)> time_partitions(number_of_threads);
+    auto build_partition = [&entries, &partitions, &time_partitions, number_of_threads](size_t partition) {
+        auto& index = partitions[partition];
+        for (const auto& [entity_hash, it] : entries)
+        {
+            if (entity_hash % number_of_threads == partition)
+            {
+                index[entity_hash].push_back(it);
+            }
+        }
+        auto& time_index = time_partitions[partition];
+        for (const auto& [entity_hash, events] : index)
+        {
+            auto& entity_time_index = time_index[entity_hash];
+            size_t i{0};
+            for (auto it = events.cbegin(); it != events.cend(); ++it, ++i)
+            {
+                if (i % time_index_interval_ == 0)
+                {
+                    entity_time_index.emplace_back((*it)->time_, it);
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t p = 1; p < number_of_threads; ++p)
+    {
+        threads.emplace_back(build_partition, p);
+    }
+    build_partition(0);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    // the partitions are disjoint, merging only moves the nodes
+    btf_entries_per_entity_.clear();
+    entity_time_index_.clear();
+    for (size_t p = 0; p < number_of_threads; ++p)
+    {
+        btf_entries_per_entity_.merge(partitions[p]);
+        entity_time_index_.merge(time_partitions[p]);
+    }
+    is_entity_index_built_ = true;
+}
+
 void BtfFile::generateCoreIdleEvent(uint64_t time, size_t source_hash)
 {
-    if (coreEvent(time, source_hash, Core::Events::idle) != ErrorCodes::success)
+    auto er = emitCoreEvent(time, source_hash, Core::Events::idle);
+    if (er != ErrorCodes::success && !reportError(er, {time, EntityTypes::core, source_hash, 0, source_hash, 0, Core::Events::idle, ""}, true))
     {
         FATAL_INTERNAL_ERROR_MSG("could not auto generate core event")
     }
@@ -1825,19 +3202,40 @@ void BtfFile::generateCoreExecuteEvent(uint64_t time, size_t source_hash, Proces
     if (Process::isEventAllocatingCore(process_event))
     {
         // check if last core event was a idle_execute
-        if (btf_entries_per_entity_.count(source_hash) > 0 && !btf_entries_per_entity_[source_hash].empty() &&
-            btf_entries_per_entity_[source_hash].back()->event_.core_event == Core::Events::execute)
+        auto last = last_core_events_.find(source_hash);
+        if (last != last_core_events_.end() && last->second->event_.core_event == Core::Events::execute)
         {
             // if the idle_execute happened at the same time like this event -> remove it
-            if (btf_entries_per_entity_[source_hash].back()->time_ == time)
+            if (last->second->time_ == time)
             {
-                btf_entries_.erase(btf_entries_per_entity_[source_hash].back());
-                btf_entries_per_entity_[source_hash].pop_back();
+                if (is_entity_index_built_)
+                {
+                    auto& events = btf_entries_per_entity_[source_hash];
+                    auto& entity_time_index = entity_time_index_[source_hash];
+                    if (!entity_time_index.empty() && entity_time_index.back().second == std::prev(events.cend()))
+                    {
+                        entity_time_index.pop_back();
+                    }
+                    events.pop_back();
+                }
+
+                // the removed event can be one of the last entries of the time index
+                for (auto it = time_index_.rbegin(); it != time_index_.rend() && it->first == time; ++it)
+                {
+                    if (it->second == last->second)
+                    {
+                        time_index_.erase(std::prev(it.base()));
+                        break;
+                    }
+                }
+                btf_entries_.erase(last->second);
+                last_core_events_.erase(last);
             }
         }
         else // emit execute
         {
-            if (coreEvent(time, source_hash, Core::Events::execute) != ErrorCodes::success)
+            auto er = emitCoreEvent(time, source_hash, Core::Events::execute);
+            if (er != ErrorCodes::success && !reportError(er, {time, EntityTypes::core, source_hash, 0, source_hash, 0, Core::Events::execute, ""}, true))
             {
                 FATAL_INTERNAL_ERROR_MSG("could not auto generate core event")
             }
@@ -1845,6 +3243,62 @@ void BtfFile::generateCoreExecuteEvent(uint64_t time, size_t source_hash, Proces
     }
 }
 
+bool BtfFile::generateRunnableEvent(uint64_t time, size_t core_hash, size_t process_hash, size_t runnable_hash, Runnable::Events runnable_event)
+{
+    auto er = emitRunnableEvent(time, core_hash, process_hash, runnable_hash, runnable_event);
+    if (er == ErrorCodes::success)
+    {
+        markLastEntry(generated_entry);
+        return true;
+    }
+    return reportError(er, {time, EntityTypes::runnable, process_hash, 0, runnable_hash, 0, runnable_event, ""}, true);
+}
+
+void BtfFile::generateProcessEvent(uint64_t time, size_t core_hash, std::pair<size_t, uint64_t> task_id, Process::Events process_event)
+{
+    auto er = emitProcessEvent(time, core_hash, task_id.first, task_id.second, process_event);
+    if (er != ErrorCodes::success)
+    {
+        reportError(er, {time, EntityTypes::task, core_hash, 0, task_id.first, task_id.second, process_event, ""}, true);
+    }
+}
+
+bool BtfFile::reportError(ErrorCodes error, const BtfEntry& rejected_entry, bool is_generated)
+{
+    if (!error_sink_)
+    {
+        return false;
+    }
+    error_sink_(error, rejected_entry, is_generated);
+    return true;
+}
+
+void BtfFile::setEntityHasher(EntityHasher hasher)
+{
+    hasher_ = hasher;
+}
+
+size_t BtfFile::hashName(std::string_view name) const
+{
+    return static_cast<size_t>(hasher_(name));
+}
+
+ErrorCodes BtfFile::registerEntityName(size_t hash, const std::string& name)
+{
+    // a collision is detected when the ID is registered a second time with a different name
+    auto [it, is_new] = hash_map_.try_emplace(hash, name);
+    if (!is_new && it->second != name)
+    {
+        return ErrorCodes::hash_collision;
+    }
+    return ErrorCodes::success;
+}
+
+void BtfFile::setErrorSink(ErrorSink error_sink)
+{
+    error_sink_ = std::move(error_sink);
+}
+
 ErrorCodes BtfFile::checkTime(uint64_t time)
 {
     if (last_time_ > time)
@@ -1906,18 +3360,72 @@ std::list<BtfEntry> BtfFile::getAllEvents() const
     return btf_entries_;
 }
 
+EventsView BtfFile::viewAllEvents() const
+{
+    return EventsView{btf_entries_};
+}
+
+EntityEventsView BtfFile::viewEventsForEntity(const std::string& entity)
+{
+    return viewEventsForEntity(hashName(entity));
+}
+
+EntityEventsView BtfFile::viewEventsForEntity(size_t entity_hash)
+{
+    // the list of an unknown entity is created, so the view follows the events of the entity emitted later
+    buildEntityIndex();
+    return EntityEventsView{std::ranges::ref_view{std::as_const(btf_entries_per_entity_[entity_hash])}, DereferenceEntry{}};
+}
+
+EventsRange BtfFile::eventsInRange(uint64_t start_time, uint64_t end_time) const
+{
+    auto get_time = [](const BtfEntry& e) { return e.time_; };
+    auto first = findFirstAtOrAfter(time_index_, btf_entries_.cbegin(), btf_entries_.cend(), start_time, get_time);
+    auto last = findFirstAtOrAfter(time_index_, first, btf_entries_.cend(), std::max(start_time, end_time), get_time);
+    return {first, last};
+}
+
+EntityEventsRange BtfFile::eventsInRange(const std::string& entity, uint64_t start_time, uint64_t end_time)
+{
+    return eventsInRange(hashName(entity), start_time, end_time);
+}
+
+EntityEventsRange BtfFile::eventsInRange(size_t entity_hash, uint64_t start_time, uint64_t end_time)
+{
+    static const std::list<std::list<BtfEntry>::iterator> no_events;
+    static const std::vector<std::pair<uint64_t, std::list<std::list<BtfEntry>::iterator>::const_iterator>> no_time_index;
+
+    buildEntityIndex();
+    auto events_it = btf_entries_per_entity_.find(entity_hash);
+    auto time_index_it = entity_time_index_.find(entity_hash);
+    const auto& events = events_it != btf_entries_per_entity_.end() ? events_it->second : no_events;
+    const auto& time_index = time_index_it != entity_time_index_.end() ? time_index_it->second : no_time_index;
+
+    auto get_time = [](std::list<BtfEntry>::iterator e) { return e->time_; };
+    auto first = findFirstAtOrAfter(time_index, events.cbegin(), events.cend(), start_time, get_time);
+    auto last = findFirstAtOrAfter(time_index, first, events.cend(), std::max(start_time, end_time), get_time);
+    return EntityEventsRange{std::ranges::subrange{first, last}, DereferenceEntry{}};
+}
+
 size_t BtfFile::getNumberOfAllEvents() const
 {
     return btf_entries_.size();
 }
 
 ErrorCodes BtfFile::simulationEventProcessName(uint64_t time, const std::string& process, const std::string& name)
+{
+    return reported(emitSimulationEventProcessName(time, process, name), [&] {
+        return BtfEntry{time, EntityTypes::simulation, hashName(process), 0, hashName(process), 0, Simulation::Events::tag, "COMM:" + name};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventProcessName(uint64_t time, const std::string& process, const std::string& name)
 {
     printTrace() << time << "," << process << ","
                                    << "ProcessName,"
                                    << "," << name << "\n";
 
-    size_t process_hash = std::hash<std::string>{}(process);
+    size_t process_hash = hashName(process);
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(process_hash, EntityTypes::task);
     if (er != ErrorCodes::success)
@@ -1925,11 +3433,22 @@ ErrorCodes BtfFile::simulationEventProcessName(uint64_t time, const std::string&
         return er;
     }
 
-    hash_map_[process_hash] = process;
-    return simulationEventProcessName(time, process_hash, name);
+    er = registerEntityName(process_hash, process);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitSimulationEventProcessName(time, process_hash, name);
 }
 
 ErrorCodes BtfFile::simulationEventProcessName(uint64_t time, size_t process_hash, const std::string& name)
+{
+    return reported(emitSimulationEventProcessName(time, process_hash, name), [&] {
+        return BtfEntry{time, EntityTypes::simulation, process_hash, 0, process_hash, 0, Simulation::Events::tag, "COMM:" + name};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventProcessName(uint64_t time, size_t process_hash, const std::string& name)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1942,22 +3461,33 @@ ErrorCodes BtfFile::simulationEventProcessName(uint64_t time, size_t process_has
         return er;
     }
 
-    auto sim_hash = std::hash<std::string>{}("SIM");
-    hash_map_[sim_hash] = "SIM";
+    auto sim_hash = hashName("SIM");
+    er = registerEntityName(sim_hash, "SIM");
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::simulation, process_hash, 0, sim_hash, 0, Simulation::Events::tag, "COMM:" + name});
-    btf_entries_per_entity_[process_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(process_hash);
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::simulationEventProcessCreation(uint64_t time, const std::string& process, uint64_t pid, uint64_t ppid)
+{
+    return reported(emitSimulationEventProcessCreation(time, process, pid, ppid), [&] {
+        return BtfEntry{time, EntityTypes::simulation, hashName(process), 0, hashName(process), 0, Simulation::Events::tag, "PID:" + std::to_string(pid)};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventProcessCreation(uint64_t time, const std::string& process, uint64_t pid, uint64_t ppid)
 {
     printTrace() << time << "," << process << ","
                                    << "ProcessCreation," << pid << ",PID:" << pid << ",PPID:" << ppid << "\n";
 
-    size_t process_hash = std::hash<std::string>{}(process);
+    size_t process_hash = hashName(process);
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(process_hash, EntityTypes::task);
     if (er != ErrorCodes::success)
@@ -1965,11 +3495,22 @@ ErrorCodes BtfFile::simulationEventProcessCreation(uint64_t time, const std::str
         return er;
     }
 
-    hash_map_[process_hash] = process;
-    return simulationEventProcessCreation(time, process_hash, pid, ppid);
+    er = registerEntityName(process_hash, process);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitSimulationEventProcessCreation(time, process_hash, pid, ppid);
 }
 
 ErrorCodes BtfFile::simulationEventProcessCreation(uint64_t time, size_t process_hash, uint64_t pid, uint64_t ppid)
+{
+    return reported(emitSimulationEventProcessCreation(time, process_hash, pid, ppid), [&] {
+        return BtfEntry{time, EntityTypes::simulation, process_hash, 0, process_hash, 0, Simulation::Events::tag, "PID:" + std::to_string(pid)};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventProcessCreation(uint64_t time, size_t process_hash, uint64_t pid, uint64_t ppid)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -1982,24 +3523,35 @@ ErrorCodes BtfFile::simulationEventProcessCreation(uint64_t time, size_t process
         return er;
     }
 
-    auto sim_hash = std::hash<std::string>{}("SIM");
-    hash_map_[sim_hash] = "SIM";
+    auto sim_hash = hashName("SIM");
+    er = registerEntityName(sim_hash, "SIM");
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::simulation, process_hash, 0, sim_hash, 0, Simulation::Events::tag, "PID:" + std::to_string(pid)});
-    btf_entries_per_entity_[process_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(process_hash);
     btf_entries_.push_back({time, EntityTypes::simulation, process_hash, 0, sim_hash, 0, Simulation::Events::tag, "PPID:" + std::to_string(ppid)});
-    btf_entries_per_entity_[process_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(process_hash);
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::simulationEventThreadName(uint64_t time, const std::string& thread, const std::string& name)
+{
+    return reported(emitSimulationEventThreadName(time, thread, name), [&] {
+        return BtfEntry{time, EntityTypes::simulation, hashName(thread), 0, hashName(thread), 0, Simulation::Events::tag, "COMM:" + name};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventThreadName(uint64_t time, const std::string& thread, const std::string& name)
 {
     printTrace() << time << "," << thread << ","
                                    << "ThreadName," << name << "\n";
 
-    size_t thread_hash = std::hash<std::string>{}(thread);
+    size_t thread_hash = hashName(thread);
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(thread_hash, EntityTypes::task);
     if (er != ErrorCodes::success)
@@ -2007,11 +3559,22 @@ ErrorCodes BtfFile::simulationEventThreadName(uint64_t time, const std::string&
         return er;
     }
 
-    hash_map_[thread_hash] = thread;
-    return simulationEventThreadName(time, thread_hash, name);
+    er = registerEntityName(thread_hash, thread);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitSimulationEventThreadName(time, thread_hash, name);
 }
 
 ErrorCodes BtfFile::simulationEventThreadName(uint64_t time, size_t thread_hash, const std::string& name)
+{
+    return reported(emitSimulationEventThreadName(time, thread_hash, name), [&] {
+        return BtfEntry{time, EntityTypes::simulation, thread_hash, 0, thread_hash, 0, Simulation::Events::tag, "COMM:" + name};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventThreadName(uint64_t time, size_t thread_hash, const std::string& name)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -2024,22 +3587,33 @@ ErrorCodes BtfFile::simulationEventThreadName(uint64_t time, size_t thread_hash,
         return er;
     }
 
-    auto sim_hash = std::hash<std::string>{}("SIM");
-    hash_map_[sim_hash] = "SIM";
+    auto sim_hash = hashName("SIM");
+    er = registerEntityName(sim_hash, "SIM");
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::simulation, thread_hash, 0, sim_hash, 0, Simulation::Events::tag, "COMM:" + name});
-    btf_entries_per_entity_[thread_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(thread_hash);
 
     return ErrorCodes::success;
 }
 
 ErrorCodes BtfFile::simulationEventThreadCreation(uint64_t time, const std::string& thread, uint64_t tid, uint64_t pid)
+{
+    return reported(emitSimulationEventThreadCreation(time, thread, tid, pid), [&] {
+        return BtfEntry{time, EntityTypes::simulation, hashName(thread), 0, hashName(thread), 0, Simulation::Events::tag, "TID:" + std::to_string(tid)};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventThreadCreation(uint64_t time, const std::string& thread, uint64_t tid, uint64_t pid)
 {
     printTrace() << time << "," << thread << ","
                                    << "ThreadCreation,TID:" << tid << ",PID:" << pid << "\n";
 
-    size_t thread_hash = std::hash<std::string>{}(thread);
+    size_t thread_hash = hashName(thread);
     // we must do here a type check, otherwise we mess up our hash map
     ErrorCodes er = checkType(thread_hash, EntityTypes::task);
     if (er != ErrorCodes::success)
@@ -2047,11 +3621,22 @@ ErrorCodes BtfFile::simulationEventThreadCreation(uint64_t time, const std::stri
         return er;
     }
 
-    hash_map_[thread_hash] = thread;
-    return simulationEventThreadCreation(time, thread_hash, tid, pid);
+    er = registerEntityName(thread_hash, thread);
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
+    return emitSimulationEventThreadCreation(time, thread_hash, tid, pid);
 }
 
 ErrorCodes BtfFile::simulationEventThreadCreation(uint64_t time, size_t thread_hash, uint64_t tid, uint64_t pid)
+{
+    return reported(emitSimulationEventThreadCreation(time, thread_hash, tid, pid), [&] {
+        return BtfEntry{time, EntityTypes::simulation, thread_hash, 0, thread_hash, 0, Simulation::Events::tag, "TID:" + std::to_string(tid)};
+    });
+}
+
+ErrorCodes BtfFile::emitSimulationEventThreadCreation(uint64_t time, size_t thread_hash, uint64_t tid, uint64_t pid)
 {
     ErrorCodes er = checkTime(time);
     if (er != ErrorCodes::success)
@@ -2064,13 +3649,18 @@ ErrorCodes BtfFile::simulationEventThreadCreation(uint64_t time, size_t thread_h
         return er;
     }
 
-    auto sim_hash = std::hash<std::string>{}("SIM");
-    hash_map_[sim_hash] = "SIM";
+    auto sim_hash = hashName("SIM");
+    er = registerEntityName(sim_hash, "SIM");
+    if (er != ErrorCodes::success)
+    {
+        return er;
+    }
 
     // emit event
     btf_entries_.push_back({time, EntityTypes::simulation, thread_hash, 0, sim_hash, 0, Simulation::Events::tag, "TID:" + std::to_string(tid)});
-    btf_entries_per_entity_[thread_hash].push_back((--btf_entries_.end()));
+    indexLastEvent(thread_hash);
     btf_entries_.push_back({time, EntityTypes::simulation, thread_hash, 0, sim_hash, 0, Simulation::Events::tag, "PID:" + std::to_string(pid)});
+    indexLastEvent(thread_hash);
 
     return ErrorCodes::success;
 }
@@ -2080,4 +3670,41 @@ void BtfFile::setIgnoreMultipleTaskReleases(bool value)
     ignore_multiple_task_releases_ = value;
 }
 
-} // namespace btf
\ No newline at end of file
+void BtfFile::setWriteSidecarIndex(bool value)
+{
+    write_sidecar_index_ = value;
+}
+
+bool BtfFile::setOutputCompression(Compressions compression, size_t block_size)
+{
+    if (!isCompressionSupported(compression))
+    {
+        return false;
+    }
+    output_compression_ = compression;
+    output_block_size_ = block_size;
+    return true;
+}
+
+void BtfFile::setOutputRotation(const OutputRotation& rotation)
+{
+    output_rotation_ = rotation;
+}
+
+void BtfFile::setSplitByCore(bool value)
+{
+    split_by_core_ = value;
+}
+
+void BtfFile::setWriteStateTrailer(bool value)
+{
+    write_state_trailer_ = value;
+}
+
+void BtfFile::setStateKeyframes(uint64_t event_interval, uint64_t time_interval)
+{
+    keyframe_event_interval_ = event_interval;
+    keyframe_time_interval_ = time_interval;
+}
+
+} // namespace btf
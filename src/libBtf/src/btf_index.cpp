@@ -0,0 +1,350 @@
+/* btf_index.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/btf_index.h"
+
+#include "btf/entity_hash.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+
+namespace btf
+{
+
+/// Magic number and version at the beginning of a sidecar index.
+static constexpr std::string_view index_magic{"BTFIDX01"};
+
+/*!
+    @brief Computes the checksum of data. The entity hash is used, since it is fast and stable across platforms.
+    @param[in] data The data.
+    @return The checksum.
+*/
+static uint64_t checksum(std::string_view data)
+{
+    return hashEntityName(data);
+}
+
+/*!
+    @brief Appends a 64-bit value in little endian to a buffer.
+    @param[in,out] buffer The buffer.
+    @param[in] value The value.
+*/
+static void writeU64(std::string& buffer, uint64_t value)
+{
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        buffer.push_back(static_cast<char>((value >> (8U * i)) & 0xffU));
+    }
+}
+
+/*!
+    @brief Reads a 64-bit value in little endian from a buffer.
+    @param[in] buffer The buffer.
+    @param[in,out] offset The offset of the value, afterwards the offset behind the value.
+    @param[out] value The value.
+    @return False if the buffer is too short.
+*/
+static bool readU64(std::string_view buffer, size_t& offset, uint64_t& value)
+{
+    if (buffer.size() < 8 || offset > buffer.size() - 8)
+    {
+        return false;
+    }
+    value = 0;
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(buffer[offset + i])) << (8U * i);
+    }
+    offset += 8;
+    return true;
+}
+
+/*!
+    @brief Reads a byte range of a file.
+    @param[in,out] file The file.
+    @param[in] offset The offset of the range.
+    @param[in] size The size of the range.
+    @param[out] data The bytes.
+    @return False if the range could not be read.
+*/
+static bool readRange(std::ifstream& file, uint64_t offset, uint64_t size, std::string& data)
+{
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    data.resize(size);
+    file.read(data.data(), static_cast<std::streamsize>(size));
+    return file.good() || (file.eof() && static_cast<uint64_t>(file.gcount()) == size);
+}
+
+std::string getSidecarIndexPath(const std::string& btf_path)
+{
+    if (btf_path.size() >= 4 && btf_path.compare(btf_path.size() - 4, 4, ".btf") == 0)
+    {
+        return btf_path + "idx";
+    }
+    return btf_path + ".btfidx";
+}
+
+void BtfIndexBlock::addEntity(size_t entity_hash)
+{
+    const uint64_t h = entity_hash;
+    const uint64_t b0 = h % bloom_bits_;
+    const uint64_t b1 = (h >> 32U) % bloom_bits_;
+    bloom_[b0 / 64] |= uint64_t{1} << (b0 % 64);
+    bloom_[b1 / 64] |= uint64_t{1} << (b1 % 64);
+}
+
+bool BtfIndexBlock::mayContainEntity(size_t entity_hash) const
+{
+    const uint64_t h = entity_hash;
+    const uint64_t b0 = h % bloom_bits_;
+    const uint64_t b1 = (h >> 32U) % bloom_bits_;
+    return (bloom_[b0 / 64] & (uint64_t{1} << (b0 % 64))) != 0 && (bloom_[b1 / 64] & (uint64_t{1} << (b1 % 64))) != 0;
+}
+
+BtfIndexWriter::BtfIndexWriter(std::ostream& out) : out_(out)
+{
+    block_.min_time_ = std::numeric_limits<uint64_t>::max();
+}
+
+void BtfIndexWriter::writeHeader(std::string_view header)
+{
+    out_ << header;
+    file_size_ += header.size();
+    header_size_ = header.size();
+    header_checksum_ = checksum(header);
+}
+
+void BtfIndexWriter::writeLine(std::string_view line, uint64_t time, bool is_comment, size_t source_hash, size_t target_hash)
+{
+    if (block_.number_of_lines_ == 0)
+    {
+        block_.offset_ = file_size_;
+    }
+    buffer_.append(line);
+    buffer_.push_back('\n');
+    ++block_.number_of_lines_;
+
+    if (!is_comment)
+    {
+        block_.min_time_ = std::min(block_.min_time_, time);
+        block_.max_time_ = std::max(block_.max_time_, time);
+        block_.addEntity(source_hash);
+        block_.addEntity(target_hash);
+    }
+
+    if (block_.number_of_lines_ == lines_per_block_)
+    {
+        flushBlock();
+    }
+}
+
+void BtfIndexWriter::addEntityName(size_t entity_hash, std::string_view name)
+{
+    names_.emplace(entity_hash, name);
+}
+
+bool BtfIndexWriter::finish(const std::string& index_path)
+{
+    flushBlock();
+    out_.flush();
+    if (!out_.good())
+    {
+        return false;
+    }
+
+    std::string index(index_magic);
+    writeU64(index, file_size_);
+    writeU64(index, header_size_);
+    writeU64(index, header_checksum_);
+    writeU64(index, blocks_.size());
+    for (const auto& b : blocks_)
+    {
+        writeU64(index, b.offset_);
+        writeU64(index, b.size_);
+        writeU64(index, b.number_of_lines_);
+        writeU64(index, b.min_time_);
+        writeU64(index, b.max_time_);
+        writeU64(index, b.checksum_);
+        for (auto word : b.bloom_)
+        {
+            writeU64(index, word);
+        }
+    }
+    writeU64(index, names_.size());
+    for (const auto& [hash, name] : names_)
+    {
+        writeU64(index, hash);
+        writeU64(index, name.size());
+        index.append(name);
+    }
+    writeU64(index, checksum(index));
+
+    std::ofstream file(index_path, std::ios::binary);
+    file.write(index.data(), static_cast<std::streamsize>(index.size()));
+    return file.good();
+}
+
+void BtfIndexWriter::flushBlock()
+{
+    if (block_.number_of_lines_ == 0)
+    {
+        return;
+    }
+    block_.size_ = buffer_.size();
+    block_.checksum_ = checksum(buffer_);
+    out_ << buffer_;
+    file_size_ += buffer_.size();
+    blocks_.push_back(block_);
+
+    buffer_.clear();
+    block_ = {};
+    block_.min_time_ = std::numeric_limits<uint64_t>::max();
+}
+
+bool BtfIndex::load(const std::string& btf_path, bool verify_all_blocks)
+{
+    blocks_.clear();
+    names_.clear();
+    ids_.clear();
+
+    std::ifstream index_file(getSidecarIndexPath(btf_path), std::ios::binary);
+    if (!index_file.is_open())
+    {
+        return false;
+    }
+    const std::string index((std::istreambuf_iterator<char>(index_file)), std::istreambuf_iterator<char>());
+
+    // magic number and checksum of the index itself
+    size_t offset = index.size() - std::min<size_t>(index.size(), 8);
+    uint64_t index_checksum{0};
+    if (index.compare(0, index_magic.size(), index_magic) != 0 || !readU64(index, offset, index_checksum) ||
+        index_checksum != checksum(std::string_view(index).substr(0, index.size() - 8)))
+    {
+        return false;
+    }
+    const std::string_view content = std::string_view(index).substr(0, index.size() - 8);
+
+    offset = index_magic.size();
+    uint64_t number_of_blocks{0};
+    if (!readU64(content, offset, file_size_) || !readU64(content, offset, header_size_) || !readU64(content, offset, header_checksum_) ||
+        !readU64(content, offset, number_of_blocks))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < number_of_blocks; ++i)
+    {
+        BtfIndexBlock b;
+        if (!readU64(content, offset, b.offset_) || !readU64(content, offset, b.size_) || !readU64(content, offset, b.number_of_lines_) ||
+            !readU64(content, offset, b.min_time_) || !readU64(content, offset, b.max_time_) || !readU64(content, offset, b.checksum_))
+        {
+            return false;
+        }
+        for (auto& word : b.bloom_)
+        {
+            if (!readU64(content, offset, word))
+            {
+                return false;
+            }
+        }
+        blocks_.push_back(b);
+    }
+    uint64_t number_of_names{0};
+    if (!readU64(content, offset, number_of_names))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < number_of_names; ++i)
+    {
+        uint64_t hash{0};
+        uint64_t length{0};
+        if (!readU64(content, offset, hash) || !readU64(content, offset, length) || length > content.size() - offset)
+        {
+            return false;
+        }
+        names_.emplace(hash, content.substr(offset, length));
+        ids_.emplace(content.substr(offset, length), hash);
+        offset += length;
+    }
+
+    // validate against the BTF file: size, header and last block (or all blocks)
+    std::error_code ec;
+    if (std::filesystem::file_size(btf_path, ec) != file_size_ || ec)
+    {
+        return false;
+    }
+    std::ifstream file(btf_path, std::ios::binary);
+    std::string data;
+    if (!readRange(file, 0, header_size_, data) || checksum(data) != header_checksum_)
+    {
+        return false;
+    }
+    for (size_t i = verify_all_blocks ? 0 : blocks_.size() - std::min<size_t>(blocks_.size(), 1); i < blocks_.size(); ++i)
+    {
+        if (!readBlock(file, i, data))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const std::vector<BtfIndexBlock>& BtfIndex::getBlocks() const
+{
+    return blocks_;
+}
+
+const std::unordered_map<size_t, std::string>& BtfIndex::getEntityNames() const
+{
+    return names_;
+}
+
+std::vector<size_t> BtfIndex::findBlocks(uint64_t start_time, uint64_t end_time, const std::vector<std::string>& entities) const
+{
+    std::vector<size_t> entity_hashes;
+    for (const auto& e : entities)
+    {
+        auto it = ids_.find(e);
+        if (it != ids_.end())
+        {
+            entity_hashes.push_back(it->second);
+        }
+    }
+    if (!entities.empty() && entity_hashes.empty())
+    {
+        return {};
+    }
+
+    std::vector<size_t> ret;
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+        const auto& b = blocks_[i];
+        if (b.min_time_ >= end_time || b.max_time_ < start_time)
+        {
+            continue;
+        }
+        if (entity_hashes.empty() || std::any_of(entity_hashes.begin(), entity_hashes.end(), [&b](size_t h) { return b.mayContainEntity(h); }))
+        {
+            ret.push_back(i);
+        }
+    }
+    return ret;
+}
+
+bool BtfIndex::readBlock(std::ifstream& file, size_t block, std::string& lines) const
+{
+    if (block >= blocks_.size())
+    {
+        return false;
+    }
+    const auto& b = blocks_[block];
+    return readRange(file, b.offset_, b.size_, lines) && checksum(lines) == b.checksum_;
+}
+
+} // namespace btf
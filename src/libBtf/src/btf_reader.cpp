@@ -0,0 +1,342 @@
+/* btf_reader.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/btf_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace btf
+{
+
+/*!
+    @brief Parses the timestamp at the beginning of an event line.
+    @param[in] line The line.
+    @param[out] time The timestamp.
+    @return False if the line is empty, a comment or does not start with a number.
+*/
+static bool parseTime(const std::string& line, uint64_t& time)
+{
+    if (line.empty() || line[0] == '#')
+    {
+        return false;
+    }
+    const auto* end = line.data() + line.size();
+    auto [ptr, ec] = std::from_chars(line.data(), end, time);
+    return ec == std::errc() && ptr != line.data();
+}
+
+/*!
+    @brief Parses a number.
+    @param[in] str The string.
+    @param[out] value The number.
+    @return False if the string is not a number.
+*/
+static bool parseNumber(std::string_view str, uint64_t& value)
+{
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && ptr == str.data() + str.size() && !str.empty();
+}
+
+/*!
+    @brief Converts the event name of an entity type into the event.
+    @param[in] type The entity type.
+    @param[in] str The event name.
+    @return The event (the enumerator unknown of the type if the event is not supported).
+*/
+static BtfEntry::Events stringToEvent(EntityTypes type, const std::string& str)
+{
+    switch (type)
+    {
+    case EntityTypes::core:
+        return Core::stringToEvent(str);
+    case EntityTypes::os:
+        return OS::stringToEvent(str);
+    case EntityTypes::task:
+    case EntityTypes::isr:
+    case EntityTypes::thread:
+        return Process::stringToEvent(str);
+    case EntityTypes::runnable:
+    case EntityTypes::syscall:
+        return Runnable::stringToEvent(str);
+    case EntityTypes::scheduler:
+        return Scheduler::stringToEvent(str);
+    case EntityTypes::semaphore:
+        return Semaphore::stringToEvent(str);
+    case EntityTypes::signal:
+        return Signal::stringToEvent(str);
+    case EntityTypes::simulation:
+        return Simulation::stringToEvent(str);
+    case EntityTypes::stimulus:
+        return Stimulus::stringToEvent(str);
+    case EntityTypes::comment:
+    case EntityTypes::unknown:
+        break;
+    }
+    return {};
+}
+
+BtfReader::Iterator::Iterator(BtfReader* reader) : reader_(reader)
+{
+    ++(*this);
+}
+
+BtfReader::Iterator::reference BtfReader::Iterator::operator*() const
+{
+    return reader_->record_;
+}
+
+BtfReader::Iterator::pointer BtfReader::Iterator::operator->() const
+{
+    return &reader_->record_;
+}
+
+BtfReader::Iterator& BtfReader::Iterator::operator++()
+{
+    if (!reader_->readRecord(reader_->record_))
+    {
+        reader_ = nullptr;
+    }
+    return *this;
+}
+
+void BtfReader::Iterator::operator++(int)
+{
+    ++(*this);
+}
+
+BtfReader::BtfReader(const std::string& path, char delimiter) : file_(path, std::ios::binary), delimiter_(delimiter)
+{
+    if (!file_.is_open() || !file_.good())
+    {
+        throw std::runtime_error("could not open file");
+    }
+    file_.seekg(0, std::ios::end);
+    file_size_ = static_cast<uint64_t>(file_.tellg());
+    file_.seekg(0);
+
+    // the header are all lines before the first event
+    std::string line;
+    while (data_offset_ < file_size_ && file_.peek() == '#')
+    {
+        std::getline(file_, line);
+        header_.append(line);
+        header_.push_back('\n');
+        data_offset_ = file_.eof() ? file_size_ : static_cast<uint64_t>(file_.tellg());
+    }
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(data_offset_));
+}
+
+const std::string& BtfReader::getHeader() const
+{
+    return header_;
+}
+
+uint64_t BtfReader::getFileSize() const
+{
+    return file_size_;
+}
+
+uint64_t BtfReader::getDataOffset() const
+{
+    return data_offset_;
+}
+
+uint64_t BtfReader::seekToTime(uint64_t time)
+{
+    // the first event at or after the time is either result or starts in [low, high)
+    uint64_t low = data_offset_;
+    uint64_t high = file_size_;
+    uint64_t result = file_size_;
+    while (low < high)
+    {
+        const uint64_t mid = low + (high - low) / 2;
+        uint64_t event_time{0};
+        uint64_t next_offset{0};
+        const uint64_t event = findEvent(findLineStart(mid), event_time, next_offset);
+        if (event >= high)
+        {
+            // no event starts in [mid, high)
+            high = mid;
+        }
+        else if (event_time < time)
+        {
+            low = next_offset;
+        }
+        else
+        {
+            result = event;
+            high = mid;
+        }
+    }
+
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(result));
+    return result;
+}
+
+uint64_t BtfReader::getPosition()
+{
+    if (!file_.good())
+    {
+        return file_size_;
+    }
+    return static_cast<uint64_t>(file_.tellg());
+}
+
+void BtfReader::seek(uint64_t offset)
+{
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(std::min(offset, file_size_)));
+}
+
+bool BtfReader::readRecord(BtfRecord& record)
+{
+    while (std::getline(file_, line_))
+    {
+        if (!line_.empty() && line_.back() == '\r')
+        {
+            line_.pop_back();
+        }
+        if (line_.empty())
+        {
+            continue;
+        }
+
+        const std::string_view line(line_);
+        if (line[0] == '#')
+        {
+            record = {};
+            record.type_ = EntityTypes::comment;
+            record.note_ = line.substr(1);
+            return true;
+        }
+
+        // time, source, source instance, type, target, target instance, event and the optional note, which is the rest of the line
+        std::array<std::string_view, 8> fields{};
+        size_t number_of_fields{0};
+        size_t start{0};
+        while (number_of_fields < fields.size())
+        {
+            const auto end = number_of_fields + 1 < fields.size() ? line.find(delimiter_, start) : std::string_view::npos;
+            fields[number_of_fields++] = line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+            if (end == std::string_view::npos)
+            {
+                break;
+            }
+            start = end + 1;
+        }
+
+        if (number_of_fields < 7 || !parseNumber(fields[0], record.time_) || !parseNumber(fields[2], record.source_instance_) ||
+            !parseNumber(fields[5], record.target_instance_))
+        {
+            ++skipped_lines_;
+            continue;
+        }
+        record.source_ = fields[1];
+        event_name_.assign(fields[3]);
+        record.type_ = stringToEntityType(event_name_);
+        record.target_ = fields[4];
+        record.event_name_ = fields[6];
+        event_name_.assign(fields[6]);
+        record.event_ = stringToEvent(record.type_, event_name_);
+        record.note_ = fields[7];
+        return true;
+    }
+    return false;
+}
+
+BtfReader::Iterator BtfReader::begin()
+{
+    return Iterator(this);
+}
+
+std::default_sentinel_t BtfReader::end() const
+{
+    return std::default_sentinel;
+}
+
+uint64_t BtfReader::getNumberOfSkippedLines() const
+{
+    return skipped_lines_;
+}
+
+uint64_t BtfReader::findLineStart(uint64_t offset)
+{
+    if (offset <= data_offset_)
+    {
+        return data_offset_;
+    }
+    if (offset >= file_size_)
+    {
+        return file_size_;
+    }
+
+    // resync: a line starts at the offset if the previous character is a newline, otherwise skip the rest of the line
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset - 1));
+    if (file_.get() == '\n')
+    {
+        return offset;
+    }
+    file_.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return file_.eof() ? file_size_ : static_cast<uint64_t>(file_.tellg());
+}
+
+uint64_t BtfReader::findEvent(uint64_t offset, uint64_t& time, uint64_t& next_offset)
+{
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
+    std::string line;
+    while (offset < file_size_)
+    {
+        std::getline(file_, line);
+        next_offset = file_.eof() ? file_size_ : static_cast<uint64_t>(file_.tellg());
+        if (parseTime(line, time))
+        {
+            return offset;
+        }
+        offset = next_offset;
+    }
+    return file_size_;
+}
+
+uint64_t extractWindow(const std::string& btf_path, const std::string& output_path, uint64_t start_time, uint64_t end_time)
+{
+    BtfReader reader(btf_path);
+    const uint64_t end = end_time == std::numeric_limits<uint64_t>::max() ? reader.getFileSize() : reader.seekToTime(end_time + 1);
+    const uint64_t start = std::min(reader.seekToTime(start_time), end);
+
+    std::ofstream out(output_path, std::ios::binary);
+    if (!out.is_open())
+    {
+        throw std::runtime_error("could not open file");
+    }
+    out << reader.getHeader();
+
+    // copy the window in chunks
+    std::ifstream in(btf_path, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(start));
+    std::vector<char> buffer(1U << 20U);
+    uint64_t remaining = end - start;
+    while (remaining > 0 && in.good())
+    {
+        const auto chunk = static_cast<std::streamsize>(std::min<uint64_t>(remaining, buffer.size()));
+        in.read(buffer.data(), chunk);
+        out.write(buffer.data(), in.gcount());
+        remaining -= static_cast<uint64_t>(in.gcount());
+    }
+    return end - start - remaining;
+}
+
+} // namespace btf
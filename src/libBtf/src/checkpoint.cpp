@@ -0,0 +1,154 @@
+/* checkpoint.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/checkpoint.h"
+
+#include "btf/entity_hash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace btf
+{
+
+/// Magic number and version at the beginning of a snapshot.
+static constexpr std::string_view checkpoint_magic{"BTFCKP01"};
+
+std::string getStateTrailerPath(const std::string& path)
+{
+    return path + ".btfstate";
+}
+
+void CheckpointWriter::writeU64(uint64_t value)
+{
+    while (value >= 0x80U)
+    {
+        buffer_.push_back(static_cast<char>((value & 0x7fU) | 0x80U));
+        value >>= 7U;
+    }
+    buffer_.push_back(static_cast<char>(value));
+}
+
+void CheckpointWriter::writeString(std::string_view value)
+{
+    writeU64(value.size());
+    buffer_.append(value);
+}
+
+bool CheckpointWriter::save(const std::string& path) const
+{
+    // the checksum is stored in fixed size little endian, so it can be found at the end of the file
+    std::string checksum(8, '\0');
+    const uint64_t value = hashEntityName(buffer_);
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        checksum[i] = static_cast<char>((value >> (8U * i)) & 0xffU);
+    }
+
+    // the snapshot is written to a temporary file that replaces the file when it is complete, so an interrupted save keeps the old snapshot
+    const auto temporary = path + ".tmp";
+    bool is_written{false};
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file << checkpoint_magic;
+        file.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        file << checksum;
+        file.flush();
+        is_written = file.good();
+    }
+    std::error_code error;
+    if (is_written)
+    {
+        std::filesystem::rename(temporary, path, error);
+        is_written = !error;
+    }
+    if (!is_written)
+    {
+        std::filesystem::remove(temporary, error);
+    }
+    return is_written;
+}
+
+bool CheckpointReader::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content.size() < checkpoint_magic.size() + 8 || content.compare(0, checkpoint_magic.size(), checkpoint_magic) != 0)
+    {
+        return false;
+    }
+    uint64_t checksum{0};
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        checksum |= static_cast<uint64_t>(static_cast<unsigned char>(content[content.size() - 8 + i])) << (8U * i);
+    }
+    content.resize(content.size() - 8);
+    content.erase(0, checkpoint_magic.size());
+    if (checksum != hashEntityName(content))
+    {
+        return false;
+    }
+    buffer_ = std::move(content);
+    offset_ = 0;
+    return true;
+}
+
+uint64_t CheckpointReader::readU64()
+{
+    uint64_t value{0};
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (offset_ >= buffer_.size())
+        {
+            throw std::runtime_error("checkpoint is truncated");
+        }
+        const auto byte = static_cast<unsigned char>(buffer_[offset_++]);
+        value |= static_cast<uint64_t>(byte & 0x7fU) << shift;
+        if ((byte & 0x80U) == 0)
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error("checkpoint is corrupted");
+}
+
+uint64_t CheckpointReader::readCount()
+{
+    const uint64_t count = readU64();
+    if (count > buffer_.size() - offset_)
+    {
+        throw std::runtime_error("checkpoint is corrupted");
+    }
+    return count;
+}
+
+std::string CheckpointReader::readString()
+{
+    const uint64_t size = readU64();
+    if (size > buffer_.size() - offset_)
+    {
+        throw std::runtime_error("checkpoint is truncated");
+    }
+    std::string value = buffer_.substr(offset_, size);
+    offset_ += size;
+    return value;
+}
+
+bool CheckpointReader::isAtEnd() const
+{
+    return offset_ == buffer_.size();
+}
+
+} // namespace btf
@@ -46,6 +46,8 @@ std::string errorCodeToString(ErrorCodes code)
         return "source and target of stimulus are not equal";
     case ErrorCodes::amount_of_semaphore_accesses_invalid:
         return "amount of semaphore accesses is invalid.";
+    case ErrorCodes::hash_collision:
+        return "entity name has the same hash as another entity name";
     }
     FATAL_INTERNAL_ERROR_MSG("unknown error code");
 }
@@ -0,0 +1,516 @@
+/* compression.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifdef BTF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef BTF_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace btf
+{
+
+/// Size of the buffer for the compressed bytes.
+static constexpr size_t compressed_buffer_size{size_t{1} << 20U};
+
+/*!
+    @brief Decoder of a compression format.
+*/
+struct DecompressingInputSource::Decoder
+{
+    /// @brief Destructor of the class Decoder.
+    virtual ~Decoder() = default;
+
+    /*!
+        @brief Decodes compressed bytes. Throws a std::runtime_error if the data is invalid.
+        @param[in] input The compressed bytes.
+        @param[in] input_size The number of compressed bytes.
+        @param[out] output The buffer for the decoded bytes.
+        @param[in] output_size The size of the buffer.
+        @param[out] consumed The number of compressed bytes that were consumed.
+        @param[out] is_frame_complete True if the end of a gzip member or zstd frame was reached.
+        @return The number of decoded bytes.
+    */
+    virtual size_t decode(const char* input, size_t input_size, char* output, size_t output_size, size_t& consumed, bool& is_frame_complete) = 0;
+};
+
+#ifdef BTF_HAVE_ZLIB
+/*!
+    @brief Decoder of gzip members.
+*/
+struct GzipDecoder : DecompressingInputSource::Decoder
+{
+    /// @brief Constructor of the class GzipDecoder.
+    GzipDecoder()
+    {
+        // 16 + maximum window size: gzip header and trailer
+        if (inflateInit2(&stream_, 16 + MAX_WBITS) != Z_OK)
+        {
+            throw std::runtime_error("could not initialize zlib");
+        }
+    }
+
+    /// @brief Destructor of the class GzipDecoder.
+    ~GzipDecoder() override
+    {
+        inflateEnd(&stream_);
+    }
+
+    GzipDecoder(const GzipDecoder&) = delete;
+    GzipDecoder& operator=(const GzipDecoder&) = delete;
+
+    size_t decode(const char* input, size_t input_size, char* output, size_t output_size, size_t& consumed, bool& is_frame_complete) override
+    {
+        if (is_member_complete_)
+        {
+            // the next member of a concatenated file
+            inflateReset(&stream_);
+            is_member_complete_ = false;
+        }
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input)); // NOLINT
+        stream_.avail_in = static_cast<uInt>(std::min<size_t>(input_size, UINT32_MAX));
+        stream_.next_out = reinterpret_cast<Bytef*>(output); // NOLINT
+        stream_.avail_out = static_cast<uInt>(std::min<size_t>(output_size, UINT32_MAX));
+        const auto available_in = stream_.avail_in;
+        const auto available_out = stream_.avail_out;
+
+        const int ret = inflate(&stream_, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END)
+        {
+            is_member_complete_ = true;
+        }
+        else if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            throw std::runtime_error("invalid gzip data");
+        }
+        is_frame_complete = is_member_complete_;
+        consumed = available_in - stream_.avail_in;
+        return available_out - stream_.avail_out;
+    }
+
+    /// The zlib stream.
+    z_stream stream_{};
+
+    /// True if the end of the current member was reached.
+    bool is_member_complete_{false};
+};
+#endif
+
+#ifdef BTF_HAVE_ZSTD
+/*!
+    @brief Decoder of zstd frames.
+*/
+struct ZstdDecoder : DecompressingInputSource::Decoder
+{
+    /// @brief Constructor of the class ZstdDecoder.
+    ZstdDecoder() : stream_(ZSTD_createDStream())
+    {
+        if (stream_ == nullptr)
+        {
+            throw std::runtime_error("could not initialize zstd");
+        }
+        ZSTD_initDStream(stream_);
+    }
+
+    /// @brief Destructor of the class ZstdDecoder.
+    ~ZstdDecoder() override
+    {
+        ZSTD_freeDStream(stream_);
+    }
+
+    ZstdDecoder(const ZstdDecoder&) = delete;
+    ZstdDecoder& operator=(const ZstdDecoder&) = delete;
+
+    size_t decode(const char* input, size_t input_size, char* output, size_t output_size, size_t& consumed, bool& is_frame_complete) override
+    {
+        // a new frame is started automatically after the end of a frame
+        ZSTD_inBuffer in{input, input_size, 0};
+        ZSTD_outBuffer out{output, output_size, 0};
+        const size_t ret = ZSTD_decompressStream(stream_, &out, &in);
+        if (ZSTD_isError(ret) != 0)
+        {
+            throw std::runtime_error(std::string("invalid zstd data: ") + ZSTD_getErrorName(ret));
+        }
+        is_frame_complete = ret == 0;
+        consumed = in.pos;
+        return out.pos;
+    }
+
+    /// The zstd stream.
+    ZSTD_DStream* stream_;
+};
+#endif
+
+bool isCompressionSupported(Compressions compression)
+{
+    switch (compression)
+    {
+    case Compressions::none:
+        return true;
+    case Compressions::gzip:
+#ifdef BTF_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Compressions::zstd:
+#ifdef BTF_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+Compressions detectCompression(std::string_view first_bytes)
+{
+    if (first_bytes.size() >= 2 && first_bytes[0] == '\x1f' && first_bytes[1] == '\x8b')
+    {
+        return Compressions::gzip;
+    }
+    if (first_bytes.size() >= 4 && first_bytes.substr(0, 4) == std::string_view("\x28\xb5\x2f\xfd", 4))
+    {
+        return Compressions::zstd;
+    }
+    return Compressions::none;
+}
+
+DecompressingInputSource::DecompressingInputSource(std::unique_ptr<InputSource> source) : source_(std::move(source)), input_(compressed_buffer_size)
+{
+    // the magic bytes
+    while (input_end_ < 4)
+    {
+        const size_t n = source_->read(input_.data() + input_end_, input_.size() - input_end_);
+        if (n == 0)
+        {
+            break;
+        }
+        input_end_ += n;
+    }
+    compression_ = detectCompression(std::string_view(input_.data(), input_end_));
+    if (!isCompressionSupported(compression_))
+    {
+        throw std::runtime_error("the compression of " + source_->getName() + " is not supported by this build");
+    }
+
+    switch (compression_)
+    {
+#ifdef BTF_HAVE_ZLIB
+    case Compressions::gzip:
+        decoder_ = std::make_unique<GzipDecoder>();
+        break;
+#endif
+#ifdef BTF_HAVE_ZSTD
+    case Compressions::zstd:
+        decoder_ = std::make_unique<ZstdDecoder>();
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+DecompressingInputSource::~DecompressingInputSource() = default;
+
+size_t DecompressingInputSource::read(char* buffer, size_t size)
+{
+    if (decoder_ == nullptr)
+    {
+        // plain text: the bytes read for the detection first
+        if (input_begin_ < input_end_)
+        {
+            const size_t n = std::min(size, input_end_ - input_begin_);
+            std::memcpy(buffer, input_.data() + input_begin_, n);
+            input_begin_ += n;
+            return n;
+        }
+        return source_->read(buffer, size);
+    }
+
+    size_t produced{0};
+    while (produced < size)
+    {
+        if (input_begin_ == input_end_ && !fillInput())
+        {
+            if (!is_frame_complete_)
+            {
+                throw std::runtime_error(source_->getName() + " is truncated");
+            }
+            break;
+        }
+        size_t consumed{0};
+        produced += decoder_->decode(input_.data() + input_begin_, input_end_ - input_begin_, buffer + produced, size - produced, consumed,
+                                     is_frame_complete_);
+        input_begin_ += consumed;
+    }
+    return produced;
+}
+
+std::string DecompressingInputSource::getName() const
+{
+    return source_->getName();
+}
+
+Compressions DecompressingInputSource::getCompression() const
+{
+    return compression_;
+}
+
+bool DecompressingInputSource::fillInput()
+{
+    input_begin_ = 0;
+    input_end_ = source_->read(input_.data(), input_.size());
+    return input_end_ > 0;
+}
+
+std::string compressBlock(Compressions compression, std::string_view data)
+{
+    switch (compression)
+    {
+#ifdef BTF_HAVE_ZLIB
+    case Compressions::gzip: {
+        z_stream stream{};
+        // 16 + maximum window size: gzip header and trailer
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw std::runtime_error("could not initialize zlib");
+        }
+        std::string ret(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data())); // NOLINT
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_out = reinterpret_cast<Bytef*>(ret.data()); // NOLINT
+        stream.avail_out = static_cast<uInt>(ret.size());
+        const int result = deflate(&stream, Z_FINISH);
+        ret.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END)
+        {
+            throw std::runtime_error("could not compress block");
+        }
+        return ret;
+    }
+#endif
+#ifdef BTF_HAVE_ZSTD
+    case Compressions::zstd: {
+        std::string ret(ZSTD_compressBound(data.size()), '\0');
+        const size_t size = ZSTD_compress(ret.data(), ret.size(), data.data(), data.size(), 3);
+        if (ZSTD_isError(size) != 0)
+        {
+            throw std::runtime_error(std::string("could not compress block: ") + ZSTD_getErrorName(size));
+        }
+        ret.resize(size);
+        return ret;
+    }
+#endif
+    default:
+        break;
+    }
+    throw std::runtime_error("the compression is not supported by this build");
+}
+
+std::string getBlockTablePath(const std::string& path)
+{
+    return path + ".btfblk";
+}
+
+CompressedBlockWriter::CompressedBlockWriter(std::ostream& out, Compressions compression, size_t block_size, size_t number_of_threads)
+    : out_(out), compression_(compression), block_size_(std::max<size_t>(block_size, 1)),
+      number_of_threads_(number_of_threads != 0 ? number_of_threads : std::max(std::thread::hardware_concurrency(), 1U))
+{
+}
+
+void CompressedBlockWriter::write(std::string_view data)
+{
+    buffer_.append(data);
+    if (buffer_.size() >= block_size_)
+    {
+        flushBlock();
+    }
+}
+
+void CompressedBlockWriter::writeLine(std::string_view line, uint64_t time, bool is_comment)
+{
+    if (!is_comment)
+    {
+        if (!block_has_events_)
+        {
+            block_.first_time_ = time;
+            block_has_events_ = true;
+        }
+        block_.last_time_ = time;
+    }
+    buffer_.append(line);
+    buffer_.push_back('\n');
+    if (buffer_.size() >= block_size_)
+    {
+        flushBlock();
+    }
+}
+
+const std::vector<CompressedBlock>& CompressedBlockWriter::finish()
+{
+    flushBlock();
+    while (!pending_blocks_.empty())
+    {
+        writePendingBlock();
+    }
+    out_.flush();
+    return blocks_;
+}
+
+void CompressedBlockWriter::flushBlock()
+{
+    if (buffer_.empty())
+    {
+        return;
+    }
+    block_.uncompressed_offset_ = uncompressed_offset_;
+    block_.uncompressed_size_ = buffer_.size();
+    uncompressed_offset_ += buffer_.size();
+
+    // the blocks are compressed in parallel, at most number_of_threads_ at the same time
+    pending_blocks_.emplace_back(block_, std::async(std::launch::async, compressBlock, compression_, std::move(buffer_)));
+    buffer_.clear();
+    block_.first_time_ = block_.last_time_;
+    block_has_events_ = false;
+    while (pending_blocks_.size() > number_of_threads_)
+    {
+        writePendingBlock();
+    }
+}
+
+void CompressedBlockWriter::writePendingBlock()
+{
+    auto [block, future] = std::move(pending_blocks_.front());
+    pending_blocks_.pop_front();
+    const std::string data = future.get();
+    block.compressed_offset_ = compressed_offset_;
+    block.compressed_size_ = data.size();
+    compressed_offset_ += data.size();
+    out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    blocks_.push_back(block);
+}
+
+bool writeBlockTable(const std::string& path, Compressions compression, const std::vector<CompressedBlock>& blocks)
+{
+    std::ofstream out(getBlockTablePath(path));
+    const uint64_t file_size = blocks.empty() ? 0 : blocks.back().compressed_offset_ + blocks.back().compressed_size_;
+    out << "BTFBLK 1 " << static_cast<int>(compression) << ' ' << file_size << ' ' << blocks.size() << '\n';
+    for (const auto& b : blocks)
+    {
+        out << b.uncompressed_offset_ << ' ' << b.uncompressed_size_ << ' ' << b.compressed_offset_ << ' ' << b.compressed_size_ << ' '
+            << b.first_time_ << ' ' << b.last_time_ << '\n';
+    }
+    return out.good();
+}
+
+bool CompressedBtfFile::load(const std::string& path)
+{
+    path_ = path;
+    blocks_.clear();
+
+    std::ifstream in(getBlockTablePath(path));
+    std::string magic;
+    int version{0};
+    int compression{0};
+    uint64_t file_size{0};
+    size_t number_of_blocks{0};
+    if (!(in >> magic >> version >> compression >> file_size >> number_of_blocks) || magic != "BTFBLK" || version != 1)
+    {
+        return false;
+    }
+    compression_ = static_cast<Compressions>(compression);
+    for (size_t i = 0; i < number_of_blocks; ++i)
+    {
+        CompressedBlock b;
+        if (!(in >> b.uncompressed_offset_ >> b.uncompressed_size_ >> b.compressed_offset_ >> b.compressed_size_ >> b.first_time_ >> b.last_time_))
+        {
+            blocks_.clear();
+            return false;
+        }
+        blocks_.push_back(b);
+    }
+
+    // the table must belong to the file
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) != file_size || ec)
+    {
+        blocks_.clear();
+        return false;
+    }
+    return true;
+}
+
+Compressions CompressedBtfFile::getCompression() const
+{
+    return compression_;
+}
+
+const std::vector<CompressedBlock>& CompressedBtfFile::getBlocks() const
+{
+    return blocks_;
+}
+
+size_t CompressedBtfFile::findBlock(uint64_t time) const
+{
+    auto it = std::partition_point(blocks_.begin(), blocks_.end(), [time](const CompressedBlock& b) { return b.last_time_ < time; });
+    return static_cast<size_t>(std::distance(blocks_.begin(), it));
+}
+
+bool CompressedBtfFile::readBlock(size_t block, std::string& lines) const
+{
+    if (block >= blocks_.size())
+    {
+        return false;
+    }
+    const auto& b = blocks_[block];
+    std::ifstream file(path_, std::ios::binary);
+    std::string compressed(b.compressed_size_, '\0');
+    file.seekg(static_cast<std::streamoff>(b.compressed_offset_));
+    file.read(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+    if (static_cast<uint64_t>(file.gcount()) != b.compressed_size_)
+    {
+        return false;
+    }
+
+    try
+    {
+        DecompressingInputSource source(std::make_unique<MemoryInputSource>(compressed));
+        lines.resize(b.uncompressed_size_);
+        size_t size{0};
+        while (size < lines.size())
+        {
+            const size_t n = source.read(lines.data() + size, lines.size() - size);
+            if (n == 0)
+            {
+                break;
+            }
+            size += n;
+        }
+        return size == lines.size();
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+}
+
+} // namespace btf
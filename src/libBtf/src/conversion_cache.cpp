@@ -0,0 +1,293 @@
+/* conversion_cache.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/conversion_cache.h"
+
+#include "btf/checkpoint.h"
+#include "btf/entity_hash.h"
+#include "library_version.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace btf
+{
+
+/// Size of the blocks in which the input file is hashed.
+static constexpr size_t cache_block_size{size_t{1} << 20U};
+
+/// Name of the file of an entry that holds the number of output files and the import summary.
+static constexpr std::string_view cache_entry_file{"entry"};
+
+/// Permissions that are removed from a cached file when it is linked.
+static constexpr auto write_permissions{std::filesystem::perms::owner_write | std::filesystem::perms::group_write | std::filesystem::perms::others_write};
+
+/*!
+    @brief Writes the file of an entry, it uses the compact format of BtfFile::checkpoint().
+    @param[in] path The path of the file.
+    @param[in] number_of_files The number of output files of the entry.
+    @param[in] summary The summary of the import.
+    @return True if the file was written.
+*/
+static bool writeEntryFile(const std::string& path, size_t number_of_files, const ImportSummary& summary)
+{
+    CheckpointWriter out;
+    out.writeU64(number_of_files);
+    out.writeU64(summary.lines_);
+    out.writeU64(summary.rejected_lines_);
+    out.writeU64(summary.filtered_lines_);
+    out.writeU64(summary.categories_.size());
+    for (const auto& category : summary.categories_)
+    {
+        out.writeU64(static_cast<uint64_t>(category.issue_));
+        out.writeU64(static_cast<uint64_t>(category.type_));
+        out.writeU64(static_cast<uint64_t>(category.error_));
+        out.writeString(category.event_);
+        out.writeU64(category.count_);
+        out.writeU64(category.sample_lines_.size());
+        for (const auto& line : category.sample_lines_)
+        {
+            out.writeString(line);
+        }
+    }
+    return out.save(path);
+}
+
+/*!
+    @brief Reads the file of an entry, see writeEntryFile().
+    @param[in] path The path of the file.
+    @param[out] number_of_files The number of output files of the entry.
+    @param[out] summary The summary of the import.
+    @return False if the file cannot be read or is corrupted.
+*/
+static bool readEntryFile(const std::string& path, size_t& number_of_files, ImportSummary& summary)
+{
+    CheckpointReader in;
+    if (!in.load(path))
+    {
+        return false;
+    }
+    try
+    {
+        number_of_files = in.readU64();
+        summary.lines_ = in.readU64();
+        summary.rejected_lines_ = in.readU64();
+        summary.filtered_lines_ = in.readU64();
+        summary.categories_.resize(in.readCount());
+        for (auto& category : summary.categories_)
+        {
+            category.issue_ = static_cast<ImportIssues>(in.readU64());
+            category.type_ = static_cast<EntityTypes>(in.readU64());
+            category.error_ = static_cast<ErrorCodes>(in.readU64());
+            category.event_ = in.readString();
+            category.count_ = in.readU64();
+            category.sample_lines_.resize(in.readCount());
+            for (auto& line : category.sample_lines_)
+            {
+                line = in.readString();
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    return in.isAtEnd();
+}
+
+std::string getLibraryVersion()
+{
+    return BTF_LIBRARY_VERSION;
+}
+
+ConversionCache::ConversionCache(std::string directory, uint64_t max_size) : directory_(std::move(directory)), max_size_(max_size)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+}
+
+uint64_t ConversionCache::computeKey(const std::string& input_path, std::string_view options)
+{
+    std::ifstream in(input_path, std::ios::binary);
+    if (!in.good())
+    {
+        throw std::runtime_error("could not open file");
+    }
+
+    // every block is hashed on its own, the key is the hash of the block hashes, the size, the options and the library version
+    std::string block(cache_block_size, '\0');
+    std::string digest;
+    uint64_t size{0};
+    while (in.read(block.data(), static_cast<std::streamsize>(block.size())) || in.gcount() > 0)
+    {
+        const auto length = static_cast<size_t>(in.gcount());
+        size += length;
+        const auto hash = hashEntityName(std::string_view(block.data(), length));
+        for (size_t i = 0; i < sizeof(hash); ++i)
+        {
+            digest += static_cast<char>((hash >> (8U * i)) & 0xFFU);
+        }
+    }
+    digest += std::to_string(size);
+    digest += '\0';
+    digest += options;
+    digest += '\0';
+    digest += getLibraryVersion();
+    return hashEntityName(digest);
+}
+
+void ConversionCache::setLinkOutputs(bool value)
+{
+    is_linking_outputs_ = value;
+}
+
+bool ConversionCache::fetch(uint64_t key, const std::vector<std::string>& output_paths, ImportSummary& summary)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto entry = getEntryPath(key);
+    size_t number_of_files{0};
+    ImportSummary cached;
+    if (!readEntryFile((entry / cache_entry_file).string(), number_of_files, cached) || number_of_files != output_paths.size())
+    {
+        return false;
+    }
+
+    std::error_code error;
+    for (size_t i = 0; i < output_paths.size(); ++i)
+    {
+        const auto file = entry / std::to_string(i);
+
+        // the output is replaced, it may be a link to a cached file
+        std::filesystem::remove(output_paths[i], error);
+        if (is_linking_outputs_)
+        {
+            // the cached file is read-only, so it cannot be modified through a linked output
+            std::filesystem::permissions(file, write_permissions, std::filesystem::perm_options::remove, error);
+            std::filesystem::create_hard_link(file, output_paths[i], error);
+            if (!error)
+            {
+                continue;
+            }
+        }
+        if (!std::filesystem::copy_file(file, output_paths[i], error))
+        {
+            return false;
+        }
+        std::filesystem::permissions(output_paths[i], std::filesystem::perms::owner_write, std::filesystem::perm_options::add, error);
+    }
+
+    // the modification time of the entry is its last use
+    std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), error);
+    summary = cached;
+    return true;
+}
+
+bool ConversionCache::store(uint64_t key, const std::vector<std::string>& output_paths, const ImportSummary& summary)
+{
+    const auto entry = getEntryPath(key);
+    std::error_code error;
+    if (std::filesystem::exists(entry / cache_entry_file, error))
+    {
+        return true;
+    }
+
+    // the entry is written into a temporary directory, which is renamed when it is complete
+    static std::atomic<uint64_t> counter{0};
+    const auto temporary = entry.string() + ".tmp" + std::to_string(std::random_device{}()) + "_" + std::to_string(counter++);
+    bool is_complete = std::filesystem::create_directories(temporary, error);
+    for (size_t i = 0; i < output_paths.size() && is_complete; ++i)
+    {
+        is_complete = std::filesystem::copy_file(output_paths[i], std::filesystem::path(temporary) / std::to_string(i), error);
+    }
+    if (is_complete)
+    {
+        is_complete = writeEntryFile((std::filesystem::path(temporary) / cache_entry_file).string(), output_paths.size(), summary);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (is_complete)
+    {
+        std::filesystem::rename(temporary, entry, error);
+        is_complete = !error || std::filesystem::exists(entry / cache_entry_file, error);
+    }
+    std::filesystem::remove_all(temporary, error);
+    evict();
+    return is_complete;
+}
+
+uint64_t ConversionCache::getSize() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    uint64_t size{0};
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator it(directory_, error), end; !error && it != end; it.increment(error))
+    {
+        std::error_code file_error;
+        if (it->is_regular_file(file_error))
+        {
+            const auto file_size = it->file_size(file_error);
+            size += file_error ? 0 : file_size;
+        }
+    }
+    return size;
+}
+
+std::filesystem::path ConversionCache::getEntryPath(uint64_t key) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key;
+    return directory_ / name.str();
+}
+
+void ConversionCache::evict()
+{
+    if (max_size_ == 0)
+    {
+        return;
+    }
+
+    // size and last use of every complete entry
+    std::vector<std::tuple<std::filesystem::file_time_type, uint64_t, std::filesystem::path>> entries;
+    uint64_t total_size{0};
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory_, error), end; !error && it != end; it.increment(error))
+    {
+        std::error_code entry_error;
+        if (!it->is_directory(entry_error) || it->path().filename().string().find(".tmp") != std::string::npos)
+        {
+            continue;
+        }
+        uint64_t size{0};
+        for (std::filesystem::directory_iterator file(it->path(), entry_error), file_end; !entry_error && file != file_end; file.increment(entry_error))
+        {
+            const auto file_size = file->file_size(entry_error);
+            size += entry_error ? 0 : file_size;
+        }
+        total_size += size;
+        entries.emplace_back(std::filesystem::last_write_time(it->path(), entry_error), size, it->path());
+    }
+
+    std::sort(entries.begin(), entries.end());
+    for (const auto& [time, size, path] : entries)
+    {
+        if (total_size <= max_size_)
+        {
+            break;
+        }
+        std::filesystem::remove_all(path, error);
+        total_size -= size;
+    }
+}
+} // namespace btf
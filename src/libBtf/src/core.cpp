@@ -14,44 +14,53 @@ Core::Core(States state) : state_(state)
 {
 }
 
+/*!
+    @brief Builds the transition table of the core state machine.
+    @return The transition table.
+*/
+static constexpr StateTransitionTable<Core::States, Core::Events> makeCoreTransitionTable()
+{
+    StateTransitionTable<Core::States, Core::Events> table;
+    using S = Core::States;
+    using E = Core::Events;
+
+    // events without an effect on the state (e.g. set_frequence) are always accepted
+    table.setDefault(S::idle, ErrorCodes::success);
+    table.reject(S::idle, {E::idle}, ErrorCodes::already_in_state);
+    table.allow(S::idle, {E::execute}, S::execution);
+
+    table.setDefault(S::execution, ErrorCodes::success);
+    table.reject(S::execution, {E::execute}, ErrorCodes::already_in_state);
+    table.allow(S::execution, {E::idle}, S::idle);
+
+    table.setDefault(S::unknown, ErrorCodes::success);
+    table.allow(S::unknown, {E::execute}, S::execution);
+    table.allow(S::unknown, {E::idle}, S::idle);
+
+    return table;
+}
+
+/// The transition table of the core state machine.
+static constexpr auto core_transition_table = makeCoreTransitionTable();
+
 ErrorCodes Core::doStateTransition(Events core_event)
 {
-    switch (state_)
+    const auto& transition = core_transition_table.get(state_, core_event);
+    if (transition.result_ == ErrorCodes::success)
     {
-    case States::idle:
-        if (core_event == Events::idle)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else if (core_event == Events::execute)
-        {
-            state_ = States::execution;
-        }
-        break;
-    case States::execution:
-        if (core_event == Events::execute)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else if (core_event == Events::idle)
-        {
-            state_ = States::idle;
-        }
-        break;
-    case States::unknown:
-        if (core_event == Events::execute)
-        {
-            state_ = States::execution;
-        }
-        else if (core_event == Events::idle)
-        {
-            state_ = States::idle;
-        }
-        break;
-    default:
-        FATAL_INTERNAL_ERROR_MSG("unknown state")
+        state_ = transition.next_state_;
     }
-    return ErrorCodes::success;
+    return transition.result_;
+}
+
+const StateTransition<Core::States>& Core::getTransition(States state, Events ev)
+{
+    return core_transition_table.get(state, ev);
+}
+
+Core::States Core::getState() const
+{
+    return state_;
 }
 
 std::string Core::eventToString(Events ev)
@@ -0,0 +1,157 @@
+/* entity_hash.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/entity_hash.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace btf
+{
+
+/// The default secret of wyhash.
+static constexpr std::array<uint64_t, 4> wyhash_secret{0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+/*!
+    @brief Multiplies two 64-bit values into a 128-bit value.
+    @param[in,out] a The first factor, afterwards the lower 64 bits of the product.
+    @param[in,out] b The second factor, afterwards the upper 64 bits of the product.
+*/
+static inline void wyMultiply(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64U);
+#else
+    const uint64_t ha = a >> 32U;
+    const uint64_t hb = b >> 32U;
+    const uint64_t la = a & 0xffffffffULL;
+    const uint64_t lb = b & 0xffffffffULL;
+    const uint64_t rh = ha * hb;
+    const uint64_t rm0 = ha * lb;
+    const uint64_t rm1 = hb * la;
+    const uint64_t rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32U);
+    uint64_t c = static_cast<uint64_t>(t < rl);
+    const uint64_t lo = t + (rm1 << 32U);
+    c += static_cast<uint64_t>(lo < t);
+    a = lo;
+    b = rh + (rm0 >> 32U) + (rm1 >> 32U) + c;
+#endif
+}
+
+/*!
+    @brief Multiplies two 64-bit values and folds the 128-bit product.
+    @param[in] a The first factor.
+    @param[in] b The second factor.
+    @return The xor of the lower and upper 64 bits of the product.
+*/
+static inline uint64_t wyMix(uint64_t a, uint64_t b)
+{
+    wyMultiply(a, b);
+    return a ^ b;
+}
+
+/*!
+    @brief Reads 8 bytes as little endian value.
+    @param[in] p Pointer to the bytes.
+    @return The value.
+*/
+static inline uint64_t wyRead8(const unsigned char* p)
+{
+    uint64_t v{0};
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        v = ((v >> 56U) & 0xffULL) | ((v >> 40U) & 0xff00ULL) | ((v >> 24U) & 0xff0000ULL) | ((v >> 8U) & 0xff000000ULL) |
+            ((v << 8U) & 0xff00000000ULL) | ((v << 24U) & 0xff0000000000ULL) | ((v << 40U) & 0xff000000000000ULL) | (v << 56U);
+    }
+    return v;
+}
+
+/*!
+    @brief Reads 4 bytes as little endian value.
+    @param[in] p Pointer to the bytes.
+    @return The value.
+*/
+static inline uint64_t wyRead4(const unsigned char* p)
+{
+    uint32_t v{0};
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        v = ((v >> 24U) & 0xffU) | ((v >> 8U) & 0xff00U) | ((v << 8U) & 0xff0000U) | (v << 24U);
+    }
+    return v;
+}
+
+/*!
+    @brief Reads 1 to 3 bytes.
+    @param[in] p Pointer to the bytes.
+    @param[in] k The number of bytes.
+    @return The value.
+*/
+static inline uint64_t wyRead3(const unsigned char* p, size_t k)
+{
+    return (static_cast<uint64_t>(p[0]) << 16U) | (static_cast<uint64_t>(p[k >> 1U]) << 8U) | p[k - 1];
+}
+
+uint64_t hashEntityName(std::string_view name)
+{
+    const auto* p = reinterpret_cast<const unsigned char*>(name.data()); // NOLINT
+    const size_t len = name.size();
+    uint64_t seed = wyMix(wyhash_secret[0], wyhash_secret[1]);
+    uint64_t a{0};
+    uint64_t b{0};
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (wyRead4(p) << 32U) | wyRead4(p + ((len >> 3U) << 2U));
+            b = (wyRead4(p + len - 4) << 32U) | wyRead4(p + len - 4 - ((len >> 3U) << 2U));
+        }
+        else if (len > 0)
+        {
+            a = wyRead3(p, len);
+        }
+    }
+    else
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            uint64_t see1 = seed;
+            uint64_t see2 = seed;
+            do
+            {
+                seed = wyMix(wyRead8(p) ^ wyhash_secret[1], wyRead8(p + 8) ^ seed);
+                see1 = wyMix(wyRead8(p + 16) ^ wyhash_secret[2], wyRead8(p + 24) ^ see1);
+                see2 = wyMix(wyRead8(p + 32) ^ wyhash_secret[3], wyRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = wyMix(wyRead8(p) ^ wyhash_secret[1], wyRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyRead8(p + i - 16);
+        b = wyRead8(p + i - 8);
+    }
+    a ^= wyhash_secret[1];
+    b ^= seed;
+    wyMultiply(a, b);
+    return wyMix(a ^ wyhash_secret[0] ^ len, b ^ wyhash_secret[1]);
+}
+
+} // namespace btf
@@ -0,0 +1,127 @@
+/* import_diagnostics.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/import_diagnostics.h"
+
+#include <sstream>
+
+namespace btf
+{
+std::string importIssueToString(ImportIssues issue)
+{
+    switch (issue)
+    {
+    case ImportIssues::invalid_format:
+        return "invalid format";
+    case ImportIssues::invalid_number:
+        return "invalid number";
+    case ImportIssues::unknown_entity_type:
+        return "unknown entity type";
+    case ImportIssues::unknown_event:
+        return "unknown event";
+    case ImportIssues::invalid_migration:
+        return "invalid migration";
+    case ImportIssues::rejected_event:
+        return "rejected event";
+    }
+    FATAL_INTERNAL_ERROR_MSG("unknown import issue");
+}
+
+std::string ImportSummary::toString() const
+{
+    std::stringstream ret;
+    ret << "imported " << (lines_ - rejected_lines_ - filtered_lines_) << " of " << lines_ << " lines";
+    if (filtered_lines_ > 0)
+    {
+        ret << " (" << filtered_lines_ << " skipped by the import filter)";
+    }
+    for (const auto& c : categories_)
+    {
+        ret << "\n  " << c.count_ << "x " << importIssueToString(c.issue_);
+        if (c.type_ != EntityTypes::unknown)
+        {
+            ret << " [type: " << entityTypeToString(c.type_) << "]";
+        }
+        if (!c.event_.empty())
+        {
+            ret << " [event: " << c.event_ << "]";
+        }
+        if (c.error_ != ErrorCodes::success)
+        {
+            ret << ": " << errorCodeToString(c.error_);
+        }
+        for (const auto& l : c.sample_lines_)
+        {
+            ret << "\n    " << l;
+        }
+    }
+    return ret.str();
+}
+
+ImportDiagnostics::ImportDiagnostics(size_t max_samples_per_category) : max_samples_per_category_(max_samples_per_category)
+{
+}
+
+void ImportDiagnostics::countLine()
+{
+    ++summary_.lines_;
+}
+
+void ImportDiagnostics::countFilteredLine()
+{
+    ++summary_.filtered_lines_;
+}
+
+void ImportDiagnostics::record(ImportIssues issue, EntityTypes type, ErrorCodes error, std::string_view event, std::string_view line, bool is_rejected)
+{
+    if (is_rejected)
+    {
+        ++summary_.rejected_lines_;
+    }
+
+    const auto key = (static_cast<uint32_t>(issue) << 16U) | (static_cast<uint32_t>(type) << 8U) | static_cast<uint32_t>(error);
+    auto& bucket = buckets_[key];
+
+    // find the category of this event, too many distinct events are collected in the last category of the bucket
+    ImportDiagnosticsCategory* category{nullptr};
+    for (auto index : bucket)
+    {
+        if (summary_.categories_[index].event_ == event)
+        {
+            category = &summary_.categories_[index];
+            break;
+        }
+    }
+    if (category == nullptr)
+    {
+        if (bucket.size() < max_events_per_bucket_)
+        {
+            bucket.push_back(summary_.categories_.size());
+            summary_.categories_.push_back({issue, type, error, std::string(event), 0, {}});
+        }
+        else if (bucket.size() == max_events_per_bucket_)
+        {
+            bucket.push_back(summary_.categories_.size());
+            summary_.categories_.push_back({issue, type, error, "<other events>", 0, {}});
+        }
+        category = &summary_.categories_[bucket.back()];
+    }
+
+    ++category->count_;
+    if (category->sample_lines_.size() < max_samples_per_category_)
+    {
+        category->sample_lines_.emplace_back(line);
+    }
+}
+
+const ImportSummary& ImportDiagnostics::getSummary() const
+{
+    return summary_;
+}
+
+} // namespace btf
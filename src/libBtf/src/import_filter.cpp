@@ -0,0 +1,93 @@
+/* import_filter.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/import_filter.h"
+
+namespace btf
+{
+
+void ImportFilter::setEntityTypes(const std::vector<EntityTypes>& types)
+{
+    selected_types_ = 0;
+    for (auto type : types)
+    {
+        selected_types_ |= toBit(type);
+    }
+}
+
+void ImportFilter::addEntity(const std::string& name)
+{
+    entities_.insert(name);
+}
+
+void ImportFilter::setTimeWindow(uint64_t start_time, uint64_t end_time)
+{
+    start_time_ = start_time;
+    end_time_ = end_time;
+}
+
+void ImportFilter::setIncludeDependencies(bool include_dependencies)
+{
+    include_dependencies_ = include_dependencies;
+}
+
+bool ImportFilter::isActive() const
+{
+    return selected_types_ != std::numeric_limits<uint32_t>::max() || !entities_.empty() || start_time_ > 0 ||
+           end_time_ < std::numeric_limits<uint64_t>::max();
+}
+
+bool ImportFilter::acceptsType(EntityTypes type) const
+{
+    return (selected_types_ & toBit(type)) != 0 || isDependency(type);
+}
+
+bool ImportFilter::isDependency(EntityTypes type) const
+{
+    if (!include_dependencies_)
+    {
+        return false;
+    }
+
+    // entities that run within a process need the processes, processes need their cores
+    const uint32_t process_bound = toBit(EntityTypes::runnable) | toBit(EntityTypes::signal) | toBit(EntityTypes::os) | toBit(EntityTypes::stimulus) |
+                                   toBit(EntityTypes::scheduler) | toBit(EntityTypes::semaphore);
+    const uint32_t processes = toBit(EntityTypes::task) | toBit(EntityTypes::isr);
+    switch (type)
+    {
+    case EntityTypes::task:
+    case EntityTypes::isr:
+        return (selected_types_ & process_bound) != 0;
+    case EntityTypes::core:
+        return (selected_types_ & (process_bound | processes)) != 0;
+    default:
+        return false;
+    }
+}
+
+bool ImportFilter::acceptsTime(EntityTypes type, uint64_t time) const
+{
+    return time <= end_time_ && (time >= start_time_ || isDependency(type));
+}
+
+bool ImportFilter::acceptsEntities(EntityTypes type, std::string_view source, std::string_view target) const
+{
+    return entities_.empty() || isDependency(type) || entities_.find(source) != entities_.end() || entities_.find(target) != entities_.end();
+}
+
+uint64_t ImportFilter::getEndTime() const
+{
+    return end_time_;
+}
+
+uint32_t ImportFilter::toBit(EntityTypes type)
+{
+    return uint32_t{1} << static_cast<uint32_t>(type);
+}
+
+} // namespace btf
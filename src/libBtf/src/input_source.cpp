@@ -0,0 +1,250 @@
+/* input_source.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/input_source.h"
+
+#include "btf/compression.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace btf
+{
+
+FileInputSource::FileInputSource(std::string path) : path_(std::move(path)), file_(std::fopen(path_.c_str(), "rb"))
+{
+    if (file_ == nullptr)
+    {
+        throw std::runtime_error("could not open file");
+    }
+    // the blocks are large, so the data is read directly into them
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fileno(file_), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+FileInputSource::~FileInputSource()
+{
+    std::fclose(file_);
+}
+
+size_t FileInputSource::read(char* buffer, size_t size)
+{
+    const size_t ret = std::fread(buffer, 1, size, file_);
+    if (ret == 0 && std::ferror(file_) != 0)
+    {
+        throw std::runtime_error("could not read file");
+    }
+    return ret;
+}
+
+std::string FileInputSource::getName() const
+{
+    return path_;
+}
+
+FileDescriptorInputSource::FileDescriptorInputSource(int fd) : fd_(fd)
+{
+}
+
+size_t FileDescriptorInputSource::read(char* buffer, size_t size)
+{
+    while (true)
+    {
+#ifdef _WIN32
+        const auto ret = _read(fd_, buffer, static_cast<unsigned>(std::min<size_t>(size, 1U << 30U)));
+#else
+        const auto ret = ::read(fd_, buffer, size);
+#endif
+        if (ret >= 0)
+        {
+            return static_cast<size_t>(ret);
+        }
+        if (errno != EINTR)
+        {
+            throw std::runtime_error("could not read file descriptor");
+        }
+    }
+}
+
+std::string FileDescriptorInputSource::getName() const
+{
+    return fd_ == 0 ? "<stdin>" : "<fd " + std::to_string(fd_) + ">";
+}
+
+MemoryInputSource::MemoryInputSource(std::string_view data) : data_(data)
+{
+}
+
+size_t MemoryInputSource::read(char* buffer, size_t size)
+{
+    const size_t ret = std::min(size, data_.size());
+    std::memcpy(buffer, data_.data(), ret);
+    data_.remove_prefix(ret);
+    return ret;
+}
+
+std::string MemoryInputSource::getName() const
+{
+    return "<memory>";
+}
+
+std::unique_ptr<InputSource> openInputSource(const std::string& path)
+{
+    if (path == "-")
+    {
+#ifdef _WIN32
+        _setmode(0, 0x8000); // _O_BINARY
+#endif
+        return std::make_unique<DecompressingInputSource>(std::make_unique<FileDescriptorInputSource>(0));
+    }
+    return std::make_unique<DecompressingInputSource>(std::make_unique<FileInputSource>(path));
+}
+
+PrefetchReader::PrefetchReader(InputSource& source, size_t block_size, size_t number_of_blocks)
+    : source_(source), block_size_(std::max<size_t>(block_size, 1)), blocks_(std::max<size_t>(number_of_blocks, 2))
+{
+    for (auto& b : blocks_)
+    {
+        b.buffer_.resize(keep_capacity_ + block_size_);
+    }
+    thread_ = std::thread(&PrefetchReader::fill, this);
+}
+
+PrefetchReader::~PrefetchReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+bool PrefetchReader::next(std::string_view& block, size_t keep)
+{
+    const std::string_view kept = block.substr(block.size() - std::min(keep, block.size()));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    const size_t held = is_holding_block_ ? 1 : 0;
+    condition_.wait(lock, [this, held] { return number_of_filled_blocks_ > held || is_source_finished_; });
+
+    if (number_of_filled_blocks_ == held)
+    {
+        // end of the source, the kept bytes are copied before the block is released
+        overflow_ = std::string(kept);
+        block = overflow_;
+        number_of_filled_blocks_ -= held;
+        is_holding_block_ = false;
+        condition_.notify_all();
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        return false;
+    }
+
+    // the next block is not touched by the background thread until it is released
+    auto& next_block = blocks_[consume_index_];
+    lock.unlock();
+    if (kept.size() <= keep_capacity_)
+    {
+        char* data = next_block.buffer_.data() + keep_capacity_;
+        if (!kept.empty())
+        {
+            // kept.data() is null for an empty view, which memcpy does not allow even for zero bytes
+            std::memcpy(data - kept.size(), kept.data(), kept.size());
+        }
+        block = std::string_view(data - kept.size(), kept.size() + next_block.size_);
+    }
+    else
+    {
+        std::string joined;
+        joined.reserve(kept.size() + next_block.size_);
+        joined.append(kept);
+        joined.append(next_block.buffer_.data() + keep_capacity_, next_block.size_);
+        overflow_.swap(joined);
+        block = overflow_;
+    }
+    lock.lock();
+
+    number_of_filled_blocks_ -= held;
+    is_holding_block_ = true;
+    consume_index_ = (consume_index_ + 1) % blocks_.size();
+    condition_.notify_all();
+    return true;
+}
+
+void PrefetchReader::fill()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return number_of_filled_blocks_ < blocks_.size() || is_stopping_; });
+        if (is_stopping_)
+        {
+            return;
+        }
+        auto& b = blocks_[fill_index_];
+        lock.unlock();
+
+        // fill the whole block, pipes return less than requested
+        size_t size{0};
+        bool is_end{false};
+        std::exception_ptr error;
+        try
+        {
+            while (size < block_size_)
+            {
+                const size_t n = source_.read(b.buffer_.data() + keep_capacity_ + size, block_size_ - size);
+                if (n == 0)
+                {
+                    is_end = true;
+                    break;
+                }
+                size += n;
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+            is_end = true;
+        }
+
+        lock.lock();
+        b.size_ = size;
+        if (size > 0)
+        {
+            ++number_of_filled_blocks_;
+            fill_index_ = (fill_index_ + 1) % blocks_.size();
+        }
+        if (is_end)
+        {
+            is_source_finished_ = true;
+            error_ = error;
+        }
+        condition_.notify_all();
+        if (is_end)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace btf
@@ -0,0 +1,223 @@
+/* line_scanner.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/line_scanner.h"
+
+#include <bit>
+
+#if (defined(__x86_64__) || defined(__amd64__)) && (defined(__GNUC__) || defined(__clang__))
+#define BTF_LINE_SCANNER_X86_64
+#include <immintrin.h>
+#endif
+
+namespace btf
+{
+
+/*!
+    @brief Collects the lines of a block from the positions of the newlines and delimiters.
+*/
+class LineBuilder
+{
+  public:
+    /*!
+        @brief Constructor of the class LineBuilder.
+        @param[out] lines The lines.
+    */
+    explicit LineBuilder(std::vector<LineFields>& lines) : lines_(lines)
+    {
+        lines_.clear();
+    }
+
+    /*!
+        @brief Adds a delimiter of the current line.
+        @param[in] position The position of the delimiter in the block.
+    */
+    void delimiter(size_t position)
+    {
+        if (current_.number_of_delimiters_ < LineFields::max_delimiters_)
+        {
+            current_.delimiters_[current_.number_of_delimiters_++] = static_cast<uint32_t>(position - current_.offset_);
+        }
+    }
+
+    /*!
+        @brief Completes the current line.
+        @param[in] position The position of the newline in the block.
+    */
+    void newline(size_t position)
+    {
+        current_.size_ = position - current_.offset_;
+        lines_.push_back(current_);
+        current_.offset_ = position + 1;
+        current_.number_of_delimiters_ = 0;
+    }
+
+    /*!
+        @brief Adds the newlines and delimiters of a chunk.
+        @param[in] base The position of the chunk in the block.
+        @param[in] matches Bit mask of the newlines and delimiters in the chunk.
+        @param[in] newlines Bit mask of the newlines in the chunk.
+    */
+    void add(size_t base, uint32_t matches, uint32_t newlines)
+    {
+        while (matches != 0)
+        {
+            const auto bit = static_cast<unsigned>(std::countr_zero(matches));
+            if (((newlines >> bit) & 1U) != 0)
+            {
+                newline(base + bit);
+            }
+            else
+            {
+                delimiter(base + bit);
+            }
+            matches &= matches - 1;
+        }
+    }
+
+    /*!
+        @brief Gets the number of bytes of the completed lines.
+        @return The number of bytes.
+    */
+    size_t getConsumed() const
+    {
+        return current_.offset_;
+    }
+
+  private:
+    /// The completed lines.
+    std::vector<LineFields>& lines_;
+
+    /// The current line.
+    LineFields current_;
+};
+
+/*!
+    @brief Scans a range of a block one byte at a time.
+    @param[in] block The block.
+    @param[in] begin The first position.
+    @param[in] delimiter The delimiter of the fields.
+    @param[in,out] builder The builder of the lines.
+*/
+static void scanScalar(std::string_view block, size_t begin, char delimiter, LineBuilder& builder)
+{
+    for (size_t i = begin; i < block.size(); ++i)
+    {
+        if (block[i] == '\n')
+        {
+            builder.newline(i);
+        }
+        else if (block[i] == delimiter)
+        {
+            builder.delimiter(i);
+        }
+    }
+}
+
+#ifdef BTF_LINE_SCANNER_X86_64
+/*!
+    @brief Scans a block 16 bytes at a time, the rest is scanned one byte at a time.
+    @param[in] block The block.
+    @param[in] delimiter The delimiter of the fields.
+    @param[in,out] builder The builder of the lines.
+*/
+static void scanSse2(std::string_view block, char delimiter, LineBuilder& builder)
+{
+    const __m128i newline_vector = _mm_set1_epi8('\n');
+    const __m128i delimiter_vector = _mm_set1_epi8(delimiter);
+    size_t i = 0;
+    for (; i + 16 <= block.size(); i += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block.data() + i)); // NOLINT
+        const __m128i newlines = _mm_cmpeq_epi8(chunk, newline_vector);
+        const __m128i delimiters = _mm_cmpeq_epi8(chunk, delimiter_vector);
+        const auto matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(newlines, delimiters)));
+        if (matches != 0)
+        {
+            builder.add(i, matches, static_cast<uint32_t>(_mm_movemask_epi8(newlines)));
+        }
+    }
+    scanScalar(block, i, delimiter, builder);
+}
+
+/*!
+    @brief Scans a block 32 bytes at a time, the rest is scanned one byte at a time.
+    @param[in] block The block.
+    @param[in] delimiter The delimiter of the fields.
+    @param[in,out] builder The builder of the lines.
+*/
+__attribute__((target("avx2"))) static void scanAvx2(std::string_view block, char delimiter, LineBuilder& builder)
+{
+    const __m256i newline_vector = _mm256_set1_epi8('\n');
+    const __m256i delimiter_vector = _mm256_set1_epi8(delimiter);
+    size_t i = 0;
+    for (; i + 32 <= block.size(); i += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block.data() + i)); // NOLINT
+        const __m256i newlines = _mm256_cmpeq_epi8(chunk, newline_vector);
+        const __m256i delimiters = _mm256_cmpeq_epi8(chunk, delimiter_vector);
+        const auto matches = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(newlines, delimiters)));
+        if (matches != 0)
+        {
+            builder.add(i, matches, static_cast<uint32_t>(_mm256_movemask_epi8(newlines)));
+        }
+    }
+    scanScalar(block, i, delimiter, builder);
+}
+#endif
+
+LineScanners getBestLineScanner()
+{
+    static const LineScanners best = isLineScannerSupported(LineScanners::avx2)   ? LineScanners::avx2
+                                     : isLineScannerSupported(LineScanners::sse2) ? LineScanners::sse2
+                                                                                  : LineScanners::scalar;
+    return best;
+}
+
+bool isLineScannerSupported(LineScanners scanner)
+{
+    switch (scanner)
+    {
+    case LineScanners::scalar:
+        return true;
+#ifdef BTF_LINE_SCANNER_X86_64
+    case LineScanners::sse2:
+        // part of the x86-64 baseline
+        return true;
+    case LineScanners::avx2:
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+    case LineScanners::sse2:
+    case LineScanners::avx2:
+        return false;
+#endif
+    }
+    return false;
+}
+
+size_t scanLines(std::string_view block, char delimiter, std::vector<LineFields>& lines, LineScanners scanner)
+{
+    LineBuilder builder(lines);
+    switch (scanner)
+    {
+#ifdef BTF_LINE_SCANNER_X86_64
+    case LineScanners::avx2:
+        scanAvx2(block, delimiter, builder);
+        break;
+    case LineScanners::sse2:
+        scanSse2(block, delimiter, builder);
+        break;
+#endif
+    default:
+        scanScalar(block, 0, delimiter, builder);
+        break;
+    }
+    return builder.getConsumed();
+}
+
+} // namespace btf
@@ -0,0 +1,109 @@
+/* output_rotation.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/output_rotation.h"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace btf
+{
+
+/*!
+    @brief Splits a path into the part before the first extension of the file name and the extensions.
+    @param[in] path The path.
+    @return The path without extensions and the extensions (e.g. ".btf.gz").
+*/
+static std::pair<std::string, std::string> splitExtensions(const std::string& path)
+{
+    const auto separator = path.find_last_of("/\\");
+    const size_t name_begin = separator == std::string::npos ? 0 : separator + 1;
+    const auto dot = path.find('.', name_begin + 1);
+    if (dot == std::string::npos)
+    {
+        return {path, ".btf"};
+    }
+    return {path.substr(0, dot), path.substr(dot)};
+}
+
+bool OutputRotation::isActive() const
+{
+    return max_events_ > 0 || max_bytes_ > 0 || time_window_ > 0;
+}
+
+std::string getRotationPartPath(const std::string& path, size_t part)
+{
+    const auto [stem, extensions] = splitExtensions(path);
+    std::stringstream ret;
+    ret << stem << '.' << std::setw(3) << std::setfill('0') << part << extensions;
+    return ret.str();
+}
+
+std::string getRotationManifestPath(const std::string& path)
+{
+    return splitExtensions(path).first + ".manifest.json";
+}
+
+std::string getCoreSplitPath(const std::string& path, const std::string& core)
+{
+    const auto [stem, extensions] = splitExtensions(path);
+    std::string ret = stem + '.';
+    for (const auto c : core)
+    {
+        ret += std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '-' || c == '_' ? c : '_';
+    }
+    return ret + extensions;
+}
+
+/*!
+    @brief Escapes a string for a JSON string literal.
+    @param[in] value The string.
+    @return The escaped string (without quotes).
+*/
+static std::string escapeJson(const std::string& value)
+{
+    std::stringstream ret;
+    for (const auto c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            ret << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20U)
+        {
+            ret << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<unsigned>(static_cast<unsigned char>(c)) << std::dec;
+        }
+        else
+        {
+            ret << c;
+        }
+    }
+    return ret.str();
+}
+
+bool writeRotationManifest(const std::string& path, const std::vector<RotationPart>& parts)
+{
+    std::ofstream out(getRotationManifestPath(path));
+    out << "{\n  \"parts\": [";
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        const auto& p = parts[i];
+        // the parts are stored in the same directory as the manifest
+        const auto file_name = std::filesystem::path(p.path_).filename().string();
+        out << (i == 0 ? "\n" : ",\n") << "    {\"path\": \"" << escapeJson(file_name) << "\", \"events\": " << p.number_of_events_ << ", \"bytes\": " << p.size_
+            << ", \"first_time\": " << p.first_time_ << ", \"last_time\": " << p.last_time_ << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
+
+} // namespace btf
@@ -0,0 +1,970 @@
+/* parallel_import.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/btf.h"
+
+#include "helper/helper.h"
+
+#include <charconv>
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <tuple>
+
+using helper::logging::printWarning;
+
+namespace btf
+{
+
+/// Minimum size of a partition if the number of partitions is chosen automatically.
+static constexpr uint64_t min_partition_size{uint64_t{1} << 20U};
+
+/// Size of the blocks in which a partition is scanned for lines.
+static constexpr size_t partition_block_size{size_t{1} << 20U};
+
+/*!
+    @brief Reconciliation state of a task while a partition is stitched, see BtfFile::importFromFileParallel().
+*/
+struct TaskReconciliation
+{
+    /// True if the partition converts the events of the task exactly like a serial import, they are then taken over.
+    bool is_synced_{false};
+
+    /// True if the partition had an allocating, poll or run event of the task (the task then has no runnables without task anymore).
+    bool had_allocation_{false};
+
+    /// The core of the last allocation of the task in the partition.
+    size_t core_hash_{0};
+
+    /// True if the partition had runnable events of the task.
+    bool had_runnables_{false};
+
+    /// True if the task is in sync since before its first allocation, the runnables without task are then taken over as well.
+    bool is_without_task_taken_over_{false};
+
+    /// True if runnable events without task were taken over since the last assignment of the runnables without task.
+    bool has_buffered_runnables_{false};
+
+    /// True if runnable events without task were taken over.
+    bool had_runnables_without_task_{false};
+
+    /// The instances of the task that are alive (neither unknown nor terminated) in the partition.
+    std::unordered_set<uint64_t> live_instances_;
+};
+
+/*!
+    @brief Reconciliation state of a runnable instance of a partition while the partition is stitched.
+*/
+struct RunnableReconciliation
+{
+    /// True if the instance has an instance ID in the stitched BtfFile.
+    bool has_id_{false};
+
+    /// The instance ID in the stitched BtfFile, which is assigned in the order of a serial import.
+    uint64_t id_{0};
+
+    /// True if the last event of the instance was taken over, its state is then taken over at the end.
+    bool is_taken_over_{false};
+};
+
+/*!
+    @brief Gets a field of a line.
+    @param[in] line The line.
+    @param[in] delimiter The delimiter of the fields.
+    @param[in] field The index of the field.
+    @return The field, empty if the line has less fields.
+*/
+static std::string_view getField(std::string_view line, char delimiter, size_t field)
+{
+    size_t begin{0};
+    for (size_t i = 0; i < field; ++i)
+    {
+        begin = line.find(delimiter, begin);
+        if (begin == std::string_view::npos)
+        {
+            return {};
+        }
+        ++begin;
+    }
+    const auto end = line.find(delimiter, begin);
+    auto value = line.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+    if (!value.empty() && value.back() == '\r')
+    {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+/*!
+    @brief Checks if a BTF file may be split between two lines: the lines must be events with different timestamps, and an
+        enforced_migration event is never separated from its full_migration event.
+    @param[in] previous The line before the split.
+    @param[in] next The line after the split.
+    @param[in] delimiter The delimiter of the fields.
+    @return True if the file may be split.
+*/
+static bool isPartitionBoundary(std::string_view previous, std::string_view next, char delimiter)
+{
+    const auto getTime = [delimiter](std::string_view line, uint64_t& time) {
+        const auto field = getField(line, delimiter, 0);
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), time);
+        return !field.empty() && line[0] != '#' && ec == std::errc() && ptr == field.data() + field.size();
+    };
+    uint64_t previous_time{0};
+    uint64_t next_time{0};
+    return getTime(previous, previous_time) && getTime(next, next_time) && previous_time != next_time &&
+           getField(previous, delimiter, 6) != Process::eventToString(Process::Events::enforced_migration);
+}
+
+/*!
+    @brief Finds the offsets at which a BTF file is split into time partitions of about the same size.
+    @param[in] path The path of the BTF file.
+    @param[in] file_size The size of the file.
+    @param[in] number_of_partitions The number of partitions.
+    @param[in] delimiter The delimiter of the fields.
+    @return The ascending offsets of the partitions followed by the size of the file.
+*/
+static std::vector<uint64_t> findPartitionOffsets(const std::string& path, uint64_t file_size, size_t number_of_partitions, char delimiter)
+{
+    std::vector<uint64_t> offsets{0};
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    std::string previous;
+    for (size_t p = 1; p < number_of_partitions && in; ++p)
+    {
+        const uint64_t target = std::max(file_size / number_of_partitions * p, offsets.back());
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(target));
+
+        // skip the rest of the line at the target, then search the first boundary
+        if (!std::getline(in, line))
+        {
+            break;
+        }
+        uint64_t position = target + line.size() + 1;
+        bool has_previous{false};
+        while (std::getline(in, line))
+        {
+            if (has_previous && isPartitionBoundary(previous, line, delimiter))
+            {
+                if (position > offsets.back() && position < file_size)
+                {
+                    offsets.push_back(position);
+                }
+                break;
+            }
+            position += line.size() + 1;
+            previous.swap(line);
+            has_previous = true;
+        }
+    }
+    offsets.push_back(file_size);
+    return offsets;
+}
+
+/*!
+    @brief Reads a partition of a BTF file.
+    @param[in] path The path of the BTF file.
+    @param[in] begin The offset of the partition.
+    @param[in] end The end of the partition.
+    @return The lines of the partition, the last line ends with a newline.
+*/
+static std::string readPartition(const std::string& path, uint64_t begin, uint64_t end)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("could not open file");
+    }
+    std::string data(end - begin, '\0');
+    in.seekg(static_cast<std::streamoff>(begin));
+    in.read(data.data(), static_cast<std::streamsize>(data.size()));
+    data.resize(static_cast<size_t>(in.gcount()));
+    if (!data.empty() && data.back() != '\n')
+    {
+        data.push_back('\n');
+    }
+    return data;
+}
+
+/*!
+    @brief Checks if a task instance is alive, i.e. its state is neither unknown nor terminated.
+    @param[in] process The task instance.
+    @return True if the task instance is alive.
+*/
+static bool isAlive(const Process& process)
+{
+    return process.getState() != Process::States::unknown && !process.isTerminated();
+}
+
+/*!
+    @brief State of importFromFileParallel() that is carried from one stitched partition to the next.
+*/
+struct BtfFile::StitchState
+{
+    /// True if the state matches the BtfFile, it is collected again after a partition was imported serially.
+    bool is_valid_{false};
+
+    /// The tasks that had events in the previous partitions.
+    std::unordered_set<size_t> known_tasks_;
+
+    /// The alive instances of the known tasks.
+    std::unordered_map<size_t, std::unordered_set<uint64_t>> live_instances_;
+};
+
+ParallelImportSummary BtfFile::importFromFileParallel(const std::string& path, size_t number_of_partitions, char delimiter, size_t max_samples_per_category)
+{
+    ParallelImportSummary summary;
+
+    // the partitions start in unknown state: they can only be stitched if the file is split and nothing is generated across lines
+    std::error_code error;
+    const uint64_t file_size = path == "-" ? 0 : std::filesystem::file_size(path, error);
+    bool is_plain_file{false};
+    if (!error && file_size > 0)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::array<char, 4> magic{};
+        in.read(magic.data(), magic.size());
+        is_plain_file = detectCompression(std::string_view(magic.data(), static_cast<size_t>(in.gcount()))) == Compressions::none;
+    }
+    if (number_of_partitions == 0)
+    {
+        number_of_partitions = static_cast<size_t>(std::clamp<uint64_t>(file_size / min_partition_size, 1, std::max(1U, std::thread::hardware_concurrency())));
+    }
+    std::vector<uint64_t> offsets;
+    if (is_plain_file && number_of_partitions > 1 && btf_entries_.empty() && type_map_.empty() && !auto_generate_core_events_ && !auto_wait_resume_os_events_)
+    {
+        offsets = findPartitionOffsets(path, file_size, number_of_partitions, delimiter);
+    }
+    if (offsets.size() < 3)
+    {
+        summary.import_ = importFromFile(path, delimiter, max_samples_per_category);
+        return summary;
+    }
+    summary.partitions_ = offsets.size() - 1;
+
+    /*!
+        @brief A partition with the BtfFile it is converted by.
+    */
+    struct Partition
+    {
+        /// The lines of the partition.
+        std::string data_;
+
+        /// The BtfFile of the partition.
+        std::unique_ptr<BtfFile> file_;
+
+        /// The lines with their events.
+        std::vector<PartitionLine> lines_;
+
+        /// The summary of the import of the partition.
+        ImportSummary summary_;
+
+        /// True if the BtfFile of the partition rejected a generated event.
+        bool has_errors_{false};
+    };
+    std::vector<Partition> partitions(summary.partitions_);
+
+    // the first partition is imported into this BtfFile, the others are converted in parallel starting in unknown state
+    std::vector<std::future<void>> workers;
+    for (size_t p = 1; p < partitions.size(); ++p)
+    {
+        workers.push_back(std::async(std::launch::async, [&, p]() {
+            auto& partition = partitions[p];
+            partition.data_ = readPartition(path, offsets[p], offsets[p + 1]);
+            partition.file_ = std::make_unique<BtfFile>(path_, time_scale_, auto_suspend_parent_runnable_, source_is_core_, auto_generate_core_events_, auto_wait_resume_os_events_);
+            auto& file = *partition.file_;
+            file.ignore_multiple_task_releases_ = ignore_multiple_task_releases_;
+            file.hasher_ = hasher_;
+            file.error_sink_ = [&partition](ErrorCodes, const BtfEntry&, bool is_generated) { partition.has_errors_ = partition.has_errors_ || is_generated; };
+            file.auto_generate_events_ = false;
+            file.is_marking_entries_ = true;
+            ImportDiagnostics diagnostics(max_samples_per_category);
+            ImportState state;
+            file.importPartition(partition.data_, delimiter, diagnostics, state, &partition.lines_);
+            partition.summary_ = diagnostics.getSummary();
+        }));
+    }
+
+    // the errors are passed to the error sink at the end, so they are not reported twice if the file is imported again
+    std::vector<std::tuple<ErrorCodes, BtfEntry, bool>> errors;
+    const auto error_sink = error_sink_;
+
+    // restores the error sink and the auto generation of events also if reading or importing a partition throws
+    struct StateGuard
+    {
+        BtfFile& file_;
+        ErrorSink error_sink_;
+        ~StateGuard()
+        {
+            file_.error_sink_ = std::move(error_sink_);
+            file_.auto_generate_events_ = true;
+        }
+    } state_guard{*this, error_sink};
+
+    if (error_sink)
+    {
+        error_sink_ = [&errors](ErrorCodes error_code, const BtfEntry& rejected_entry, bool is_generated) {
+            errors.emplace_back(error_code, rejected_entry, is_generated);
+        };
+    }
+
+    auto_generate_events_ = false;
+    ImportDiagnostics diagnostics(max_samples_per_category);
+    ImportState state;
+    partitions[0].data_ = readPartition(path, offsets[0], offsets[1]);
+    importPartition(partitions[0].data_, delimiter, diagnostics, state, nullptr);
+    partitions[0].data_.clear();
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    // stitch the partitions in order
+    bool is_exact{true};
+    StitchState stitch_state;
+    for (size_t p = 1; p < partitions.size() && is_exact; ++p)
+    {
+        auto& partition = partitions[p];
+        auto& file = *partition.file_;
+        // rejected lines are replayed, problems that do not reject a line (e.g. an incomplete migration) are not. Runnables are
+        // only stitched if their source is a process: with a core as source, the runnables without task are keyed by the core
+        uint64_t problems{0};
+        for (const auto& category : partition.summary_.categories_)
+        {
+            problems += category.count_;
+        }
+        bool is_compatible = !partition.has_errors_ && !file.is_partition_unresolved_ && problems == partition.summary_.rejected_lines_ &&
+                             !(source_is_core_ && !file.runnables_.empty());
+        for (const auto& [hash, type] : file.type_map_)
+        {
+            const auto it = type_map_.find(hash);
+            is_compatible = is_compatible && (it == type_map_.end() || it->second == type);
+        }
+        for (const auto& [hash, name] : file.hash_map_)
+        {
+            const auto it = hash_map_.find(hash);
+            is_compatible = is_compatible && (it == hash_map_.end() || it->second == name);
+        }
+
+        if (is_compatible)
+        {
+            is_exact = mergePartition(file, partition.data_, partition.lines_, delimiter, diagnostics, state, stitch_state, summary);
+        }
+        else
+        {
+            importPartition(partition.data_, delimiter, diagnostics, state, nullptr);
+            ++summary.reimported_partitions_;
+            stitch_state.is_valid_ = false;
+        }
+        partition.file_.reset();
+        partition.data_.clear();
+        partition.data_.shrink_to_fit();
+        partition.lines_ = {};
+    }
+    error_sink_ = error_sink;
+
+    if (!is_exact)
+    {
+        // only inconsistent traces are not stitched exactly, they are imported again serially
+        auto custom_header_entries = std::move(custom_header_entries_);
+        clearState();
+        custom_header_entries_ = std::move(custom_header_entries);
+        last_time_ = 0;
+        did_task_allocation_event_happen_on_core_.clear();
+        summary.import_ = importFromFile(path, delimiter, max_samples_per_category);
+        summary.replayed_lines_ = 0;
+        summary.is_restarted_ = true;
+        return summary;
+    }
+
+    auto_generate_events_ = true;
+    for (const auto& [error_code, rejected_entry, is_generated] : errors)
+    {
+        error_sink_(error_code, rejected_entry, is_generated);
+    }
+
+    // one aggregated warning instead of one warning per faulty line
+    summary.import_ = diagnostics.getSummary();
+    if (!summary.import_.categories_.empty())
+    {
+        printWarning() << "Import of " << path << ": " << summary.import_.toString() << '\n';
+    }
+    return summary;
+}
+
+void BtfFile::importPartition(std::string_view data, char delimiter, ImportDiagnostics& diagnostics, ImportState& state, std::vector<PartitionLine>* partition_lines)
+{
+    std::vector<LineFields> lines;
+    std::string line;
+    size_t begin{0};
+    while (begin < data.size())
+    {
+        auto block = data.substr(begin, partition_block_size);
+        auto consumed = scanLines(block, delimiter, lines);
+        if (consumed == 0)
+        {
+            // the line is longer than a block
+            block = data.substr(begin, data.find('\n', begin) - begin + 1);
+            consumed = scanLines(block, delimiter, lines);
+        }
+
+        for (const auto& fields : lines)
+        {
+            line.assign(block, fields.offset_, fields.size_);
+            const bool was_empty = btf_entries_.empty();
+            const auto last_entry = was_empty ? btf_entries_.end() : std::prev(btf_entries_.end());
+            const auto number_of_entries = btf_entries_.size();
+            const auto rejected_lines = diagnostics.getSummary().rejected_lines_;
+            const auto type = importLine(line, fields, diagnostics, state);
+            if (partition_lines == nullptr)
+            {
+                continue;
+            }
+
+            PartitionLine partition_line;
+            partition_line.offset_ = begin + fields.offset_;
+            partition_line.size_ = fields.size_;
+            partition_line.type_ = type;
+            partition_line.is_rejected_ = diagnostics.getSummary().rejected_lines_ != rejected_lines;
+            partition_line.number_of_entries_ = btf_entries_.size() - number_of_entries;
+            partition_line.first_entry_ = was_empty ? btf_entries_.begin() : std::next(last_entry);
+            if (type == EntityTypes::task || type == EntityTypes::isr)
+            {
+                partition_line.entity_hash_ = hashName(getField(line, delimiter, 4));
+                partition_line.is_migration_start_ = state.is_waiting_for_full_migration_event_;
+            }
+            else if (type == EntityTypes::runnable)
+            {
+                partition_line.entity_hash_ = hashName(getField(line, delimiter, 1));
+            }
+            partition_lines->push_back(partition_line);
+        }
+        begin += consumed;
+    }
+}
+
+bool BtfFile::mergePartition(BtfFile& partition, std::string_view data, const std::vector<PartitionLine>& partition_lines, char delimiter,
+                             ImportDiagnostics& diagnostics, ImportState& state, StitchState& stitch_state, ParallelImportSummary& summary)
+{
+    hash_map_.insert(partition.hash_map_.begin(), partition.hash_map_.end());
+    type_map_.insert(partition.type_map_.begin(), partition.type_map_.end());
+
+    // tasks that are known from the previous partitions depend on the state at the partition start: their events are replayed
+    // until no instance of the task is alive, from then on the partition converts the task exactly like a serial import
+    auto& known_tasks = stitch_state.known_tasks_;
+    auto& live_instances = stitch_state.live_instances_;
+    if (!stitch_state.is_valid_)
+    {
+        known_tasks.clear();
+        live_instances.clear();
+        for (const auto& [task_id, process] : tasks_)
+        {
+            known_tasks.insert(task_id.first);
+            if (isAlive(process))
+            {
+                live_instances[task_id.first].insert(task_id.second);
+            }
+        }
+        for (const auto& [task_id, stack] : runnable_stacks_)
+        {
+            known_tasks.insert(task_id.first);
+        }
+        for (const auto& [hash, did_occur] : did_de_allocated_task_event_occurred_on_core_)
+        {
+            if (did_occur)
+            {
+                known_tasks.insert(hash);
+            }
+        }
+        for (const auto& [task, core] : task_core_map_)
+        {
+            known_tasks.insert(hashName(task));
+        }
+        for (const auto& [hash, stack] : runnable_without_task_stacks_)
+        {
+            if (!stack.empty())
+            {
+                known_tasks.insert(hash);
+            }
+        }
+        for (const auto& [hash, buffer] : runnable_without_task_buffers_)
+        {
+            if (!buffer.empty())
+            {
+                known_tasks.insert(hash);
+            }
+        }
+        stitch_state.is_valid_ = true;
+    }
+
+    std::unordered_map<size_t, TaskReconciliation> tasks;
+    const auto getTask = [this, &tasks, &known_tasks](size_t task_hash) -> TaskReconciliation& {
+        auto [it, is_new] = tasks.try_emplace(task_hash);
+        if (is_new)
+        {
+            it->second.is_synced_ = known_tasks.count(task_hash) == 0;
+            it->second.is_without_task_taken_over_ = it->second.is_synced_ && !source_is_core_;
+        }
+        return it->second;
+    };
+
+    // the runnable instance IDs of the partition are replaced by the IDs of this BtfFile
+    std::unordered_map<std::pair<size_t, uint64_t>, RunnableReconciliation, PairHash> runnables;
+    runnables.reserve(partition.runnables_.size());
+
+    // true if the last event of a task or runnable instance of the partition was taken over, its state is then taken over at the end
+    std::unordered_map<std::pair<size_t, uint64_t>, bool, PairHash> is_task_taken_over;
+    is_task_taken_over.reserve(partition.tasks_.size());
+    tasks_.reserve(tasks_.size() + partition.tasks_.size());
+    runnables_.reserve(runnables_.size() + partition.runnables_.size());
+
+    const auto getMarks = [&partition](const BtfEntry& entry) -> uint8_t {
+        const auto it = partition.entry_marks_.find(&entry);
+        return it == partition.entry_marks_.end() ? 0 : it->second;
+    };
+
+    const auto takeOver = [&](const PartitionLine& partition_line) {
+        auto it = partition_line.first_entry_;
+        for (size_t i = 0; i < partition_line.number_of_entries_; ++i)
+        {
+            auto entry = it++;
+            if (entry->type_ == EntityTypes::runnable)
+            {
+                auto& runnable = runnables[std::make_pair(entry->target_hash_, entry->target_instance_)];
+                if (!runnable.has_id_)
+                {
+                    if ((getMarks(*entry) & new_runnable_instance) == 0)
+                    {
+                        return false;
+                    }
+                    runnable.has_id_ = true;
+                    runnable.id_ = runnable_instance_id_counters_[entry->target_hash_]++;
+                }
+                entry->target_instance_ = runnable.id_;
+                runnable.is_taken_over_ = true;
+            }
+            btf_entries_.splice(btf_entries_.end(), partition.btf_entries_, entry);
+            if (entry->type_ != EntityTypes::comment)
+            {
+                if (entry->time_ < last_time_)
+                {
+                    return false;
+                }
+                last_time_ = entry->time_;
+                indexLastEvent(getIndexedEntity(*entry));
+            }
+        }
+        return true;
+    };
+
+    std::vector<LineFields> fields;
+    std::string line;
+    const auto replay = [&](const PartitionLine& partition_line) {
+        auto it = partition_line.first_entry_;
+        for (size_t i = 0; i < partition_line.number_of_entries_; ++i, ++it)
+        {
+            if (it->type_ == EntityTypes::runnable)
+            {
+                runnables[std::make_pair(it->target_hash_, it->target_instance_)].is_taken_over_ = false;
+            }
+        }
+        scanLines(data.substr(partition_line.offset_, partition_line.size_ + 1), delimiter, fields);
+        line.assign(data, partition_line.offset_, partition_line.size_);
+        importLine(line, fields.front(), diagnostics, state);
+        ++summary.replayed_lines_;
+    };
+
+    // an instance the partition sees first must be unknown here, e.g. not terminated before the partition
+    const auto isNewInstance = [this, &is_task_taken_over](std::pair<size_t, uint64_t> task_id) {
+        if (is_task_taken_over.count(task_id) > 0)
+        {
+            return true;
+        }
+        const auto it = tasks_.find(task_id);
+        return it == tasks_.end() || it->second.getState() == Process::States::unknown;
+    };
+
+    const auto isEmptyWithoutTask = [](const BtfFile& file, size_t hash, bool is_stack_checked = true) {
+        const auto stack = file.runnable_without_task_stacks_.find(hash);
+        const auto buffer = file.runnable_without_task_buffers_.find(hash);
+        return (!is_stack_checked || stack == file.runnable_without_task_stacks_.end() || stack->second.empty()) &&
+               (buffer == file.runnable_without_task_buffers_.end() || buffer->second.empty());
+    };
+
+    // the task a runnable event is assigned to here, see emitRunnableEvent()
+    const auto getRunningTask = [this](size_t owner_hash, bool& is_pre_task) {
+        const auto owner = hash_map_.find(owner_hash);
+        if (owner == hash_map_.end())
+        {
+            // the name was not registered, because the partition rejected the line
+            is_pre_task = true;
+            return no_running_task_;
+        }
+        auto& core = task_core_map_[owner->second];
+        is_pre_task = !did_de_allocated_task_event_occurred_on_core_[owner_hash];
+        return is_pre_task ? no_running_task_ : current_running_tasks_[hashName(core)];
+    };
+
+    for (const auto& partition_line : partition_lines)
+    {
+        if (partition_line.is_rejected_)
+        {
+            // the partition did not change its state for the line, it is replayed if it only changes tasks that are not in sync
+            if (partition_line.type_ == EntityTypes::task || partition_line.type_ == EntityTypes::isr)
+            {
+                if (getTask(partition_line.entity_hash_).is_synced_)
+                {
+                    return false;
+                }
+            }
+            else if (partition_line.type_ == EntityTypes::runnable)
+            {
+                auto& owner = getTask(partition_line.entity_hash_);
+                owner.had_runnables_ = true;
+                bool is_pre_task_here{false};
+                const auto source_here = getRunningTask(partition_line.entity_hash_, is_pre_task_here);
+                if (is_pre_task_here ? owner.is_synced_ : source_here != no_running_task_ && getTask(source_here.first).is_synced_)
+                {
+                    return false;
+                }
+            }
+            replay(partition_line);
+            continue;
+        }
+
+        switch (partition_line.type_)
+        {
+        case EntityTypes::unknown:
+            break;
+        case EntityTypes::comment:
+            takeOver(partition_line);
+            break;
+        case EntityTypes::task:
+        case EntityTypes::isr: {
+            auto& task = getTask(partition_line.entity_hash_);
+
+            // the task event of the line, the other events are runnable events generated at a (de)allocation
+            auto main_entry = partition_line.first_entry_;
+            size_t i{0};
+            while (i < partition_line.number_of_entries_ && (getMarks(*main_entry) & generated_entry) != 0)
+            {
+                ++main_entry;
+                ++i;
+            }
+            if (i == partition_line.number_of_entries_)
+            {
+                // an enforced_migration event or an ignored release
+                if (!task.is_synced_)
+                {
+                    replay(partition_line);
+                }
+                else if (!partition_line.is_migration_start_)
+                {
+                    const auto source_hash = hashName(getField(data.substr(partition_line.offset_, partition_line.size_), delimiter, 1));
+                    uint64_t instance{0};
+                    const auto instance_field = getField(data.substr(partition_line.offset_, partition_line.size_), delimiter, 5);
+                    std::from_chars(instance_field.data(), instance_field.data() + instance_field.size(), instance);
+                    if (checkCoreAllocation(source_hash, {partition_line.entity_hash_, instance}, Process::Events::release) != ErrorCodes::success)
+                    {
+                        return false;
+                    }
+                    diagnostics.countLine();
+                }
+                else
+                {
+                    diagnostics.countLine();
+                }
+                break;
+            }
+
+            const auto process_event = main_entry->event_.process_event;
+            const auto source_hash = main_entry->source_hash_;
+            const auto task_id = std::make_pair(main_entry->target_hash_, main_entry->target_instance_);
+            if (process_event == Process::Events::enforced_migration)
+            {
+                if (!task.is_synced_)
+                {
+                    replay(partition_line);
+                    break;
+                }
+                // the task must not be running here either
+                for (const auto& [core, running_task] : current_running_tasks_)
+                {
+                    if (running_task == task_id)
+                    {
+                        return false;
+                    }
+                }
+                if (!isNewInstance(task_id) || !takeOver(partition_line))
+                {
+                    return false;
+                }
+                diagnostics.countLine();
+                break;
+            }
+
+            // follow the state of the partition, see trackDeAllocation()
+            if (process_event == Process::Events::poll || process_event == Process::Events::run || Process::isEventAllocatingCore(process_event))
+            {
+                if (!task.had_allocation_ || Process::isEventAllocatingCore(process_event))
+                {
+                    task.core_hash_ = source_hash;
+                }
+                task.had_allocation_ = true;
+            }
+            const bool is_new_instance = is_task_taken_over.count(task_id) == 0;
+            if (process_event == Process::Events::terminate)
+            {
+                task.live_instances_.erase(task_id.second);
+            }
+            else if (process_event != Process::Events::mtalimitexceeded || is_new_instance)
+            {
+                task.live_instances_.insert(task_id.second);
+            }
+
+            if (task.is_synced_)
+            {
+                // the checks and the core allocation depend on all tasks: they are done on the state of this BtfFile
+                if (!isNewInstance(task_id) || checkCoreAllocation(source_hash, task_id, process_event) != ErrorCodes::success)
+                {
+                    return false;
+                }
+                const bool was_first_de_alloc = trackDeAllocation(source_hash, task_id, process_event);
+                const bool was_first_de_alloc_there = (getMarks(*main_entry) & first_de_allocation) != 0;
+                if (was_first_de_alloc || was_first_de_alloc_there)
+                {
+                    // the runnables without task are assigned to the task: the assignment of the partition is only taken over if
+                    // both sides assign the same runnables, except for a stack that a terminate event erases right away
+                    const bool is_stack_checked = process_event != Process::Events::terminate;
+                    bool is_same_assignment{false};
+                    if (task.is_without_task_taken_over_)
+                    {
+                        // the runnables without task are those of the partition, this BtfFile has none
+                        is_same_assignment = was_first_de_alloc_there &&
+                                             (was_first_de_alloc || (!task.has_buffered_runnables_ && (!is_stack_checked || !task.had_runnables_without_task_)));
+                    }
+                    else
+                    {
+                        const auto key = source_is_core_ ? source_hash : task_id.first;
+                        is_same_assignment = isEmptyWithoutTask(*this, key, is_stack_checked) && isEmptyWithoutTask(partition, key, is_stack_checked);
+                    }
+                    if (!is_same_assignment)
+                    {
+                        return false;
+                    }
+                    task.has_buffered_runnables_ = false;
+                }
+                if (Process::getSourceType(process_event) == EntityTypes::stimulus)
+                {
+                    main_entry->source_instance_ = stimuli_instance_ids_map_[source_hash];
+                }
+                is_task_taken_over[task_id] = true;
+                if (!takeOver(partition_line))
+                {
+                    return false;
+                }
+                diagnostics.countLine();
+                break;
+            }
+
+            const auto number_of_entries = btf_entries_.size();
+            replay(partition_line);
+            is_task_taken_over[task_id] = false;
+            auto& live = live_instances[task_id.first];
+            const auto process = tasks_.find(task_id);
+            if (process != tasks_.end() && isAlive(process->second))
+            {
+                live.insert(task_id.second);
+            }
+            else
+            {
+                live.erase(task_id.second);
+            }
+
+            // in sync if no instance is alive on both sides and the runnables of the task are assigned the same way: to the same
+            // core, or without task on both sides (then there must be no runnables without task yet)
+            if (btf_entries_.size() != number_of_entries && live.empty() && task.live_instances_.empty())
+            {
+                bool is_synced{true};
+                if (!source_is_core_)
+                {
+                    const auto did_occur = did_de_allocated_task_event_occurred_on_core_.find(task_id.first);
+                    const bool had_allocation_here = did_occur != did_de_allocated_task_event_occurred_on_core_.end() && did_occur->second;
+                    if (task.had_allocation_ != had_allocation_here)
+                    {
+                        is_synced = false;
+                    }
+                    else if (had_allocation_here)
+                    {
+                        const auto core = task_core_map_.find(hash_map_.at(task_id.first));
+                        const auto core_name = hash_map_.find(task.core_hash_);
+                        is_synced = core != task_core_map_.end() && core_name != hash_map_.end() && core->second == core_name->second;
+                    }
+                    else
+                    {
+                        is_synced = !task.had_runnables_ && isEmptyWithoutTask(*this, task_id.first);
+                        task.is_without_task_taken_over_ = is_synced;
+                    }
+                }
+                task.is_synced_ = is_synced;
+            }
+            break;
+        }
+        case EntityTypes::runnable: {
+            auto& owner = getTask(partition_line.entity_hash_);
+            owner.had_runnables_ = true;
+            auto main_entry = std::next(partition_line.first_entry_, static_cast<std::ptrdiff_t>(partition_line.number_of_entries_ - 1));
+
+            // the task the runnable event is assigned to in the partition and here, see emitRunnableEvent()
+            const bool is_pre_task_there = !owner.had_allocation_;
+            const auto source_there = std::make_pair(main_entry->source_hash_, main_entry->source_instance_);
+            bool is_pre_task_here{false};
+            const auto source_here = getRunningTask(partition_line.entity_hash_, is_pre_task_here);
+
+            bool is_taken_over{false};
+            if (is_pre_task_here && is_pre_task_there)
+            {
+                is_taken_over = owner.is_synced_;
+                owner.has_buffered_runnables_ = owner.has_buffered_runnables_ || is_taken_over;
+                owner.had_runnables_without_task_ = owner.had_runnables_without_task_ || is_taken_over;
+            }
+            else if (!is_pre_task_here && !is_pre_task_there && source_here == source_there)
+            {
+                is_taken_over = source_here != no_running_task_ && getTask(source_here.first).is_synced_;
+            }
+            else if (owner.is_synced_ || (!is_pre_task_there && getTask(source_there.first).is_synced_) ||
+                     (!is_pre_task_here && source_here != no_running_task_ && getTask(source_here.first).is_synced_))
+            {
+                // the event changes the runnables of a task in sync on one side only
+                return false;
+            }
+
+            if (is_taken_over)
+            {
+                if (!takeOver(partition_line))
+                {
+                    return false;
+                }
+                diagnostics.countLine();
+            }
+            else
+            {
+                replay(partition_line);
+            }
+            break;
+        }
+        default:
+            // events of the other entities only depend on the state here
+            replay(partition_line);
+            break;
+        }
+    }
+
+    // take over the state of the task and runnable instances whose last event was taken over
+    const auto mapRunnables = [&runnables](const std::vector<std::pair<size_t, uint64_t>>& stack, std::vector<std::pair<size_t, uint64_t>>& mapped) {
+        mapped.clear();
+        for (const auto& runnable_id : stack)
+        {
+            const auto runnable = runnables.find(runnable_id);
+            if (runnable == runnables.end() || !runnable->second.has_id_)
+            {
+                return false;
+            }
+            mapped.emplace_back(runnable_id.first, runnable->second.id_);
+        }
+        return true;
+    };
+    std::vector<std::pair<size_t, uint64_t>> mapped;
+    for (const auto& [task_id, is_taken_over] : is_task_taken_over)
+    {
+        if (!is_taken_over)
+        {
+            continue;
+        }
+        auto process = partition.tasks_.extract(task_id);
+        if (isAlive(process.mapped()))
+        {
+            live_instances[task_id.first].insert(task_id.second);
+        }
+        else
+        {
+            live_instances[task_id.first].erase(task_id.second);
+        }
+        if (const auto it = tasks_.find(task_id); it != tasks_.end())
+        {
+            it->second = process.mapped();
+        }
+        else
+        {
+            tasks_.insert(std::move(process));
+        }
+        const auto stack = partition.runnable_stacks_.find(task_id);
+        if (stack == partition.runnable_stacks_.end())
+        {
+            runnable_stacks_.erase(task_id);
+        }
+        else
+        {
+            if (!mapRunnables(stack->second, mapped))
+            {
+                return false;
+            }
+            runnable_stacks_[task_id] = mapped;
+        }
+    }
+    for (const auto& [runnable_id, runnable] : runnables)
+    {
+        if (runnable.is_taken_over_)
+        {
+            auto state = partition.runnables_.extract(runnable_id);
+            state.key().second = runnable.id_;
+            if (const auto it = runnables_.find(state.key()); it != runnables_.end())
+            {
+                it->second = state.mapped();
+            }
+            else
+            {
+                runnables_.insert(std::move(state));
+            }
+        }
+    }
+    for (const auto& [task_hash, task] : tasks)
+    {
+        if (!task.is_synced_ || !task.is_without_task_taken_over_)
+        {
+            continue;
+        }
+        const auto stack = partition.runnable_without_task_stacks_.find(task_hash);
+        if (stack != partition.runnable_without_task_stacks_.end() && !stack->second.empty())
+        {
+            if (!mapRunnables(stack->second, mapped))
+            {
+                return false;
+            }
+            runnable_without_task_stacks_[task_hash] = mapped;
+        }
+        const auto buffer = partition.runnable_without_task_buffers_.find(task_hash);
+        if (buffer != partition.runnable_without_task_buffers_.end() && !buffer->second.empty())
+        {
+            // the events were moved to this BtfFile, the iterators stay valid
+            auto& own_buffer = runnable_without_task_buffers_[task_hash];
+            own_buffer.insert(own_buffer.end(), buffer->second.begin(), buffer->second.end());
+        }
+    }
+    last_time_ = std::max(last_time_, partition.last_time_);
+
+    // the tasks of the partition are known to the next partitions
+    for (const auto& [task_hash, task] : tasks)
+    {
+        known_tasks.insert(task_hash);
+    }
+    return true;
+}
+
+} // namespace btf
@@ -17,178 +17,88 @@ Process::Process(States state) : state_(state)
 {
 }
 
+/*!
+    @brief Builds the transition table of the process state machine.
+    @return The transition table.
+*/
+static constexpr StateTransitionTable<Process::States, Process::Events> makeProcessTransitionTable()
+{
+    StateTransitionTable<Process::States, Process::Events> table;
+    using S = Process::States;
+    using E = Process::Events;
+
+    table.setDefault(S::running, ErrorCodes::invalid_state_transition);
+    table.allow(S::running, {E::wait}, S::waiting);
+    table.allow(S::running, {E::poll}, S::polling);
+    table.allow(S::running, {E::preempt}, S::ready);
+    table.allow(S::running, {E::terminate}, S::terminated);
+    table.allow(S::running, {E::nowait}, S::running); // no transition
+    table.reject(S::running, {E::start, E::resume, E::run}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::polling, ErrorCodes::invalid_state_transition);
+    table.allow(S::polling, {E::run}, S::running);
+    table.allow(S::polling, {E::park}, S::parking);
+    table.reject(S::polling, {E::poll_parking, E::poll}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::waiting, ErrorCodes::invalid_state_transition);
+    table.allow(S::waiting, {E::release}, S::ready);
+    table.reject(S::waiting, {E::wait}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::parking, ErrorCodes::invalid_state_transition);
+    table.allow(S::parking, {E::poll_parking}, S::polling);
+    table.allow(S::parking, {E::release_parking}, S::ready);
+    table.reject(S::parking, {E::park}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::ready, ErrorCodes::invalid_state_transition);
+    table.allow(S::ready, {E::resume}, S::running);
+    table.reject(S::ready, {E::preempt, E::release, E::release_parking}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::active, ErrorCodes::invalid_state_transition);
+    table.allow(S::active, {E::start}, S::running, true);
+    table.allow(S::active, {E::interrupt_suspended}, S::active);
+    table.reject(S::active, {E::activate}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::terminated, ErrorCodes::invalid_state_transition);
+    table.allow(S::terminated, {E::activate}, S::active);
+    table.allow(S::terminated, {E::mtalimitexceeded}, S::terminated);
+    table.reject(S::terminated, {E::terminate}, ErrorCodes::already_in_state);
+
+    // the first event of a process defines its state, all other events are accepted without transition
+    table.setDefault(S::unknown, ErrorCodes::success);
+    table.allow(S::unknown, {E::activate, E::mtalimitexceeded}, S::active);
+    table.allow(S::unknown, {E::start}, S::running, true);
+    table.allow(S::unknown, {E::resume, E::run}, S::running);
+    table.allow(S::unknown, {E::poll, E::poll_parking}, S::polling);
+    table.allow(S::unknown, {E::park}, S::parking);
+    table.allow(S::unknown, {E::release_parking, E::preempt, E::release}, S::ready);
+    table.allow(S::unknown, {E::wait}, S::waiting);
+    table.allow(S::unknown, {E::terminate}, S::terminated);
+
+    return table;
+}
+
+/// The transition table of the process state machine.
+static constexpr auto process_transition_table = makeProcessTransitionTable();
+
 ErrorCodes Process::doStateTransition(Events ev)
 {
-    switch (state_)
+    const auto& transition = process_transition_table.get(state_, ev);
+    if (transition.result_ == ErrorCodes::success)
     {
-    case States::running:
-        if (ev == Events::wait)
-        {
-            state_ = States::waiting;
-        }
-        else if (ev == Events::poll)
-        {
-            state_ = States::polling;
-        }
-        else if (ev == Events::preempt)
-        {
-            state_ = States::ready;
-        }
-        else if (ev == Events::terminate)
-        {
-            state_ = States::terminated;
-        }
-        else if (ev == Events::nowait)
-        {
-            state_ = States::running; // no transition
-        }
-        else if (ev == Events::start || ev == Events::resume || ev == Events::run)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::polling:
-        if (ev == Events::run)
-        {
-            state_ = States::running;
-        }
-        else if (ev == Events::park)
-        {
-            state_ = States::parking;
-        }
-        else if (ev == Events::poll_parking || ev == Events::poll)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::waiting:
-        if (ev == Events::release)
-        {
-            state_ = States::ready;
-        }
-        else if (ev == Events::wait)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::parking:
-        if (ev == Events::poll_parking)
-        {
-            state_ = States::polling;
-        }
-        else if (ev == Events::release_parking)
-        {
-            state_ = States::ready;
-        }
-        else if (ev == Events::park)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::ready:
-        if (ev == Events::resume)
-        {
-            state_ = States::running;
-        }
-        else if (ev == Events::preempt || ev == Events::release || ev == Events::release_parking)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::active:
-        if (ev == Events::start)
-        {
-            state_ = States::running;
-            was_started_ = true;
-        }
-        else if (ev == Events::interrupt_suspended)
-        {
-            state_ = States::active;
-        }
-        else if (ev == Events::activate)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::terminated:
-        if (ev == Events::activate)
-        {
-            state_ = States::active;
-        }
-        else if (ev == Events::mtalimitexceeded)
-        {
-            state_ = States::terminated;
-        }
-        else if (ev == Events::terminate)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::unknown:
-        if (ev == Events::activate || ev == Events::mtalimitexceeded)
-        {
-            state_ = States::active;
-        }
-        else if (ev == Events::start)
-        {
-            was_started_ = true;
-            state_ = States::running;
-        }
-        else if (ev == Events::resume || ev == Events::run)
-        {
-            state_ = States::running;
-        }
-        else if (ev == Events::poll || ev == Events::poll_parking)
-        {
-            state_ = States::polling;
-        }
-        else if (ev == Events::park)
-        {
-            state_ = States::parking;
-        }
-        else if (ev == Events::release_parking || ev == Events::preempt || ev == Events::release)
-        {
-            state_ = States::ready;
-        }
-        else if (ev == Events::wait)
-        {
-            state_ = States::waiting;
-        }
-        else if (ev == Events::terminate || ev == Events::mtalimitexceeded)
-        {
-            state_ = States::terminated;
-        }
-        break;
+        state_ = transition.next_state_;
+        was_started_ = was_started_ || transition.marks_started_;
     }
-    return ErrorCodes::success;
+    return transition.result_;
+}
+
+const StateTransition<Process::States>& Process::getTransition(States state, Events ev)
+{
+    return process_transition_table.get(state, ev);
+}
+
+Process::States Process::getState() const
+{
+    return state_;
 }
 
 std::string Process::eventToString(Events ev)
@@ -418,4 +328,9 @@ void Process::setwaitOSevent(bool wait)
     wait_os_=wait;
 }
 
+void Process::setWasStarted(bool started)
+{
+    was_started_ = started;
+}
+
 } // namespace btf
\ No newline at end of file
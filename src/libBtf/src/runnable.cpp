@@ -17,75 +17,59 @@ Runnable::Runnable(States state) : state_(state)
 {
 }
 
+/*!
+    @brief Builds the transition table of the runnable state machine.
+    @return The transition table.
+*/
+static constexpr StateTransitionTable<Runnable::States, Runnable::Events> makeRunnableTransitionTable()
+{
+    StateTransitionTable<Runnable::States, Runnable::Events> table;
+    using S = Runnable::States;
+    using E = Runnable::Events;
+
+    table.setDefault(S::terminated, ErrorCodes::invalid_state_transition);
+    table.reject(S::terminated, {E::terminate}, ErrorCodes::already_in_state);
+    table.allow(S::terminated, {E::start}, S::running);
+
+    table.setDefault(S::running, ErrorCodes::invalid_state_transition);
+    table.reject(S::running, {E::start, E::resume}, ErrorCodes::already_in_state);
+    table.allow(S::running, {E::suspend}, S::suspended);
+    table.allow(S::running, {E::terminate}, S::terminated);
+
+    table.setDefault(S::suspended, ErrorCodes::invalid_state_transition);
+    table.reject(S::suspended, {E::suspend}, ErrorCodes::already_in_state);
+    table.allow(S::suspended, {E::resume}, S::running);
+
+    // the first event of a runnable defines its state, all other events are accepted without transition
+    table.setDefault(S::unknown, ErrorCodes::success);
+    table.allow(S::unknown, {E::start, E::resume}, S::running);
+    table.allow(S::unknown, {E::terminate}, S::terminated);
+    table.allow(S::unknown, {E::suspend}, S::suspended);
+
+    return table;
+}
+
+/// The transition table of the runnable state machine.
+static constexpr auto runnable_transition_table = makeRunnableTransitionTable();
+
 ErrorCodes Runnable::doStateTransition(Events core_event)
 {
-    switch (state_)
+    const auto& transition = runnable_transition_table.get(state_, core_event);
+    if (transition.result_ == ErrorCodes::success)
     {
-    case States::terminated:
-        if (core_event == Events::terminate)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else if (core_event == Events::start)
-        {
-            state_ = States::running;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::running:
-        if (core_event == Events::start || core_event == Events::resume)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else if (core_event == Events::suspend)
-        {
-            state_ = States::suspended;
-        }
-        else if (core_event == Events::terminate)
-        {
-            state_ = States::terminated;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::suspended:
-        if (core_event == Events::suspend)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else if (core_event == Events::resume)
-        {
-            state_ = States::running;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::unknown:
-        if (core_event == Events::start || core_event == Events::resume)
-        {
-            state_ = States::running;
-        }
-        else if (core_event == Events::terminate)
-        {
-            state_ = States::terminated;
-        }
-        else if (core_event == Events::suspend)
-        {
-            state_ = States::suspended;
-        }
-        break;
-    default:
-        FATAL_INTERNAL_ERROR_MSG("unknown state")
-        break;
+        state_ = transition.next_state_;
     }
-    return ErrorCodes::success;
+    return transition.result_;
+}
+
+const StateTransition<Runnable::States>& Runnable::getTransition(States state, Events ev)
+{
+    return runnable_transition_table.get(state, ev);
+}
+
+Runnable::States Runnable::getState() const
+{
+    return state_;
 }
 
 std::string Runnable::eventToString(Events ev)
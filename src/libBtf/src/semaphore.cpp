@@ -17,110 +17,67 @@ Semaphore::Semaphore(States state) : state_(state)
 {
 }
 
+/*!
+    @brief Builds the transition table of the semaphore state machine.
+    @return The transition table.
+*/
+static constexpr StateTransitionTable<Semaphore::States, Semaphore::Events> makeSemaphoreTransitionTable()
+{
+    StateTransitionTable<Semaphore::States, Semaphore::Events> table;
+    using S = Semaphore::States;
+    using E = Semaphore::Events;
+
+    table.setDefault(S::free, ErrorCodes::invalid_state_transition);
+    table.allow(S::free, {E::used}, S::used);
+    table.allow(S::free, {E::lock}, S::full);
+    table.reject(S::free, {E::free, E::unlock}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::full, ErrorCodes::invalid_state_transition);
+    table.allow(S::full, {E::unlock}, S::free);
+    table.allow(S::full, {E::unlock_full}, S::used);
+    table.allow(S::full, {E::overfull}, S::overfull);
+    table.reject(S::full, {E::full, E::lock, E::lock_used}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::overfull, ErrorCodes::invalid_state_transition);
+    table.allow(S::overfull, {E::full}, S::full);
+    table.allow(S::overfull, {E::overfull}, S::overfull);
+
+    table.setDefault(S::used, ErrorCodes::invalid_state_transition);
+    table.allow(S::used, {E::free}, S::free);
+    table.allow(S::used, {E::lock_used}, S::full);
+    table.allow(S::used, {E::used}, S::used);
+    table.reject(S::used, {E::unlock_full}, ErrorCodes::already_in_state);
+
+    table.setDefault(S::unknown, ErrorCodes::invalid_state_transition);
+    table.allow(S::unknown, {E::used, E::unlock_full}, S::used);
+    table.allow(S::unknown, {E::free, E::unlock}, S::free);
+    table.allow(S::unknown, {E::lock, E::lock_used, E::full}, S::full);
+    table.allow(S::unknown, {E::overfull}, S::overfull);
+
+    return table;
+}
+
+/// The transition table of the semaphore state machine.
+static constexpr auto semaphore_transition_table = makeSemaphoreTransitionTable();
+
 ErrorCodes Semaphore::doStateTransition(Events ev)
 {
-    switch (state_)
-    {
-    case States::free:
-        if (ev == Events::used)
-        {
-            state_ = States::used;
-        }
-        else if (ev == Events::lock)
-        {
-            state_ = States::full;
-        }
-        else if (ev == Events::free || ev == Events::unlock)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::full:
-        if (ev == Events::unlock)
-        {
-            state_ = States::free;
-        }
-        else if (ev == Events::unlock_full)
-        {
-            state_ = States::used;
-        }
-        else if (ev == Events::overfull)
-        {
-            state_ = States::overfull;
-        }
-        else if (ev == Events::full || ev == Events::lock || ev == Events::lock_used)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::overfull:
-        if (ev == Events::full)
-        {
-            state_ = States::full;
-        }
-        else if (ev == Events::overfull)
-        {
-            state_ = States::overfull;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::used:
-        if (ev == Events::free)
-        {
-            state_ = States::free;
-        }
-        else if (ev == Events::lock_used)
-        {
-            state_ = States::full;
-        }
-        else if (ev == Events::used)
-        {
-            state_ = States::used;
-        }
-        else if (ev == Events::unlock_full)
-        {
-            return ErrorCodes::already_in_state;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    case States::unknown:
-        if (ev == Events::used || ev == Events::unlock_full)
-        {
-            state_ = States::used;
-        }
-        else if (ev == Events::free || ev == Events::unlock)
-        {
-            state_ = States::free;
-        }
-        else if (ev == Events::lock || ev == Events::lock_used || ev == Events::full)
-        {
-            state_ = States::full;
-        }
-        else if(ev == Events::overfull)
-        {
-            state_ = States::overfull;
-        }
-        else
-        {
-            return ErrorCodes::invalid_state_transition;
-        }
-        break;
-    }
-    return ErrorCodes::success;
+    const auto& transition = semaphore_transition_table.get(state_, ev);
+    if (transition.result_ == ErrorCodes::success)
+    {
+        state_ = transition.next_state_;
+    }
+    return transition.result_;
+}
+
+const StateTransition<Semaphore::States>& Semaphore::getTransition(States state, Events ev)
+{
+    return semaphore_transition_table.get(state, ev);
+}
+
+Semaphore::States Semaphore::getState() const
+{
+    return state_;
 }
 
 std::string Semaphore::eventToString(Events ev)
@@ -0,0 +1,306 @@
+/* state_keyframes.cpp */
+
+/* 
+ * Copyright (c) 2023 Vector Informatik GmbH
+ *
+ * SPDX-License-Identifier: MIT
+*/
+
+#include "btf/state_keyframes.h"
+
+#include "btf/checkpoint.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace btf
+{
+
+void TraceState::apply(const BtfRecord& record)
+{
+    switch (record.type_)
+    {
+    case EntityTypes::core:
+    {
+        auto& state = cores_.try_emplace(std::string(record.target_), Core::States::unknown).first->second;
+        const auto& transition = Core::getTransition(state, record.event_.core_event);
+        if (transition.result_ == ErrorCodes::success)
+        {
+            state = transition.next_state_;
+        }
+        break;
+    }
+    case EntityTypes::task:
+    case EntityTypes::isr:
+    {
+        Instance process{std::string(record.target_), record.target_instance_};
+        auto it = processes_.try_emplace(process, Process::States::unknown).first;
+        const auto& transition = Process::getTransition(it->second, record.event_.process_event);
+        if (transition.result_ == ErrorCodes::success)
+        {
+            it->second = transition.next_state_;
+        }
+
+        // the source of the events that (de)allocate a core is the core
+        const std::string core(record.source_);
+        if (it->second == Process::States::running && Process::isEventAllocatingCore(record.event_.process_event))
+        {
+            running_processes_[core] = process;
+        }
+        else if (it->second != Process::States::running)
+        {
+            const auto running = running_processes_.find(core);
+            if (running != running_processes_.end() && running->second == process)
+            {
+                running_processes_.erase(running);
+            }
+        }
+
+        if (it->second == Process::States::terminated)
+        {
+            processes_.erase(it);
+            runnable_stacks_.erase(process);
+        }
+        break;
+    }
+    case EntityTypes::runnable:
+    {
+        const Instance process{std::string(record.source_), record.source_instance_};
+        Instance runnable{std::string(record.target_), record.target_instance_};
+        if (record.event_.runnable_event == Runnable::Events::start)
+        {
+            runnable_stacks_[process].push_back(std::move(runnable));
+        }
+        else if (record.event_.runnable_event == Runnable::Events::terminate)
+        {
+            const auto stack = runnable_stacks_.find(process);
+            if (stack != runnable_stacks_.end())
+            {
+                const auto it = std::find(stack->second.rbegin(), stack->second.rend(), runnable);
+                if (it != stack->second.rend())
+                {
+                    stack->second.erase(std::prev(it.base()));
+                }
+                if (stack->second.empty())
+                {
+                    runnable_stacks_.erase(stack);
+                }
+            }
+        }
+        break;
+    }
+    default:
+        return;
+    }
+    time_ = record.time_;
+}
+
+StateKeyframeBuilder::StateKeyframeBuilder(uint64_t event_interval, uint64_t time_interval, uint64_t data_offset)
+    : event_interval_(event_interval), time_interval_(time_interval)
+{
+    keyframes_.push_back({data_offset, state_});
+}
+
+void StateKeyframeBuilder::add(const BtfRecord& record, uint64_t next_offset)
+{
+    if (record.type_ == EntityTypes::comment)
+    {
+        return;
+    }
+    state_.apply(record);
+    ++events_since_keyframe_;
+    if ((event_interval_ > 0 && events_since_keyframe_ >= event_interval_) ||
+        (time_interval_ > 0 && record.time_ - keyframes_.back().state_.time_ >= time_interval_))
+    {
+        state_.time_ = record.time_;
+        keyframes_.push_back({next_offset, state_});
+        events_since_keyframe_ = 0;
+    }
+}
+
+const std::vector<StateKeyframe>& StateKeyframeBuilder::getKeyframes() const
+{
+    return keyframes_;
+}
+
+std::string getStateKeyframesPath(const std::string& btf_path)
+{
+    return btf_path + ".btfkey";
+}
+
+/*!
+    @brief Appends an instance to a snapshot.
+    @param[in,out] out The snapshot.
+    @param[in] instance The instance.
+*/
+static void writeInstance(CheckpointWriter& out, const TraceState::Instance& instance)
+{
+    out.writeString(instance.first);
+    out.writeU64(instance.second);
+}
+
+/*!
+    @brief Reads an instance from a snapshot.
+    @param[in,out] in The snapshot.
+    @return The instance.
+*/
+static TraceState::Instance readInstance(CheckpointReader& in)
+{
+    auto name = in.readString();
+    return {std::move(name), in.readU64()};
+}
+
+bool writeStateKeyframes(const std::string& btf_path, uint64_t file_size, const std::vector<StateKeyframe>& keyframes)
+{
+    CheckpointWriter out;
+    out.writeU64(file_size);
+    out.writeU64(keyframes.size());
+    for (const auto& k : keyframes)
+    {
+        out.writeU64(k.offset_);
+        out.writeU64(k.state_.time_);
+        out.writeU64(k.state_.cores_.size());
+        for (const auto& [core, state] : k.state_.cores_)
+        {
+            out.writeString(core);
+            out.writeU64(static_cast<uint64_t>(state));
+        }
+        out.writeU64(k.state_.processes_.size());
+        for (const auto& [process, state] : k.state_.processes_)
+        {
+            writeInstance(out, process);
+            out.writeU64(static_cast<uint64_t>(state));
+        }
+        out.writeU64(k.state_.running_processes_.size());
+        for (const auto& [core, process] : k.state_.running_processes_)
+        {
+            out.writeString(core);
+            writeInstance(out, process);
+        }
+        out.writeU64(k.state_.runnable_stacks_.size());
+        for (const auto& [process, stack] : k.state_.runnable_stacks_)
+        {
+            writeInstance(out, process);
+            out.writeU64(stack.size());
+            for (const auto& runnable : stack)
+            {
+                writeInstance(out, runnable);
+            }
+        }
+    }
+    return out.save(getStateKeyframesPath(btf_path));
+}
+
+void StateKeyframes::build(const std::string& btf_path, uint64_t event_interval, uint64_t time_interval)
+{
+    BtfReader reader(btf_path);
+    StateKeyframeBuilder builder(event_interval, time_interval, reader.getDataOffset());
+    BtfRecord record;
+    while (reader.readRecord(record))
+    {
+        builder.add(record, reader.getPosition());
+    }
+    btf_path_ = btf_path;
+    file_size_ = reader.getFileSize();
+    keyframes_ = builder.getKeyframes();
+}
+
+bool StateKeyframes::save() const
+{
+    return writeStateKeyframes(btf_path_, file_size_, keyframes_);
+}
+
+bool StateKeyframes::load(const std::string& btf_path)
+{
+    keyframes_.clear();
+    CheckpointReader in;
+    std::error_code error;
+    const auto file_size = std::filesystem::file_size(btf_path, error);
+    if (error || !in.load(getStateKeyframesPath(btf_path)))
+    {
+        return false;
+    }
+
+    try
+    {
+        if (in.readU64() != file_size)
+        {
+            return false;
+        }
+        std::vector<StateKeyframe> keyframes(in.readCount());
+        for (auto& k : keyframes)
+        {
+            k.offset_ = in.readU64();
+            k.state_.time_ = in.readU64();
+            for (uint64_t n = in.readCount(); n > 0; --n)
+            {
+                auto core = in.readString();
+                k.state_.cores_[std::move(core)] = static_cast<Core::States>(in.readU64());
+            }
+            for (uint64_t n = in.readCount(); n > 0; --n)
+            {
+                auto process = readInstance(in);
+                k.state_.processes_[std::move(process)] = static_cast<Process::States>(in.readU64());
+            }
+            for (uint64_t n = in.readCount(); n > 0; --n)
+            {
+                auto core = in.readString();
+                k.state_.running_processes_[std::move(core)] = readInstance(in);
+            }
+            for (uint64_t n = in.readCount(); n > 0; --n)
+            {
+                auto& stack = k.state_.runnable_stacks_[readInstance(in)];
+                for (uint64_t i = in.readCount(); i > 0; --i)
+                {
+                    stack.push_back(readInstance(in));
+                }
+            }
+        }
+        if (keyframes.empty() || !in.isAtEnd())
+        {
+            return false;
+        }
+        keyframes_ = std::move(keyframes);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    btf_path_ = btf_path;
+    file_size_ = file_size;
+    return true;
+}
+
+const std::vector<StateKeyframe>& StateKeyframes::getKeyframes() const
+{
+    return keyframes_;
+}
+
+TraceState StateKeyframes::stateAt(uint64_t time) const
+{
+    // the last keyframe that contains no event after the timestamp
+    const auto after = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
+                                        [](uint64_t t, const StateKeyframe& k) { return t < k.state_.time_; });
+    BtfReader reader(btf_path_);
+    TraceState state;
+    if (after != keyframes_.begin())
+    {
+        state = std::prev(after)->state_;
+        reader.seek(std::prev(after)->offset_);
+    }
+
+    BtfRecord record;
+    while (reader.readRecord(record))
+    {
+        if (record.type_ != EntityTypes::comment && record.time_ > time)
+        {
+            break;
+        }
+        state.apply(record);
+    }
+    state.time_ = time;
+    return state;
+}
+
+} // namespace btf
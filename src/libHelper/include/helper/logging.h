@@ -10,6 +10,10 @@
 
 
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
 
 #ifdef __clang__
 #include <experimental/source_location>
@@ -27,6 +31,7 @@ using std::source_location;
 #define FATAL_INTERNAL_ERROR_MSG(MSG)                                                                                                                          \
     {                                                                                                                                                          \
         const source_location location = source_location::current();                                                                                           \
+        helper::logging::flush();                                                                                                                              \
         std::cout << "FATAL INTERNAL ERROR in <" << location.function_name() << "> at <" << location.line() << ">\n";                                          \
         std::cout << MSG;                                                                                                                                      \
         std::terminate();                                                                                                                                      \
@@ -52,9 +57,74 @@ enum class LogLevel
     trace = 3
 };
 
+/*!
+    @brief Stream object that collects a single log message.
+
+    The print functions return a LogStream instead of writing to the log directly. The message is formatted into a buffer owned by the
+    LogStream and handed over to the background log writer as one record when the LogStream is destroyed, i.e. at the end of the full
+    expression (e.g. printWarning() << "a" << 1 << '\n';). If the log level of the message is not enabled nothing is formatted at all.
+*/
+class LogStream
+{
+  public:
+    /*!
+        @brief Constructor of the class LogStream.
+        @param[in] log_level The log level of the message.
+        @param[in] location The source code location of the message.
+    */
+    LogStream(LogLevel log_level, const source_location& location);
+
+    /*!
+        @brief Destructor of the class LogStream. Passes the collected message to the background log writer.
+    */
+    ~LogStream();
+
+    /// Delete the Copy Constructor.
+    LogStream(const LogStream&) = delete;
+    /// Delete the Move Constructor.
+    LogStream(LogStream&&) = delete;
+    /// Delete the copy assignment operator.
+    LogStream& operator=(const LogStream&) = delete;
+    /// Delete the move assignment operator.
+    LogStream& operator=(LogStream&&) = delete;
+
+    /*!
+        @brief Appends a value to the message.
+        @param[in] value The value to append. Any type that can be written to a std::ostream is supported.
+        @return The LogStream itself.
+    */
+    template <typename T> LogStream& operator<<(const T& value)
+    {
+        if (buffer_)
+        {
+            *buffer_ << value;
+        }
+        return *this;
+    }
+
+    /*!
+        @brief Applies a stream manipulator (e.g. std::endl) to the message.
+        @param[in] manipulator The stream manipulator.
+        @return The LogStream itself.
+    */
+    LogStream& operator<<(std::ostream& (*manipulator)(std::ostream&));
+
+  private:
+    /// The log level of the message.
+    LogLevel log_level_;
+
+    /// The source code location of the message.
+    source_location location_;
+
+    /// The message buffer. It is empty if the log level of the message is not enabled.
+    std::optional<std::ostringstream> buffer_;
+};
+
 /**
  * @brief Initalizes the logging feature.
  * 
+ * All messages that were logged before are written to the previous log target first.
+ * 
  * @param[in] log_level The max log level that will be written to the log.
  * @param[in] log_file_path The file path to the log file. If it is empty cout is used.
  */
@@ -62,42 +132,64 @@ void initLogging(LogLevel log_level, const std::string& log_file_path = "");
 
 /**
  * @brief Flushes the log.
+ * 
+ * Blocks until all messages that were logged before the call (by any thread) are written to the log target.
  */
 void flush();
 
+/**
+ * @brief Writes a text to the standard output.
+ * 
+ * The log messages that were logged before the call are written first. The text is written under the lock of the log target, so it
+ * does not interleave with log messages that are written to the standard output.
+ * 
+ * @param[in] text The text.
+ */
+void printOutput(std::string_view text);
+
 /**
  * @brief Writes an error message to the log.
  * @param[in] location The source code location. Using the default value gives the current source code location.
  * 
- * @return An ostream with the error message to the log.
+ * @return A LogStream that collects the error message.
  */
-std::ostream& printError(const source_location location = source_location::current());
+LogStream printError(const source_location location = source_location::current());
 
 /**
  * @brief Writes a warning message to the log.
  * @param[in] location The source code location. Using the default value gives the current source code location.
  *
- * @return An ostream with the warning message to the log.
+ * @return A LogStream that collects the warning message.
  */
-std::ostream& printWarning(const source_location location = source_location::current());
+LogStream printWarning(const source_location location = source_location::current());
 
 /**
  * @brief Writes a trace message to the log.
  * @param[in] location The source code location. Using the default value gives the current source code location.
  *
- * @return An ostream with the trace message to the log.
+ * @return A LogStream that collects the trace message.
  */
-std::ostream& printTrace(const source_location location = source_location::current());
+LogStream printTrace(const source_location location = source_location::current());
 
 /**
  * @brief Prints a log message to the log.
  * 
+ * The message is written asynchronously by a background thread. Messages of one thread keep their order.
+ * 
  * @param[in] log_level The log level of the message to be written.
  * @param[in] location The source code location. Using the default value gives the current source code location.
  *
- * @return An ostream with the log message to the log.
+ * @return A LogStream that collects the log message.
+ */
+LogStream printLog(LogLevel log_level, const source_location location);
+
+/**
+ * @brief Checks if messages of a log level are written to the log.
+ * @param[in] log_level The log level to check.
+ * 
+ * @return True if messages of this log level are written, else false.
  */
-std::ostream& printLog(LogLevel log_level, const source_location location);
+bool isLogLevelEnabled(LogLevel log_level);
 
 /**
  *  @brief Converts the enum LogLevel into string.
@@ -111,9 +203,9 @@ std::string logLevelToString(LogLevel log_level);
  *  @brief Gets the source file name out of the path.
  *  @param[in] file_name Source file name with the complete path.
  *  
- *  @return Source file name.
+ *  @return Source file name (a view into file_name).
 */
-std::string stripSourceFileName(const std::string& file_name);
+std::string_view stripSourceFileName(std::string_view file_name);
 
 } // namespace logging
 } // namespace helper
\ No newline at end of file
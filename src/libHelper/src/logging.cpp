@@ -1,6 +1,6 @@
 /* logging.cpp */
 
-/* 
+/*
  * Copyright (c) 2023 Vector Informatik GmbH
  *
  * SPDX-License-Identifier: MIT
@@ -9,58 +9,235 @@
 
 #include "helper/logging.h"
 
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <memory>
-#include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace helper::logging
 {
 
 /*!
-    @brief Class for the Logger.
+    @brief A single log message as it is passed from the producing thread to the log writer.
 */
-class GlobalLogger
+struct LogRecord
+{
+    /// The log level of the message.
+    LogLevel log_level_{LogLevel::none};
+
+    /// The source code location of the message (only pointers to static strings and the line).
+    source_location location_;
+
+    /// The formatted message text.
+    std::string payload_;
+};
+
+/*!
+    @brief Bounded lock-free ring of log records with multiple producers and a single consumer.
+
+    Every cell carries a sequence number that tells producers and the consumer whether the cell is free or filled.
+    Records are consumed in the order in which the producers claimed their cells, hence the order of the messages of one thread is kept.
+*/
+class LogRecordRing
 {
   public:
     /*!
-      @brief Constructor of the class GlobalLogger.
+      @brief Constructor of the class LogRecordRing.
     */
-    GlobalLogger() noexcept
+    LogRecordRing() noexcept
     {
-        try
+        for (size_t i = 0; i < cells_.size(); ++i)
         {
-            nullout_ = std::make_unique<std::ofstream>();
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
         }
-        catch (...)
+    }
+
+    /*!
+      @brief Adds a record to the ring.
+      @param[in] record The record. It is only moved from on success.
+      @return True if the record was added, false if the ring is full.
+    */
+    bool tryPush(LogRecord& record) noexcept
+    {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell{nullptr};
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence_.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (dif == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (dif < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record_ = std::move(record);
+        cell->sequence_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+      @brief Takes the oldest record from the ring. Must only be called by the consumer thread.
+      @param[out] record The record.
+      @return True if a record was taken, false if the next record is not available yet.
+    */
+    bool tryPop(LogRecord& record) noexcept
+    {
+        Cell& cell = cells_[dequeue_pos_ & mask_];
+        if (cell.sequence_.load(std::memory_order_acquire) != dequeue_pos_ + 1)
+        {
+            return false;
+        }
+        record = std::move(cell.record_);
+        cell.sequence_.store(dequeue_pos_ + cells_.size(), std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+    /*!
+      @brief Gets the number of records that were claimed by producers so far.
+      @return The number of claimed records.
+    */
+    size_t claimed() const noexcept
+    {
+        return enqueue_pos_.load(std::memory_order_acquire);
+    }
+
+  private:
+    /*!
+      @brief One slot of the ring.
+    */
+    struct Cell
+    {
+        /// Sequence number of the cell.
+        std::atomic<size_t> sequence_{0};
+
+        /// The stored record.
+        LogRecord record_;
+    };
+
+    /// Number of cells in the ring (power of two).
+    static constexpr size_t capacity_{4096};
+
+    /// Mask to map a position to a cell.
+    static constexpr size_t mask_{capacity_ - 1};
+
+    /// The cells of the ring.
+    std::array<Cell, capacity_> cells_;
+
+    /// Next position a producer claims.
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+
+    /// Next position the consumer reads (only accessed by the consumer).
+    alignas(64) size_t dequeue_pos_{0};
+};
+
+/*!
+    @brief Class for the Logger.
+
+    Producers format their messages and push them into a lock-free ring. A background thread takes the records from the ring,
+    adds the message prefix and writes them to the log target.
+*/
+class GlobalLogger
+{
+  public:
+    /*!
+      @brief Destructor of the class GlobalLogger. Writes all pending messages and stops the writer thread.
+    */
+    ~GlobalLogger()
+    {
+        if (writer_.joinable())
         {
-            std::puts("GlobalLogger: could not create null logger\n");
-            std::terminate();
+            stop_.store(true, std::memory_order_release);
+            published_.fetch_add(1, std::memory_order_release);
+            published_.notify_one();
+            writer_.join();
         }
     }
 
     /*!
-      @brief Opens the log file.
+      @brief Opens the log file. Pending messages are written to the previous log target first.
       @param[in] path Path to the log file.
     */
     void openLogFile(const std::string& path)
     {
+        flush();
+        std::lock_guard<std::mutex> lock(sink_mutex_);
         log_file_ = std::make_unique<std::ofstream>(path);
         if (!log_file_->good())
         {
-            closeLogFile();
+            log_file_.reset(nullptr);
         }
     }
 
     /*!
-      @brief Closes the log file.
+      @brief Closes the log file. Pending messages are written to the log file first.
     */
-    void closeLogFile() noexcept
+    void closeLogFile()
     {
+        flush();
+        std::lock_guard<std::mutex> lock(sink_mutex_);
         log_file_.reset(nullptr);
     }
 
     /*!
-      @brief Gets the logger (ostream).
+      @brief Passes a record to the writer thread. Blocks (yields) while the ring is full.
+      @param[in] record The record.
+    */
+    void push(LogRecord&& record) noexcept
+    {
+        std::call_once(writer_started_, [this]() { writer_ = std::thread(&GlobalLogger::writerLoop, this); });
+        while (!ring_.tryPush(record))
+        {
+            std::this_thread::yield();
+        }
+        published_.fetch_add(1, std::memory_order_release);
+        published_.notify_one();
+    }
+
+    /*!
+      @brief Waits until all records claimed before the call are written and flushes the log target.
+    */
+    void flush()
+    {
+        const size_t ticket = ring_.claimed();
+        size_t written = written_.load(std::memory_order_acquire);
+        while (written < ticket)
+        {
+            written_.wait(written, std::memory_order_acquire);
+            written = written_.load(std::memory_order_acquire);
+        }
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        getLogger() << std::flush;
+    }
+
+    /*!
+      @brief Writes the pending messages and then a text to the standard output.
+      @param[in] text The text.
+    */
+    void printOutput(std::string_view text)
+    {
+        flush();
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        std::cout << text << std::flush;
+    }
+
+  private:
+    /*!
+      @brief Gets the logger (ostream). The sink mutex must be held.
       @return The log file, if available, else cout.
     */
     std::ostream& getLogger() noexcept
@@ -73,46 +250,129 @@ class GlobalLogger
     }
 
     /*!
-      @brief Gets the null logger (ostream).
-      @return The null logger.
+      @brief Main loop of the writer thread.
     */
-    std::ostream& getNullLogger() noexcept
+    void writerLoop()
     {
-        return *nullout_;
+        LogRecord record;
+        for (;;)
+        {
+            const auto seen = published_.load(std::memory_order_acquire);
+            if (!ring_.tryPop(record))
+            {
+                if (stop_.load(std::memory_order_acquire) && written_.load(std::memory_order_relaxed) == ring_.claimed())
+                {
+                    break;
+                }
+                published_.wait(seen, std::memory_order_acquire);
+                continue;
+            }
+
+            // write the whole batch of available records under one lock
+            size_t count{0};
+            {
+                std::lock_guard<std::mutex> lock(sink_mutex_);
+                auto& out = getLogger();
+                do
+                {
+                    out << logLevelToString(record.log_level_) << " [file: " << stripSourceFileName(record.location_.file_name()) << ": "
+                        << record.location_.line() << " `" << record.location_.function_name() << "`] " << record.payload_;
+                    ++count;
+                } while (ring_.tryPop(record));
+                if (log_file_ == nullptr)
+                {
+                    out << std::flush;
+                }
+            }
+            written_.fetch_add(count, std::memory_order_release);
+            written_.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(sink_mutex_);
+        getLogger() << std::flush;
     }
 
-  private:
+    /// The ring that passes the records to the writer thread.
+    LogRecordRing ring_;
+
+    /// Number of records written by the writer thread.
+    std::atomic<size_t> written_{0};
+
+    /// Counter that is incremented for each published record, used to wake up the writer thread.
+    std::atomic<uint32_t> published_{0};
+
+    /// Boolean value that is true when the writer thread shall stop.
+    std::atomic<bool> stop_{false};
+
+    /// Flag to start the writer thread with the first message.
+    std::once_flag writer_started_;
+
+    /// The writer thread.
+    std::thread writer_;
+
+    /// Mutex that protects the log target.
+    std::mutex sink_mutex_;
+
+    /// The log file (nullptr if cout is used).
     std::unique_ptr<std::ofstream> log_file_;
-    std::unique_ptr<std::ofstream> nullout_;
 };
 
-static LogLevel glog_level{LogLevel::warning};
+static std::atomic<LogLevel> glog_level{LogLevel::warning};
 static GlobalLogger glogger;
 
+LogStream::LogStream(LogLevel log_level, const source_location& location) : log_level_(log_level), location_(location)
+{
+    if (isLogLevelEnabled(log_level))
+    {
+        buffer_.emplace();
+    }
+}
+
+LogStream::~LogStream()
+{
+    if (buffer_)
+    {
+        glogger.push({log_level_, location_, std::move(*buffer_).str()});
+    }
+}
+
+LogStream& LogStream::operator<<(std::ostream& (*manipulator)(std::ostream&))
+{
+    if (buffer_)
+    {
+        manipulator(*buffer_);
+    }
+    return *this;
+}
+
 void initLogging(LogLevel log_level, const std::string& log_file_path)
 {
-    glog_level = log_level;
+    glog_level.store(log_level, std::memory_order_relaxed);
     if (!log_file_path.empty())
     {
         glogger.openLogFile(log_file_path);
     }
 }
 
-std::ostream& printError(const source_location location)
+LogStream printError(const source_location location)
 {
     return printLog(LogLevel::error, location);
 }
 
-std::ostream& printWarning(const source_location location)
+LogStream printWarning(const source_location location)
 {
     return printLog(LogLevel::warning, location);
 }
 
-std::ostream& printTrace(const source_location location)
+LogStream printTrace(const source_location location)
 {
     return printLog(LogLevel::trace, location);
 }
 
+bool isLogLevelEnabled(LogLevel log_level)
+{
+    return glog_level.load(std::memory_order_relaxed) >= log_level;
+}
+
 std::string logLevelToString(LogLevel log_level)
 {
     switch (log_level)
@@ -129,31 +389,30 @@ std::string logLevelToString(LogLevel log_level)
     return "";
 }
 
-std::string stripSourceFileName(const std::string& file_name)
+std::string_view stripSourceFileName(std::string_view file_name)
 {
     const std::string_view root_project_folder_name{"btf-toolchain"};
     auto pos{file_name.rfind(root_project_folder_name)};
-    if (pos != std::string::npos)
+    if (pos != std::string_view::npos)
     {
         return file_name.substr(pos + root_project_folder_name.length() + 1);
     }
     return file_name;
 }
 
-std::ostream& printLog(LogLevel log_level, const source_location location)
+LogStream printLog(LogLevel log_level, const source_location location)
 {
-    if (glog_level >= log_level)
-    {
-        glogger.getLogger() << logLevelToString(log_level) << " [file: " << stripSourceFileName(location.file_name()) << ": " << location.line() << " `"
-                            << location.function_name() << "`] ";
-        return glogger.getLogger();
-    }
-    return glogger.getNullLogger();
+    return {log_level, location};
 }
 
 void flush()
 {
-    glogger.getLogger() << std::flush;
+    glogger.flush();
+}
+
+void printOutput(std::string_view text)
+{
+    glogger.printOutput(text);
 }
 
-} // namespace helper::logging
\ No newline at end of file
+} // namespace helper::logging
@@ -7,15 +7,40 @@
 */
 
 
+#include "btf/batch_conversion.h"
 #include "btf/btf.h"
+#include "btf/btf_reader.h"
+#include "btf/checkpoint.h"
+#include "btf/compression.h"
+#include "btf/conversion_cache.h"
+#include "btf/state_keyframes.h"
 #include "libhelper_binding.h"
 
+#include <pybind11/functional.h>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <optional>
+
 namespace py = pybind11;
 
+/**
+ * @brief A record of a BtfReader that owns its strings. The views of a btf::BtfRecord point into the line buffer of the reader,
+ * so they cannot be handed to Python.
+*/
+struct PyBtfRecord
+{
+    uint64_t time_{0};
+    std::string source_;
+    uint64_t source_instance_{0};
+    btf::EntityTypes type_{btf::EntityTypes::unknown};
+    std::string target_;
+    uint64_t target_instance_{0};
+    std::string event_name_;
+    std::string note_;
+};
+
 /**
  * @brief Macro that creates a function that will be called when the module pybtf is imported within python.
  * It enables the creation of Python bindings for the C++ code of the BTF lib.
@@ -52,8 +77,10 @@ PYBIND11_MODULE(pybtf, m) // NOLINT
         .value("terminate_on_task_with_running_runnables", btf::ErrorCodes::terminate_on_task_with_running_runnables)
         .value("allocated_to_different_core", btf::ErrorCodes::allocated_to_different_core)
         .value("source_and_target_not_equal", btf::ErrorCodes::source_and_target_not_equal)
-        .value("amount_of_semaphore_accesses_invalid", btf::ErrorCodes::amount_of_semaphore_accesses_invalid);
+        .value("amount_of_semaphore_accesses_invalid", btf::ErrorCodes::amount_of_semaphore_accesses_invalid)
+        .value("hash_collision", btf::ErrorCodes::hash_collision);
     m.def("errorCodeToString", &btf::errorCodeToString, "converts an error code to string", py::arg("code"));
+    m.def("hashEntityName", &btf::hashEntityName, "hashes an entity name into the stable 64-bit entity ID", py::arg("name"));
 
     py::enum_<btf::Core::Events>(m, "CoreEvent")
         .value("idle", btf::Core::Events::idle)
@@ -129,6 +156,256 @@ PYBIND11_MODULE(pybtf, m) // NOLINT
         .value("trigger", btf::Stimulus::Events::trigger)
         .value("unknown", btf::Stimulus::Events::unknown);
 
+    py::enum_<btf::Core::States>(m, "CoreState")
+        .value("idle", btf::Core::States::idle)
+        .value("execution", btf::Core::States::execution)
+        .value("unknown", btf::Core::States::unknown);
+
+    py::class_<btf::StateTransition<btf::Core::States>>(m, "CoreStateTransition")
+        .def_readonly("next_state_", &btf::StateTransition<btf::Core::States>::next_state_)
+        .def_readonly("result_", &btf::StateTransition<btf::Core::States>::result_)
+        .def_readonly("marks_started_", &btf::StateTransition<btf::Core::States>::marks_started_);
+    m.def("getCoreTransition", &btf::Core::getTransition, "gets the transition of the core state machine for a state and an event", py::arg("state"),
+          py::arg("event"));
+
+    py::enum_<btf::Process::States>(m, "ProcessState")
+        .value("running", btf::Process::States::running)
+        .value("polling", btf::Process::States::polling)
+        .value("waiting", btf::Process::States::waiting)
+        .value("parking", btf::Process::States::parking)
+        .value("ready", btf::Process::States::ready)
+        .value("active", btf::Process::States::active)
+        .value("terminated", btf::Process::States::terminated)
+        .value("unknown", btf::Process::States::unknown);
+
+    py::class_<btf::StateTransition<btf::Process::States>>(m, "ProcessStateTransition")
+        .def_readonly("next_state_", &btf::StateTransition<btf::Process::States>::next_state_)
+        .def_readonly("result_", &btf::StateTransition<btf::Process::States>::result_)
+        .def_readonly("marks_started_", &btf::StateTransition<btf::Process::States>::marks_started_);
+    m.def("getProcessTransition", &btf::Process::getTransition, "gets the transition of the process state machine for a state and an event", py::arg("state"),
+          py::arg("event"));
+
+    py::enum_<btf::Runnable::States>(m, "RunnableState")
+        .value("terminated", btf::Runnable::States::terminated)
+        .value("running", btf::Runnable::States::running)
+        .value("suspended", btf::Runnable::States::suspended)
+        .value("unknown", btf::Runnable::States::unknown);
+
+    py::class_<btf::StateTransition<btf::Runnable::States>>(m, "RunnableStateTransition")
+        .def_readonly("next_state_", &btf::StateTransition<btf::Runnable::States>::next_state_)
+        .def_readonly("result_", &btf::StateTransition<btf::Runnable::States>::result_)
+        .def_readonly("marks_started_", &btf::StateTransition<btf::Runnable::States>::marks_started_);
+    m.def("getRunnableTransition", &btf::Runnable::getTransition, "gets the transition of the runnable state machine for a state and an event", py::arg("state"),
+          py::arg("event"));
+
+    py::enum_<btf::Semaphore::States>(m, "SemaphoreState")
+        .value("free", btf::Semaphore::States::free)
+        .value("full", btf::Semaphore::States::full)
+        .value("overfull", btf::Semaphore::States::overfull)
+        .value("used", btf::Semaphore::States::used)
+        .value("unknown", btf::Semaphore::States::unknown);
+
+    py::class_<btf::StateTransition<btf::Semaphore::States>>(m, "SemaphoreStateTransition")
+        .def_readonly("next_state_", &btf::StateTransition<btf::Semaphore::States>::next_state_)
+        .def_readonly("result_", &btf::StateTransition<btf::Semaphore::States>::result_)
+        .def_readonly("marks_started_", &btf::StateTransition<btf::Semaphore::States>::marks_started_);
+    m.def("getSemaphoreTransition", &btf::Semaphore::getTransition, "gets the transition of the semaphore state machine for a state and an event", py::arg("state"),
+          py::arg("event"));
+
+    py::enum_<btf::EntityTypes>(m, "EntityType")
+        .value("core", btf::EntityTypes::core)
+        .value("os", btf::EntityTypes::os)
+        .value("task", btf::EntityTypes::task)
+        .value("isr", btf::EntityTypes::isr)
+        .value("stimulus", btf::EntityTypes::stimulus)
+        .value("scheduler", btf::EntityTypes::scheduler)
+        .value("semaphore", btf::EntityTypes::semaphore)
+        .value("runnable", btf::EntityTypes::runnable)
+        .value("signal", btf::EntityTypes::signal)
+        .value("comment", btf::EntityTypes::comment)
+        .value("simulation", btf::EntityTypes::simulation)
+        .value("syscall", btf::EntityTypes::syscall)
+        .value("thread", btf::EntityTypes::thread)
+        .value("unknown", btf::EntityTypes::unknown);
+
+    py::enum_<btf::ImportIssues>(m, "ImportIssue")
+        .value("invalid_format", btf::ImportIssues::invalid_format)
+        .value("invalid_number", btf::ImportIssues::invalid_number)
+        .value("unknown_entity_type", btf::ImportIssues::unknown_entity_type)
+        .value("unknown_event", btf::ImportIssues::unknown_event)
+        .value("invalid_migration", btf::ImportIssues::invalid_migration)
+        .value("rejected_event", btf::ImportIssues::rejected_event);
+    m.def("importIssueToString", &btf::importIssueToString, "converts an import issue to string", py::arg("issue"));
+
+    py::class_<btf::ImportDiagnosticsCategory>(m, "ImportDiagnosticsCategory")
+        .def_readonly("issue_", &btf::ImportDiagnosticsCategory::issue_)
+        .def_readonly("type_", &btf::ImportDiagnosticsCategory::type_)
+        .def_readonly("error_", &btf::ImportDiagnosticsCategory::error_)
+        .def_readonly("event_", &btf::ImportDiagnosticsCategory::event_)
+        .def_readonly("count_", &btf::ImportDiagnosticsCategory::count_)
+        .def_readonly("sample_lines_", &btf::ImportDiagnosticsCategory::sample_lines_);
+
+    py::class_<btf::ImportSummary>(m, "ImportSummary")
+        .def_readonly("lines_", &btf::ImportSummary::lines_)
+        .def_readonly("rejected_lines_", &btf::ImportSummary::rejected_lines_)
+        .def_readonly("filtered_lines_", &btf::ImportSummary::filtered_lines_)
+        .def_readonly("categories_", &btf::ImportSummary::categories_)
+        .def("toString", &btf::ImportSummary::toString, "Converts the import summary to string");
+
+    py::class_<btf::ParallelImportSummary>(m, "ParallelImportSummary")
+        .def_readonly("import_", &btf::ParallelImportSummary::import_)
+        .def_readonly("partitions_", &btf::ParallelImportSummary::partitions_)
+        .def_readonly("reimported_partitions_", &btf::ParallelImportSummary::reimported_partitions_)
+        .def_readonly("replayed_lines_", &btf::ParallelImportSummary::replayed_lines_)
+        .def_readonly("is_restarted_", &btf::ParallelImportSummary::is_restarted_);
+
+    py::class_<btf::InputSource>(m, "InputSource").def("getName", &btf::InputSource::getName, "gets a name of the source for messages");
+    py::class_<btf::FileInputSource, btf::InputSource>(m, "FileInputSource").def(py::init<std::string>(), py::arg("path"));
+    py::class_<btf::FileDescriptorInputSource, btf::InputSource>(m, "FileDescriptorInputSource").def(py::init<int>(), py::arg("fd"));
+    py::enum_<btf::Compressions>(m, "Compressions")
+        .value("none", btf::Compressions::none)
+        .value("gzip", btf::Compressions::gzip)
+        .value("zstd", btf::Compressions::zstd);
+    m.def("isCompressionSupported", &btf::isCompressionSupported, "checks if a compression format is supported by the build", py::arg("compression"));
+    py::class_<btf::CompressedBlock>(m, "CompressedBlock")
+        .def_readonly("uncompressed_offset_", &btf::CompressedBlock::uncompressed_offset_)
+        .def_readonly("uncompressed_size_", &btf::CompressedBlock::uncompressed_size_)
+        .def_readonly("compressed_offset_", &btf::CompressedBlock::compressed_offset_)
+        .def_readonly("compressed_size_", &btf::CompressedBlock::compressed_size_)
+        .def_readonly("first_time_", &btf::CompressedBlock::first_time_)
+        .def_readonly("last_time_", &btf::CompressedBlock::last_time_);
+    m.def("getBlockTablePath", &btf::getBlockTablePath, "gets the path of the block table of a compressed BTF file", py::arg("path"));
+
+    py::class_<btf::CompressedBtfFile>(m, "CompressedBtfFile")
+        .def(py::init<>())
+        .def("load", &btf::CompressedBtfFile::load, "loads the block table of a compressed BTF file", py::arg("path"))
+        .def("getCompression", &btf::CompressedBtfFile::getCompression, "gets the compression format")
+        .def("getBlocks", &btf::CompressedBtfFile::getBlocks, "gets the blocks in file order")
+        .def("findBlock", &btf::CompressedBtfFile::findBlock, "finds the first block that contains events at or after a timestamp", py::arg("time"))
+        .def(
+            "readBlock",
+            [](const btf::CompressedBtfFile& file, size_t block) -> std::optional<std::string> {
+                std::string lines;
+                if (!file.readBlock(block, lines))
+                {
+                    return std::nullopt;
+                }
+                return lines;
+            },
+            "reads and decompresses a block, None if it could not be read", py::arg("block"));
+
+    m.def("openInputSource", &btf::openInputSource, "opens an input source for a path, '-' opens the standard input", py::arg("path"));
+
+    py::class_<btf::OutputRotation>(m, "OutputRotation")
+        .def(py::init<>())
+        .def_readwrite("max_events_", &btf::OutputRotation::max_events_)
+        .def_readwrite("max_bytes_", &btf::OutputRotation::max_bytes_)
+        .def_readwrite("time_window_", &btf::OutputRotation::time_window_)
+        .def("isActive", &btf::OutputRotation::isActive, "checks if any limit is set");
+    m.def("getRotationPartPath", &btf::getRotationPartPath, "gets the path of a part of a rotated output", py::arg("path"), py::arg("part"));
+    m.def("getRotationManifestPath", &btf::getRotationManifestPath, "gets the path of the manifest of a rotated output", py::arg("path"));
+    m.def("getStateTrailerPath", &btf::getStateTrailerPath, "gets the path of the state trailer of a BTF file", py::arg("path"));
+    py::class_<btf::TraceState>(m, "TraceState")
+        .def(py::init<>())
+        .def_readwrite("time_", &btf::TraceState::time_)
+        .def_readwrite("cores_", &btf::TraceState::cores_)
+        .def_readwrite("processes_", &btf::TraceState::processes_)
+        .def_readwrite("running_processes_", &btf::TraceState::running_processes_)
+        .def_readwrite("runnable_stacks_", &btf::TraceState::runnable_stacks_)
+        .def("apply", &btf::TraceState::apply, "applies an event to the state", py::arg("record"))
+        .def(py::self == py::self);
+
+    py::class_<btf::StateKeyframe>(m, "StateKeyframe")
+        .def_readonly("offset_", &btf::StateKeyframe::offset_)
+        .def_readonly("state_", &btf::StateKeyframe::state_);
+
+    py::class_<btf::StateKeyframes>(m, "StateKeyframes")
+        .def(py::init<>())
+        .def("build", &btf::StateKeyframes::build, "records the keyframes of a BTF file", py::arg("btf_path"), py::arg("event_interval"),
+             py::arg("time_interval") = 0)
+        .def("save", &btf::StateKeyframes::save, "writes the keyframes next to the BTF file")
+        .def("load", &btf::StateKeyframes::load, "loads the keyframes of a BTF file", py::arg("btf_path"))
+        .def("getKeyframes", &btf::StateKeyframes::getKeyframes, "gets the keyframes")
+        .def("stateAt", &btf::StateKeyframes::stateAt, "gets the state after all events up to a timestamp", py::arg("time"));
+    m.def("getStateKeyframesPath", &btf::getStateKeyframesPath, "gets the path of the keyframes of a BTF file", py::arg("btf_path"));
+    m.def("getCoreSplitPath", &btf::getCoreSplitPath, "gets the path of the file of a core of a split output", py::arg("path"), py::arg("core"));
+
+    py::class_<btf::ImportFilter>(m, "ImportFilter")
+        .def(py::init<>())
+        .def("setEntityTypes", &btf::ImportFilter::setEntityTypes, "sets the entity types that are imported", py::arg("types"))
+        .def("addEntity", &btf::ImportFilter::addEntity, "adds an entity to the allowlist", py::arg("name"))
+        .def("setTimeWindow", &btf::ImportFilter::setTimeWindow, "sets the time window of the import", py::arg("start_time"), py::arg("end_time"))
+        .def("setIncludeDependencies", &btf::ImportFilter::setIncludeDependencies,
+             "enables or disables the forced inclusion of the entities the selected entity types depend on", py::arg("include_dependencies"));
+
+    m.def("getSidecarIndexPath", &btf::getSidecarIndexPath, "gets the path of the sidecar index of a BTF file", py::arg("btf_path"));
+
+    py::class_<btf::BtfIndexBlock>(m, "BtfIndexBlock")
+        .def_readonly("offset_", &btf::BtfIndexBlock::offset_)
+        .def_readonly("size_", &btf::BtfIndexBlock::size_)
+        .def_readonly("number_of_lines_", &btf::BtfIndexBlock::number_of_lines_)
+        .def_readonly("min_time_", &btf::BtfIndexBlock::min_time_)
+        .def_readonly("max_time_", &btf::BtfIndexBlock::max_time_)
+        .def_readonly("checksum_", &btf::BtfIndexBlock::checksum_)
+        .def("mayContainEntity", &btf::BtfIndexBlock::mayContainEntity, "checks if the block may contain events of an entity", py::arg("entity_hash"));
+
+    py::class_<btf::BtfIndex>(m, "BtfIndex")
+        .def(py::init<>())
+        .def("load", &btf::BtfIndex::load, "loads the sidecar index of a BTF file and validates it against the file", py::arg("btf_path"),
+             py::arg("verify_all_blocks") = false)
+        .def("getBlocks", &btf::BtfIndex::getBlocks, "gets all blocks")
+        .def("getEntityNames", &btf::BtfIndex::getEntityNames, "gets the entity name table")
+        .def("findBlocks", &btf::BtfIndex::findBlocks, "finds the blocks that may contain events in [start_time, end_time) of the entities",
+             py::arg("start_time"), py::arg("end_time"), py::arg("entities") = std::vector<std::string>{})
+        .def(
+            "readBlock",
+            [](const btf::BtfIndex& index, const std::string& btf_path, size_t block) -> std::optional<std::string> {
+                std::ifstream file(btf_path, std::ios::binary);
+                std::string lines;
+                if (!index.readBlock(file, block, lines))
+                {
+                    return std::nullopt;
+                }
+                return lines;
+            },
+            "reads the lines of a block from the BTF file, None if the checksum does not match", py::arg("btf_path"), py::arg("block"));
+
+    py::class_<PyBtfRecord>(m, "BtfRecord")
+        .def_readonly("time_", &PyBtfRecord::time_)
+        .def_readonly("source_", &PyBtfRecord::source_)
+        .def_readonly("source_instance_", &PyBtfRecord::source_instance_)
+        .def_readonly("type_", &PyBtfRecord::type_)
+        .def_readonly("target_", &PyBtfRecord::target_)
+        .def_readonly("target_instance_", &PyBtfRecord::target_instance_)
+        .def_readonly("event_name_", &PyBtfRecord::event_name_)
+        .def_readonly("note_", &PyBtfRecord::note_);
+
+    py::class_<btf::BtfReader>(m, "BtfReader")
+        .def(py::init<const std::string&, char>(), py::arg("path"), py::arg("delimiter") = ',')
+        .def(
+            "__iter__", [](btf::BtfReader& reader) -> btf::BtfReader& { return reader; }, "iterates over the records from the current position",
+            py::return_value_policy::reference_internal)
+        .def("__next__",
+             [](btf::BtfReader& reader) {
+                 // the record is copied before the reader reuses its line buffer
+                 btf::BtfRecord record;
+                 if (!reader.readRecord(record))
+                 {
+                     throw py::stop_iteration();
+                 }
+                 return PyBtfRecord{record.time_,           std::string(record.source_), record.source_instance_,
+                                    record.type_,           std::string(record.target_), record.target_instance_,
+                                    std::string(record.event_name_), std::string(record.note_)};
+             })
+        .def("getNumberOfSkippedLines", &btf::BtfReader::getNumberOfSkippedLines, "gets the number of lines that could not be decoded")
+        .def("getHeader", &btf::BtfReader::getHeader, "gets the header of the file")
+        .def("getFileSize", &btf::BtfReader::getFileSize, "gets the size of the file in bytes")
+        .def("getDataOffset", &btf::BtfReader::getDataOffset, "gets the byte offset of the first line after the header")
+        .def("seekToTime", &btf::BtfReader::seekToTime, "finds the byte offset of the first event at or after the timestamp by bisection",
+             py::arg("time"));
+    m.def("extractWindow", &btf::extractWindow, "copies the header and the events in [start_time, end_time] into a new BTF file", py::arg("btf_path"),
+          py::arg("output_path"), py::arg("start_time"), py::arg("end_time"));
+
     py::class_<btf::BtfFile> btfFile(m, "BtfFile");
 
     py::enum_<btf::BtfFile::TimeScales>(btfFile, "Timescale")
@@ -139,8 +416,18 @@ PYBIND11_MODULE(pybtf, m) // NOLINT
 
     btfFile.def(py::init<std::string, btf::BtfFile::TimeScales, bool, bool, bool, bool>())
         .def("finish", static_cast<void (btf::BtfFile::*)()>(&btf::BtfFile::finish), "write the BTF to file")
-        .def("importFromFile", &btf::BtfFile::importFromFile, "Appends the data from a BTF file. For now only importing into a empty BTF is supported.",
-             py::arg("path"), py::arg("delimiter") = ',')
+        .def("checkpoint", &btf::BtfFile::checkpoint, "writes the conversion state into a snapshot", py::arg("path"))
+        .def("restore", &btf::BtfFile::restore, "replaces the conversion state by a snapshot of checkpoint", py::arg("path"))
+        .def("openForAppend", &btf::BtfFile::openForAppend, "prepares appending new events to the existing BTF file")
+        .def("importFromFile", &btf::BtfFile::importFromFile, "Appends the data from a BTF file. For now only importing into a empty BTF is supported. Returns the import summary.",
+             py::arg("path"), py::arg("delimiter") = ',', py::arg("max_samples_per_category") = 5, py::arg("filter") = btf::ImportFilter())
+        .def("importFromSource", &btf::BtfFile::importFromSource, "Appends the data from an input source, e.g. the standard input. Returns the import summary.",
+             py::arg("source"), py::arg("delimiter") = ',', py::arg("max_samples_per_category") = 5, py::arg("filter") = btf::ImportFilter(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("importFromFileParallel", &btf::BtfFile::importFromFileParallel,
+             "Appends the data from a BTF file, time partitions of the file are converted in parallel and stitched. Returns the summary.",
+             py::arg("path"), py::arg("number_of_partitions") = 0, py::arg("delimiter") = ',', py::arg("max_samples_per_category") = 5,
+             py::call_guard<py::gil_scoped_release>())
         .def("setStringHashMap", &btf::BtfFile::setStringHashMap,
              "set the id name translation map. Be carefully using this with events that uses the names instead of ids", py::arg("hash_map"))
         .def("coreEvent", static_cast<btf::ErrorCodes (btf::BtfFile::*)(uint64_t, const std::string&, btf::Core::Events)>(&btf::BtfFile::coreEvent),
@@ -215,6 +502,29 @@ PYBIND11_MODULE(pybtf, m) // NOLINT
         //.def("getEntityEvents", &btf::BtfFile::getEntityEvents, "returns the list of events for a entity",
         //     py::arg("entity"))
         .def("getAllEvents", &btf::BtfFile::getAllEvents, "returns a list of all events")
+        .def(
+            "viewAllEvents",
+            [](const btf::BtfFile& btf_file) {
+                auto view = btf_file.viewAllEvents();
+                return py::make_iterator(view.begin(), view.end());
+            },
+            "returns an iterator over all events without copying them", py::keep_alive<0, 1>())
+        .def(
+            "eventsInRange",
+            [](const btf::BtfFile& btf_file, uint64_t start_time, uint64_t end_time) {
+                auto range = btf_file.eventsInRange(start_time, end_time);
+                return py::make_iterator(range.begin(), range.end());
+            },
+            "returns an iterator over the events with a timestamp in [start_time, end_time) and the comments between them", py::arg("start_time"),
+            py::arg("end_time"), py::keep_alive<0, 1>())
+        .def(
+            "eventsInRange",
+            [](btf::BtfFile& btf_file, size_t entity_hash, uint64_t start_time, uint64_t end_time) {
+                const auto range = btf_file.eventsInRange(entity_hash, start_time, end_time);
+                return std::vector<btf::BtfEntry>(range.begin(), range.end());
+            },
+            "returns a list of the events of an entity with a timestamp in [start_time, end_time)", py::arg("entity_hash"), py::arg("start_time"),
+            py::arg("end_time"))
         .def("getNumberOfAllEvents", &btf::BtfFile::getNumberOfAllEvents, "returns the number of all events")
         .def("simulationEventProcessName",
              static_cast<btf::ErrorCodes (btf::BtfFile::*)(uint64_t, const std::string&, const std::string&)>(&btf::BtfFile::simulationEventProcessName),
@@ -241,7 +551,69 @@ PYBIND11_MODULE(pybtf, m) // NOLINT
         .def("simulationEventThreadCreation",
              static_cast<btf::ErrorCodes (btf::BtfFile::*)(uint64_t, size_t, uint64_t, uint64_t)>(&btf::BtfFile::simulationEventThreadCreation),
              "emits a thread creation event, e.g. TID and PID mapping to a thread", py::arg("time"), py::arg("thread_hash"), py::arg("tid"), py::arg("pid"))
-        .def("setIgnoreMultipleTaskReleases", &btf::BtfFile::setIgnoreMultipleTaskReleases, "sets the option to ignore multiple release events on tasks", py::arg("value"));
+        .def("setIgnoreMultipleTaskReleases", &btf::BtfFile::setIgnoreMultipleTaskReleases, "sets the option to ignore multiple release events on tasks", py::arg("value"))
+        .def("setErrorSink", &btf::BtfFile::setErrorSink,
+             "sets a callback (error, rejected_entry, is_generated) that receives the errors of all emit calls, None removes it", py::arg("error_sink"))
+        .def("hashName", &btf::BtfFile::hashName, "hashes an entity name with the hasher of the file", py::arg("name"))
+        .def("setOutputCompression", &btf::BtfFile::setOutputCompression, "sets the compression of the file written by finish()", py::arg("compression"),
+             py::arg("block_size") = size_t{4} << 20U)
+        .def("setOutputRotation", &btf::BtfFile::setOutputRotation, "sets the limits of the parts the output of finish() is split into", py::arg("rotation"))
+        .def("setSplitByCore", &btf::BtfFile::setSplitByCore, "sets the option that finish() writes one file per core", py::arg("value"))
+        .def("setWriteStateTrailer", &btf::BtfFile::setWriteStateTrailer, "sets the option that finish() writes a state trailer for appending",
+             py::arg("value"))
+        .def("setStateKeyframes", &btf::BtfFile::setStateKeyframes, "sets the intervals of the state keyframes written by finish()",
+             py::arg("event_interval"), py::arg("time_interval") = 0)
+        .def("setWriteSidecarIndex", &btf::BtfFile::setWriteSidecarIndex, "sets the option to write a sidecar index in finish", py::arg("value"))
+        .def("reset", &btf::BtfFile::reset, "discards the events and the conversion state to convert another trace", py::arg("path"));
+
+    py::class_<btf::BatchConversionOptions>(m, "BatchConversionOptions")
+        .def(py::init<>())
+        .def_readwrite("time_scale_", &btf::BatchConversionOptions::time_scale_)
+        .def_readwrite("auto_suspend_parent_runnable_", &btf::BatchConversionOptions::auto_suspend_parent_runnable_)
+        .def_readwrite("source_is_core_", &btf::BatchConversionOptions::source_is_core_)
+        .def_readwrite("auto_generate_core_events_", &btf::BatchConversionOptions::auto_generate_core_events_)
+        .def_readwrite("auto_wait_resume_os_events_", &btf::BatchConversionOptions::auto_wait_resume_os_events_)
+        .def_readwrite("delimiter_", &btf::BatchConversionOptions::delimiter_)
+        .def_readwrite("max_samples_per_category_", &btf::BatchConversionOptions::max_samples_per_category_)
+        .def_readwrite("output_compression_", &btf::BatchConversionOptions::output_compression_)
+        .def_readwrite("number_of_threads_", &btf::BatchConversionOptions::number_of_threads_)
+        .def_readwrite("cache_directory_", &btf::BatchConversionOptions::cache_directory_)
+        .def_readwrite("cache_max_size_", &btf::BatchConversionOptions::cache_max_size_)
+        .def_readwrite("link_cached_outputs_", &btf::BatchConversionOptions::link_cached_outputs_);
+    py::class_<btf::BatchJob>(m, "BatchJob")
+        .def(py::init<std::string, std::string>(), py::arg("input_path"), py::arg("output_path"))
+        .def_readwrite("input_path_", &btf::BatchJob::input_path_)
+        .def_readwrite("output_path_", &btf::BatchJob::output_path_);
+    py::class_<btf::BatchJobResult>(m, "BatchJobResult")
+        .def_readonly("job_", &btf::BatchJobResult::job_)
+        .def_readonly("is_success_", &btf::BatchJobResult::is_success_)
+        .def_readonly("error_", &btf::BatchJobResult::error_)
+        .def_readonly("import_", &btf::BatchJobResult::import_)
+        .def_readonly("is_cache_hit_", &btf::BatchJobResult::is_cache_hit_)
+        .def_readonly("seconds_", &btf::BatchJobResult::seconds_);
+    py::class_<btf::ConversionCache>(m, "ConversionCache")
+        .def(py::init<std::string, uint64_t>(), py::arg("directory"), py::arg("max_size") = 0)
+        .def_static("computeKey", &btf::ConversionCache::computeKey, "computes the key of a conversion from the input file and the options",
+                    py::arg("input_path"), py::arg("options"))
+        .def("setLinkOutputs", &btf::ConversionCache::setLinkOutputs, "sets the option to link the restored output files", py::arg("value"))
+        .def(
+            "fetch",
+            [](btf::ConversionCache& cache, uint64_t key, const std::vector<std::string>& output_paths) -> std::optional<btf::ImportSummary> {
+                btf::ImportSummary summary;
+                if (!cache.fetch(key, output_paths, summary))
+                {
+                    return std::nullopt;
+                }
+                return summary;
+            },
+            "restores the output files of a conversion, returns the import summary counts or None", py::arg("key"), py::arg("output_paths"))
+        .def("store", &btf::ConversionCache::store, "adds the output files of a conversion to the cache", py::arg("key"), py::arg("output_paths"),
+             py::arg("summary") = btf::ImportSummary())
+        .def("getSize", &btf::ConversionCache::getSize, "gets the size of all entries");
+    m.def("getLibraryVersion", &btf::getLibraryVersion, "gets the version of the library");
+    m.def("convertBatch", &btf::convertBatch, "converts many BTF files concurrently, returns the result of every job", py::arg("jobs"),
+          py::arg("options") = btf::BatchConversionOptions(), py::arg("on_job_finished") = std::function<void(const btf::BatchJobResult&)>(),
+          py::call_guard<py::gil_scoped_release>());
 
     init_pybtfhelper(m);
 }
@@ -6,10 +6,22 @@
  * SPDX-License-Identifier: MIT
 */
 
+#include "btf/batch_conversion.h"
 #include "btf/btf.h"
+#include "btf/btf_reader.h"
+#include "btf/compression.h"
+#include "btf/conversion_cache.h"
+#include "btf/entity_hash.h"
+#include "btf/state_keyframes.h"
 
 #include <catch2/catch.hpp>
 
+#include <thread>
+
+#ifdef BTF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 std::string readBtf(const std::string& path)
 {
     std::string out;
@@ -32,6 +44,33 @@ std::string readBtf(const std::string& path)
     return out;
 }
 
+// writes a snapshot of BtfFile::checkpoint() with a valid checksum around arbitrary contents
+void writeSnapshot(const std::string& path, const std::string& content)
+{
+    std::string checksum(8, '\0');
+    const uint64_t value = btf::hashEntityName(content);
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        checksum[i] = static_cast<char>((value >> (8U * i)) & 0xffU);
+    }
+    std::ofstream file(path, std::ios::binary);
+    file << "BTFCKP01" << content << checksum;
+}
+
+// emits alternating execute and idle events on the cores (one event per time unit, the cores take turns), returns the last timestamp
+uint64_t emitCoreEvents(btf::BtfFile& btf, const std::vector<std::string>& cores, uint64_t events_per_core)
+{
+    uint64_t time = 0;
+    for (uint64_t i = 0; i < events_per_core; ++i)
+    {
+        for (const auto& core : cores)
+        {
+            REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, core, i % 2 == 0 ? btf::Core::Events::execute : btf::Core::Events::idle));
+        }
+    }
+    return time;
+}
+
 TEST_CASE("Simple test (Source is Core)", "[libBtf]")
 {
     btf::BtfFile btf("test.btf");
@@ -1041,9 +1080,1827 @@ TEST_CASE("Semaphore (source is Process)", "[libBtf]")
     REQUIRE(should_be == data);
 }
 
+TEST_CASE("Import diagnostics", "[libBtf]")
+{
+    {
+        std::ofstream faulty("faulty.btf");
+        faulty << "#version 2.2.1\n"
+                  "#creator libBtf\n"
+                  "#timescale ns\n"
+                  "100,Core1,0,C,Core1,0,execute\n"
+                  "200,Core1,0,T,Task1,0,start\n"
+                  "this is not a btf line\n"
+                  "abc,Core1,0,T,Task1,0,start\n"
+                  "300,Core1,0,XYZ,Foo,0,start\n";
+        for (int i = 0; i < 8; ++i)
+        {
+            faulty << 300 + i << ",Core1,0,T,Task1,0,fly\n";
+        }
+        faulty << "400,Core1,0,T,Task1,0,start\n"
+                  "500,Task1,0,SEM,Sem1,0,lock,xyz\n";
+    }
+
+    btf::BtfFile importbtf("importtest.btf");
+    auto summary = importbtf.importFromFile("faulty.btf", ',', 2);
+    importbtf.finish();
+
+    REQUIRE(summary.lines_ == 15);
+    REQUIRE(summary.rejected_lines_ == 13);
+    REQUIRE(summary.categories_.size() == 6);
+
+    REQUIRE(summary.categories_[0].issue_ == btf::ImportIssues::invalid_format);
+    REQUIRE(summary.categories_[0].count_ == 1);
+    REQUIRE(summary.categories_[0].sample_lines_ == std::vector<std::string>{"this is not a btf line"});
+
+    REQUIRE(summary.categories_[1].issue_ == btf::ImportIssues::invalid_number);
+    REQUIRE(summary.categories_[1].type_ == btf::EntityTypes::task);
+
+    REQUIRE(summary.categories_[2].issue_ == btf::ImportIssues::unknown_entity_type);
+    REQUIRE(summary.categories_[2].event_ == "XYZ");
+
+    REQUIRE(summary.categories_[3].issue_ == btf::ImportIssues::unknown_event);
+    REQUIRE(summary.categories_[3].event_ == "fly");
+    REQUIRE(summary.categories_[3].count_ == 8);
+    REQUIRE(summary.categories_[3].sample_lines_.size() == 2);
+    REQUIRE(summary.categories_[3].sample_lines_[1] == "301,Core1,0,T,Task1,0,fly");
+
+    REQUIRE(summary.categories_[4].issue_ == btf::ImportIssues::rejected_event);
+    REQUIRE(summary.categories_[4].error_ != btf::ErrorCodes::success);
+
+    REQUIRE(summary.categories_[5].issue_ == btf::ImportIssues::invalid_number);
+    REQUIRE(summary.categories_[5].type_ == btf::EntityTypes::semaphore);
+
+    std::string should_be = "#version 2.2.1\n"
+                            "#creator libBtf\n"
+                            "#timescale ns\n"
+                            "100,Core1,0,C,Core1,0,execute\n"
+                            "200,Core1,0,T,Task1,0,start\n";
+    REQUIRE(should_be == readBtf("importtest.btf"));
+}
+
+TEST_CASE("Selective import", "[libBtf]")
+{
+    {
+        std::ofstream trace("selective.btf");
+        trace << "#version 2.2.1\n"
+                 "#creator libBtf\n"
+                 "#timescale ns\n"
+                 "100,Core1,0,C,Core1,0,execute\n"
+                 "200,Core1,0,T,Task1,0,start\n"
+                 "250,Task1,0,R,Runnable0,0,start\n"
+                 "260,Task1,0,R,Runnable0,0,terminate\n"
+                 "300,Task1,0,R,Runnable1,0,start\n"
+                 "350,Task1,0,R,Runnable1,0,terminate\n"
+                 "400,Task1,0,R,Runnable2,0,start\n"
+                 "410,Task1,0,R,Runnable2,0,terminate\n"
+                 "450,Task1,0,R,Runnable1,0,start\n"
+                 "480,Task1,0,R,Runnable1,0,terminate\n"
+                 "490,Core1,0,T,Task1,0,terminate\n"
+                 "600,Core1,0,T,Task1,0,start\n"
+                 "700,Core1,0,T,Task1,0,terminate\n";
+    }
+
+    btf::ImportFilter filter;
+    filter.setEntityTypes({btf::EntityTypes::runnable});
+    filter.addEntity("Runnable1");
+    filter.setTimeWindow(300, 500);
+
+    // the task and the core are forced, the import stops at the first event after the window
+    btf::BtfFile importbtf("importtest.btf", btf::BtfFile::TimeScales::nano_seconds, false, false);
+    auto summary = importbtf.importFromFile("selective.btf", ',', 5, filter);
+    importbtf.finish();
+
+    REQUIRE(summary.lines_ == 12);
+    REQUIRE(summary.filtered_lines_ == 5);
+    REQUIRE(summary.rejected_lines_ == 0);
+
+    std::string should_be = "#version 2.2.1\n"
+                            "#creator libBtf\n"
+                            "#timescale ns\n"
+                            "100,Core1,0,C,Core1,0,execute\n"
+                            "200,Core1,0,T,Task1,0,start\n"
+                            "300,Task1,0,R,Runnable1,0,start\n"
+                            "350,Task1,0,R,Runnable1,0,terminate\n"
+                            "450,Task1,0,R,Runnable1,1,start\n"
+                            "480,Task1,0,R,Runnable1,1,terminate\n"
+                            "490,Core1,0,T,Task1,0,terminate\n";
+    REQUIRE(should_be == readBtf("importtest.btf"));
+
+    // without the dependencies, only the selected runnable events are passed to the BtfFile
+    filter.setIncludeDependencies(false);
+    btf::BtfFile importbtf2("importtest.btf", btf::BtfFile::TimeScales::nano_seconds, false, false);
+    summary = importbtf2.importFromFile("selective.btf", ',', 5, filter);
+    REQUIRE(summary.lines_ == 13);
+    REQUIRE(summary.filtered_lines_ == 9);
+}
+
+TEST_CASE("Line scanner", "[libBtf]")
+{
+    std::string block;
+    for (int i = 0; i < 100; ++i)
+    {
+        block += std::to_string(i * 100) + ",Core1,0,T,Task" + std::to_string(i) + ",0,start\n";
+        block += std::string(static_cast<size_t>(i % 37), 'x') + "\n";
+        block += "1,2,3,4,5,6,7,8,9,10\r\n";
+    }
+    block += "500,Core1,0,T,Task1";
+
+    std::vector<btf::LineFields> lines;
+    auto consumed = btf::scanLines(block, ',', lines, btf::LineScanners::scalar);
+    REQUIRE(consumed == block.rfind('\n') + 1);
+    REQUIRE(lines.size() == 300);
+    REQUIRE(block.substr(lines[0].offset_, lines[0].size_) == "0,Core1,0,T,Task0,0,start");
+    REQUIRE(lines[0].number_of_delimiters_ == 6);
+    REQUIRE(lines[0].delimiters_[3] == 11);
+    REQUIRE(lines[2].number_of_delimiters_ == 8);
+    REQUIRE(lines[2].delimiters_[7] == 15);
+
+    for (auto scanner : {btf::LineScanners::sse2, btf::LineScanners::avx2})
+    {
+        if (!btf::isLineScannerSupported(scanner))
+        {
+            continue;
+        }
+        std::vector<btf::LineFields> simd_lines;
+        REQUIRE(btf::scanLines(block, ',', simd_lines, scanner) == consumed);
+        REQUIRE(simd_lines.size() == lines.size());
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            REQUIRE(simd_lines[i].offset_ == lines[i].offset_);
+            REQUIRE(simd_lines[i].size_ == lines[i].size_);
+            REQUIRE(simd_lines[i].number_of_delimiters_ == lines[i].number_of_delimiters_);
+            REQUIRE(simd_lines[i].delimiters_ == lines[i].delimiters_);
+        }
+    }
+}
+
+TEST_CASE("Input sources", "[libBtf]")
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+    {
+        data += "line " + std::to_string(i) + "\n";
+    }
+    data += std::string(70000, 'x') + "\nlast";
+
+    // lines are reassembled from small blocks, including one that is longer than the space in front of a block
+    btf::MemoryInputSource memory(data);
+    btf::PrefetchReader reader(memory, 7, 2);
+    std::vector<std::string> lines;
+    std::string_view block;
+    size_t keep{0};
+    while (reader.next(block, keep))
+    {
+        size_t begin{0};
+        for (auto end = block.find('\n'); end != std::string_view::npos; end = block.find('\n', begin))
+        {
+            lines.emplace_back(block.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        keep = block.size() - begin;
+    }
+    REQUIRE(lines.size() == 1001);
+    REQUIRE(lines[999] == "line 999");
+    REQUIRE(lines[1000] == std::string(70000, 'x'));
+    REQUIRE(block == "last");
+
+    REQUIRE_THROWS_AS(btf::FileInputSource("does_not_exist.btf"), std::runtime_error);
+
+    // import from memory equals the import from file
+    const std::string trace = "#version 2.2.1\n"
+                              "#creator libBtf\n"
+                              "#timescale ns\n"
+                              "100,Core1,0,C,Core1,0,execute\n"
+                              "200,Core1,0,T,Task1,0,start\n"
+                              "300,Core1,0,T,Task1,0,terminate";
+    btf::MemoryInputSource trace_source(trace);
+    btf::BtfFile importbtf("importtest.btf");
+    auto summary = importbtf.importFromSource(trace_source);
+    importbtf.finish();
+    REQUIRE(summary.lines_ == 3);
+    REQUIRE(summary.rejected_lines_ == 0);
+    REQUIRE(readBtf("importtest.btf") == trace + "\n");
+}
+
+TEST_CASE("Compressed input", "[libBtf]")
+{
+    const std::string trace = "#version 2.2.1\n"
+                              "#creator libBtf\n"
+                              "#timescale ns\n"
+                              "100,Core1,0,C,Core1,0,execute\n"
+                              "200,Core1,0,T,Task1,0,start\n"
+                              "300,Core1,0,T,Task1,0,terminate\n";
+
+    // plain text is passed through
+    auto plain = std::make_unique<btf::MemoryInputSource>(trace);
+    btf::DecompressingInputSource passthrough(std::move(plain));
+    REQUIRE(passthrough.getCompression() == btf::Compressions::none);
+    std::string data(trace.size() + 1, '\0');
+    REQUIRE(passthrough.read(data.data(), 2) == 2);
+    REQUIRE(passthrough.read(data.data() + 2, data.size() - 2) == trace.size() - 2);
+    REQUIRE(data.substr(0, trace.size()) == trace);
+
+    REQUIRE(btf::detectCompression(std::string_view("\x28\xb5\x2f\xfd", 4)) == btf::Compressions::zstd);
+    if (!btf::isCompressionSupported(btf::Compressions::zstd))
+    {
+        const std::string zstd_magic("\x28\xb5\x2f\xfd", 4);
+        REQUIRE_THROWS_AS(btf::DecompressingInputSource(std::make_unique<btf::MemoryInputSource>(zstd_magic)), std::runtime_error);
+    }
+
+#ifdef BTF_HAVE_ZLIB
+    // two concatenated gzip members
+    for (const char* mode : {"wb", "ab"})
+    {
+        gzFile gz = gzopen("compressed.btf.gz", mode);
+        const auto half = mode[0] == 'w' ? trace.substr(0, 60) : trace.substr(60);
+        gzwrite(gz, half.data(), static_cast<unsigned>(half.size()));
+        gzclose(gz);
+    }
+    btf::BtfFile importbtf("importtest.btf");
+    auto summary = importbtf.importFromFile("compressed.btf.gz");
+    importbtf.finish();
+    REQUIRE(summary.lines_ == 3);
+    REQUIRE(readBtf("importtest.btf") == trace);
+
+    // truncated input
+    std::ifstream compressed_file("compressed.btf.gz", std::ios::binary);
+    const std::string compressed((std::istreambuf_iterator<char>(compressed_file)), std::istreambuf_iterator<char>());
+    btf::DecompressingInputSource truncated(std::make_unique<btf::MemoryInputSource>(std::string_view(compressed).substr(0, 20)));
+    REQUIRE(truncated.getCompression() == btf::Compressions::gzip);
+    REQUIRE_THROWS_AS(truncated.read(data.data(), data.size()), std::runtime_error);
+#endif
+}
+
+TEST_CASE("Compressed output", "[libBtf]")
+{
+    const auto emit = [](btf::BtfFile& btf) {
+        btf.coreEvent(0, "Core1", btf::Core::Events::execute);
+        for (uint64_t i = 0; i < 100; ++i)
+        {
+            btf.processEvent(100 * i + 10, "Core1", "Task" + std::to_string(i), 0, btf::Process::Events::start);
+            btf.processEvent(100 * i + 50, "Core1", "Task" + std::to_string(i), 0, btf::Process::Events::terminate);
+        }
+    };
+    btf::BtfFile plain_btf("plain.btf");
+    emit(plain_btf);
+    plain_btf.finish();
+    std::ifstream plain_file("plain.btf", std::ios::binary);
+    const std::string plain((std::istreambuf_iterator<char>(plain_file)), std::istreambuf_iterator<char>());
+
+    btf::BtfFile btf("compressed.btf.gz");
+    REQUIRE(btf.setOutputCompression(btf::Compressions::none));
+    if (!btf.setOutputCompression(btf::Compressions::gzip, 256))
+    {
+        return;
+    }
+    emit(btf);
+    btf.finish();
+
+    // the concatenated gzip members decode to the plain file
+    auto source = btf::openInputSource("compressed.btf.gz");
+    std::string decoded(plain.size() + 1, '\0');
+    size_t size{0};
+    for (size_t n = 1; n > 0; size += n)
+    {
+        n = source->read(decoded.data() + size, decoded.size() - size);
+    }
+    REQUIRE(decoded.substr(0, size) == plain);
+
+    // random access through the block table
+    btf::CompressedBtfFile compressed;
+    REQUIRE(compressed.load("compressed.btf.gz"));
+    REQUIRE(compressed.getCompression() == btf::Compressions::gzip);
+    const auto& blocks = compressed.getBlocks();
+    REQUIRE(blocks.size() > 10);
+    REQUIRE(blocks.back().uncompressed_offset_ + blocks.back().uncompressed_size_ == plain.size());
+    REQUIRE(blocks.back().last_time_ == 9950);
+
+    const auto block = compressed.findBlock(5000);
+    REQUIRE(block < blocks.size());
+    REQUIRE(blocks[block].first_time_ <= 5010);
+    REQUIRE(blocks[block].last_time_ >= 5000);
+    std::string lines;
+    REQUIRE(compressed.readBlock(block, lines));
+    REQUIRE(lines == plain.substr(blocks[block].uncompressed_offset_, blocks[block].uncompressed_size_));
+    REQUIRE(lines.find("5010,Core1,0,T,") != std::string::npos);
+    REQUIRE(compressed.findBlock(10000) == blocks.size());
+}
+
+TEST_CASE("Output rotation", "[libBtf]")
+{
+    REQUIRE(btf::getRotationPartPath("dir/trace.btf", 3) == "dir/trace.003.btf");
+    REQUIRE(btf::getRotationPartPath("trace.btf.gz", 12) == "trace.012.btf.gz");
+    REQUIRE(btf::getRotationManifestPath("dir/trace.btf") == "dir/trace.manifest.json");
+
+    const auto emit = [](btf::BtfFile& btf) {
+        btf.coreEvent(0, "Core1", btf::Core::Events::execute);
+        for (uint64_t i = 0; i < 100; ++i)
+        {
+            btf.processEvent(100 * i + 10, "Core1", "RotatedTask" + std::to_string(i), 0, btf::Process::Events::start);
+            btf.processEvent(100 * i + 50, "Core1", "RotatedTask" + std::to_string(i), 0, btf::Process::Events::terminate);
+        }
+    };
+
+    // time window: one part per 1000 ns
+    btf::BtfFile btf("rotated.btf");
+    btf::OutputRotation rotation;
+    rotation.time_window_ = 1000;
+    btf.setOutputRotation(rotation);
+    emit(btf);
+    btf.finish();
+    for (size_t i = 0; i < 10; ++i)
+    {
+        std::ifstream part(btf::getRotationPartPath("rotated.btf", i));
+        REQUIRE(part.good());
+        std::string line;
+        std::getline(part, line);
+        REQUIRE(line.rfind("#version", 0) == 0);
+    }
+    REQUIRE_FALSE(std::ifstream(btf::getRotationPartPath("rotated.btf", 10)).good());
+
+    std::ifstream manifest_file(btf::getRotationManifestPath("rotated.btf"));
+    const std::string manifest((std::istreambuf_iterator<char>(manifest_file)), std::istreambuf_iterator<char>());
+    REQUIRE(manifest.find("\"path\": \"rotated.000.btf\"") != std::string::npos);
+    REQUIRE(manifest.find("\"path\": \"rotated.009.btf\"") != std::string::npos);
+    REQUIRE(manifest.find("\"first_time\": 9010, \"last_time\": 9950") != std::string::npos);
+
+    // the part names are escaped in the manifest
+    REQUIRE(btf::writeRotationManifest("escaped.btf", {{"dir/a\"b\td.000.btf", 1, 2, 3, 4}}));
+    std::ifstream escaped_file(btf::getRotationManifestPath("escaped.btf"));
+    const std::string escaped((std::istreambuf_iterator<char>(escaped_file)), std::istreambuf_iterator<char>());
+    REQUIRE(escaped.find(R"("path": "a\"b\u0009d.000.btf")") != std::string::npos);
+
+    // each part can be imported on its own
+    btf::BtfFile part_btf("part.btf");
+    const auto summary = part_btf.importFromFile(btf::getRotationPartPath("rotated.btf", 4));
+    REQUIRE(summary.lines_ > 0);
+    REQUIRE(summary.rejected_lines_ == 0);
+
+    // event limit: parts are only cut between timestamps
+    btf::BtfFile limited_btf("limited.btf");
+    rotation = {};
+    rotation.max_events_ = 7;
+    limited_btf.setOutputRotation(rotation);
+    emit(limited_btf);
+    limited_btf.finish();
+    size_t number_of_lines{0};
+    size_t number_of_parts{0};
+    uint64_t last_time{0};
+    for (; std::ifstream(btf::getRotationPartPath("limited.btf", number_of_parts)).good(); ++number_of_parts)
+    {
+        std::ifstream part(btf::getRotationPartPath("limited.btf", number_of_parts));
+        std::string line;
+        uint64_t first_time{0};
+        bool is_first_event{true};
+        while (std::getline(part, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            const uint64_t time = std::stoull(line);
+            if (is_first_event)
+            {
+                first_time = time;
+                is_first_event = false;
+            }
+            last_time = time;
+            ++number_of_lines;
+        }
+        REQUIRE((number_of_parts == 0 || first_time > 0));
+    }
+    REQUIRE(number_of_parts > 1);
+    REQUIRE(last_time == 9950);
+
+    std::ifstream plain_file("limited.btf");
+    REQUIRE_FALSE(plain_file.good());
+    btf::BtfFile plain_btf("plain.btf");
+    emit(plain_btf);
+    plain_btf.finish();
+    std::ifstream plain("plain.btf");
+    size_t number_of_plain_lines{0};
+    for (std::string line; std::getline(plain, line);)
+    {
+        number_of_plain_lines += !line.empty() && line[0] != '#' ? 1 : 0;
+    }
+    REQUIRE(number_of_lines == number_of_plain_lines);
+}
+
+TEST_CASE("Split by core", "[libBtf]")
+{
+    REQUIRE(btf::getCoreSplitPath("dir/trace.btf", "Core1") == "dir/trace.Core1.btf");
+    REQUIRE(btf::getCoreSplitPath("trace.btf.gz", "Cpu 0/1") == "trace.Cpu_0_1.btf.gz");
+
+    btf::BtfFile btf("split.btf");
+    btf.setSplitByCore(true);
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(100, "Core1", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(200, "Core1", "Task1", 0, btf::Process::Events::start));
+    REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(300, "Core1", "Runnable1", btf::Runnable::Events::start));
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(300, "Core2", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(300, "Core2", "Task2", 0, btf::Process::Events::start));
+    REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(400, "Core1", "Runnable1", btf::Runnable::Events::terminate));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(500, "Core1", "Task1", 0, btf::Process::Events::wait));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(600, "Core2", "Task2", 0, btf::Process::Events::terminate));
+    REQUIRE(btf::ErrorCodes::success == btf.taskMigrationEvent(700, "Core1", "Core2", "Task1", 0));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(700, "Core2", "Task1", 0, btf::Process::Events::release));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(800, "Core2", "Task1", 0, btf::Process::Events::resume));
+    REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(900, "Core2", "Runnable2", btf::Runnable::Events::start));
+    REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(1000, "Core2", "Runnable2", btf::Runnable::Events::terminate));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(1100, "Core2", "Task1", 0, btf::Process::Events::terminate));
+    btf.finish();
+
+    REQUIRE_FALSE(std::ifstream("split.btf").good());
+    std::string should_be = "#version 2.2.1\n"
+                            "#creator libBtf\n"
+                            "#timescale ns\n"
+                            "100,Core1,0,C,Core1,0,execute\n"
+                            "200,Core1,0,T,Task1,0,start\n"
+                            "300,Task1,0,R,Runnable1,0,start\n"
+                            "400,Task1,0,R,Runnable1,0,terminate\n"
+                            "500,Core1,0,T,Task1,0,wait\n"
+                            "700,Core1,0,T,Task1,0,enforcedmigration\n";
+    REQUIRE(should_be == readBtf("split.Core1.btf"));
+
+    should_be = "#version 2.2.1\n"
+                "#creator libBtf\n"
+                "#timescale ns\n"
+                "300,Core2,0,C,Core2,0,execute\n"
+                "300,Core2,0,T,Task2,0,start\n"
+                "600,Core2,0,T,Task2,0,terminate\n"
+                "700,Core2,0,T,Task1,0,fullmigration\n"
+                "700,Core2,0,T,Task1,0,release\n"
+                "800,Core2,0,T,Task1,0,resume\n"
+                "900,Task1,0,R,Runnable2,0,start\n"
+                "1000,Task1,0,R,Runnable2,0,terminate\n"
+                "1100,Core2,0,T,Task1,0,terminate\n";
+    REQUIRE(should_be == readBtf("split.Core2.btf"));
+
+    // core names that map to the same file name get distinct files
+    btf::BtfFile collision("collision.btf");
+    collision.setSplitByCore(true);
+    REQUIRE(btf::ErrorCodes::success == collision.coreEvent(100, "Core 1", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == collision.coreEvent(200, "Core_1", btf::Core::Events::execute));
+    collision.finish();
+    REQUIRE(readBtf("collision.Core_1.btf") == "#version 2.2.1\n#creator libBtf\n#timescale ns\n100,Core 1,0,C,Core 1,0,execute\n");
+    const auto other_path = "collision.Core_1_" + std::to_string(btf::hashEntityName("Core_1")) + ".btf";
+    REQUIRE(readBtf(other_path) == "#version 2.2.1\n#creator libBtf\n#timescale ns\n200,Core_1,0,C,Core_1,0,execute\n");
+}
+
+TEST_CASE("Checkpoint and restore", "[libBtf]")
+{
+    const std::vector<std::function<btf::ErrorCodes(btf::BtfFile&)>> steps{
+        [](btf::BtfFile& btf) { return btf.coreEvent(100, "Core1", btf::Core::Events::execute); },
+        [](btf::BtfFile& btf) { return btf.coreEvent(200, "Core2", btf::Core::Events::execute); },
+        [](btf::BtfFile& btf) { return btf.processEvent(300, "Core1", "Task1", 0, btf::Process::Events::start); },
+        [](btf::BtfFile& btf) { return btf.runnableEvent(350, "Core1", "Runnable1", btf::Runnable::Events::start); },
+        [](btf::BtfFile& btf) { return btf.processEvent(400, "Core2", "Isr1", 0, btf::Process::Events::start, true); },
+        [](btf::BtfFile& btf) { return btf.runnableEvent(450, "Core1", "Runnable1", btf::Runnable::Events::terminate); },
+        [](btf::BtfFile& btf) { return btf.osEvent(500, "Core1", "OsEvent2", btf::OS::Events::wait_event); },
+        [](btf::BtfFile& btf) { return btf.osEvent(600, "Core2", "OsEvent2", btf::OS::Events::set_event); },
+        [](btf::BtfFile& btf) { return btf.osEvent(700, "Core1", "OsEvent2", btf::OS::Events::clear_event); },
+        [](btf::BtfFile& btf) { return btf.runnableEvent(750, "Core1", "Runnable1", btf::Runnable::Events::start); },
+        [](btf::BtfFile& btf) { return btf.runnableEvent(760, "Core1", "Runnable1", btf::Runnable::Events::terminate); },
+        [](btf::BtfFile& btf) { return btf.processEvent(800, "Core1", "Task1", 0, btf::Process::Events::terminate); },
+        [](btf::BtfFile& btf) { return btf.processEvent(900, "Core2", "Isr1", 0, btf::Process::Events::terminate, true); },
+        [](btf::BtfFile& btf) { return btf.semaphoreEvent(1000, "Sem1", "Sem1", btf::Semaphore::Events::free, 0); },
+    };
+    const auto make_btf = [](const std::string& path) {
+        return btf::BtfFile(path, btf::BtfFile::TimeScales::nano_seconds, true, true, false, true);
+    };
+
+    auto uninterrupted = make_btf("uninterrupted.btf");
+    uninterrupted.headerEntry("#customHeader");
+    uninterrupted.comment("a comment");
+    for (const auto& step : steps)
+    {
+        REQUIRE(btf::ErrorCodes::success == step(uninterrupted));
+    }
+    uninterrupted.finish();
+
+    // the task waits for the OS event while the checkpoint is written
+    {
+        auto interrupted = make_btf("resumed.btf");
+        interrupted.headerEntry("#customHeader");
+        interrupted.comment("a comment");
+        for (size_t i = 0; i < 7; ++i)
+        {
+            REQUIRE(btf::ErrorCodes::success == steps[i](interrupted));
+        }
+        REQUIRE(interrupted.checkpoint("conversion.btfckp"));
+    }
+    auto resumed = make_btf("resumed.btf");
+    REQUIRE(resumed.restore("conversion.btfckp"));
+    for (size_t i = 7; i < steps.size(); ++i)
+    {
+        REQUIRE(btf::ErrorCodes::success == steps[i](resumed));
+    }
+    // events before the restored time are still rejected
+    REQUIRE(btf::ErrorCodes::descending_timestamp == resumed.coreEvent(10, "Core1", btf::Core::Events::idle));
+    resumed.finish();
+    REQUIRE(readBtf("uninterrupted.btf") == readBtf("resumed.btf"));
+
+    // a checkpoint that cannot be written keeps the previous snapshot
+    {
+        const auto previous = readBtf("conversion.btfckp");
+        std::filesystem::create_directory("conversion.btfckp.tmp");
+        auto failed = make_btf("failed.btf");
+        REQUIRE_FALSE(failed.checkpoint("conversion.btfckp"));
+        std::filesystem::remove("conversion.btfckp.tmp");
+        REQUIRE(readBtf("conversion.btfckp") == previous);
+    }
+
+    // a damaged snapshot is rejected and the state is kept
+    std::string snapshot;
+    {
+        std::ifstream file("conversion.btfckp", std::ios::binary);
+        snapshot.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+    snapshot[snapshot.size() / 2] ^= 0x55;
+    {
+        std::ofstream file("damaged.btfckp", std::ios::binary);
+        file << snapshot;
+    }
+    auto damaged = make_btf("damaged.btf");
+    REQUIRE(btf::ErrorCodes::success == damaged.coreEvent(100, "Core1", btf::Core::Events::execute));
+    REQUIRE_FALSE(damaged.restore("damaged.btfckp"));
+    REQUIRE_FALSE(damaged.restore("missing.btfckp"));
+    REQUIRE(damaged.getNumberOfAllEvents() == 1);
+
+    // a snapshot with a valid checksum but corrupted contents is rejected as well
+    const auto content = snapshot.substr(8, snapshot.size() - 16);
+    writeSnapshot("truncated.btfckp", content.substr(0, content.size() - 3));
+    REQUIRE_FALSE(damaged.restore("truncated.btfckp"));
+    writeSnapshot("huge_count.btfckp", std::string("\xff\xff\xff\xff\xff\x7f", 6));
+    REQUIRE_FALSE(damaged.restore("huge_count.btfckp"));
+    REQUIRE(damaged.getNumberOfAllEvents() == 1);
+    REQUIRE(btf::ErrorCodes::descending_timestamp == damaged.coreEvent(50, "Core1", btf::Core::Events::idle));
+}
+
+TEST_CASE("Append mode", "[libBtf]")
+{
+    const auto first_night = [](btf::BtfFile& btf) {
+        REQUIRE(btf::ErrorCodes::success == btf.coreEvent(100, "Core1", btf::Core::Events::execute));
+        REQUIRE(btf::ErrorCodes::success == btf.processEvent(200, "Core1", "Task1", 0, btf::Process::Events::start));
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(300, "Core1", "Runnable1", btf::Runnable::Events::start));
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(400, "Core1", "Runnable1", btf::Runnable::Events::terminate));
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(500, "Core1", "Runnable1", btf::Runnable::Events::start));
+    };
+    const auto second_night = [](btf::BtfFile& btf) {
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(600, "Core1", "Runnable1", btf::Runnable::Events::terminate));
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(650, "Core1", "Runnable1", btf::Runnable::Events::start));
+        REQUIRE(btf::ErrorCodes::success == btf.runnableEvent(660, "Core1", "Runnable1", btf::Runnable::Events::terminate));
+        REQUIRE(btf::ErrorCodes::success == btf.processEvent(700, "Core1", "Task1", 0, btf::Process::Events::terminate));
+        REQUIRE(btf::ErrorCodes::success == btf.processEvent(800, "Core1", "Task2", 0, btf::Process::Events::start));
+    };
+
+    btf::BtfFile uninterrupted("uninterrupted.btf");
+    first_night(uninterrupted);
+    second_night(uninterrupted);
+    uninterrupted.finish();
+
+    // with the state trailer, the file is continued without importing it
+    btf::BtfFile first("appended.btf");
+    first.setWriteStateTrailer(true);
+    first_night(first);
+    first.finish();
+    REQUIRE(std::ifstream(btf::getStateTrailerPath("appended.btf")).good());
+
+    btf::BtfFile second("appended.btf");
+    REQUIRE(second.openForAppend());
+    REQUIRE(second.getNumberOfAllEvents() == 0);
+    REQUIRE(btf::ErrorCodes::descending_timestamp == second.coreEvent(10, "Core1", btf::Core::Events::idle));
+    second_night(second);
+    second.finish();
+    REQUIRE(readBtf("uninterrupted.btf") == readBtf("appended.btf"));
+
+    // without a matching trailer, the state is rebuilt by importing the file
+    btf::BtfFile plain("imported.btf");
+    plain.coreEvent(100, "Core1", btf::Core::Events::execute);
+    plain.processEvent(200, "Core1", "Task1", 0, btf::Process::Events::start);
+    plain.finish();
+    btf::BtfFile appending("imported.btf", btf::BtfFile::TimeScales::nano_seconds, false, false);
+    REQUIRE(appending.openForAppend());
+    REQUIRE(btf::ErrorCodes::success == appending.processEvent(300, "Core1", "Task1", 0, btf::Process::Events::terminate));
+    REQUIRE(btf::ErrorCodes::invalid_state_transition == appending.processEvent(400, "Core1", "Task1", 0, btf::Process::Events::resume));
+    appending.finish();
+    REQUIRE(readBtf("imported.btf") == "#version 2.2.1\n"
+                                       "#creator libBtf\n"
+                                       "#timescale ns\n"
+                                       "100,Core1,0,C,Core1,0,execute\n"
+                                       "200,Core1,0,T,Task1,0,start\n"
+                                       "300,Core1,0,T,Task1,0,terminate\n");
+
+    // a last line without newline is terminated before the new events are appended
+    {
+        std::ofstream file("unterminated.btf", std::ios::binary);
+        file << "#version 2.2.1\n#creator test\n#timescale ns\n100,Core1,0,T,Task1,0,start";
+    }
+    btf::BtfFile unterminated("unterminated.btf");
+    REQUIRE(unterminated.openForAppend());
+    REQUIRE(btf::ErrorCodes::success == unterminated.processEvent(200, "Core1", "Task1", 0, btf::Process::Events::terminate));
+    unterminated.finish();
+    REQUIRE(readBtf("unterminated.btf") == "#version 2.2.1\n"
+                                           "#creator test\n"
+                                           "#timescale ns\n"
+                                           "100,Core1,0,T,Task1,0,start\n"
+                                           "200,Core1,0,T,Task1,0,terminate\n");
+
+    // a damaged trailer is ignored and the state is rebuilt by importing the file
+    writeSnapshot(btf::getStateTrailerPath("imported.btf"), std::string("\x01\x05", 2));
+    btf::BtfFile damaged("imported.btf", btf::BtfFile::TimeScales::nano_seconds, false, false);
+    REQUIRE(damaged.openForAppend());
+    REQUIRE(btf::ErrorCodes::success == damaged.processEvent(500, "Core1", "Task1", 1, btf::Process::Events::start));
+
+    btf::BtfFile missing("missing.btf");
+    REQUIRE_FALSE(missing.openForAppend());
+}
+
+TEST_CASE("State keyframes", "[libBtf]")
+{
+    btf::BtfFile btf("keyframes.btf");
+    btf.setStateKeyframes(5);
+    btf.comment("keyframes");
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        const auto task1 = "KeyframeTask" + std::to_string(2 * i);
+        const auto task2 = "KeyframeTask" + std::to_string(2 * i + 1);
+        const auto runnable1 = "Runnable" + std::to_string(2 * i);
+        const auto runnable2 = "Runnable" + std::to_string(2 * i + 1);
+        btf.processEvent(1000 * i + 100, "Core1", task1, 0, btf::Process::Events::start);
+        btf.processEvent(1000 * i + 150, "Core2", task2, 0, btf::Process::Events::start);
+        btf.runnableEvent(1000 * i + 200, "Core1", runnable1, btf::Runnable::Events::start);
+        btf.runnableEvent(1000 * i + 250, "Core2", runnable2, btf::Runnable::Events::start);
+        btf.runnableEvent(1000 * i + 300, "Core1", runnable1, btf::Runnable::Events::terminate);
+        btf.runnableEvent(1000 * i + 350, "Core2", runnable2, btf::Runnable::Events::terminate);
+        btf.runnableEvent(1000 * i + 400, "Core1", runnable1, btf::Runnable::Events::start);
+        btf.runnableEvent(1000 * i + 450, "Core2", runnable2, btf::Runnable::Events::start);
+        btf.runnableEvent(1000 * i + 800, "Core1", runnable1, btf::Runnable::Events::terminate);
+        btf.runnableEvent(1000 * i + 850, "Core2", runnable2, btf::Runnable::Events::terminate);
+        btf.processEvent(1000 * i + 900, "Core1", task1, 0, btf::Process::Events::terminate);
+        btf.processEvent(1000 * i + 950, "Core2", task2, 0, btf::Process::Events::terminate);
+    }
+    btf.finish();
+
+    btf::StateKeyframes keyframes;
+    REQUIRE(keyframes.load("keyframes.btf"));
+    REQUIRE(keyframes.getKeyframes().size() > 10);
+
+    const auto state = keyframes.stateAt(7450);
+    REQUIRE(state.time_ == 7450);
+    REQUIRE(state.running_processes_.size() == 2);
+    REQUIRE(state.running_processes_.at("Core1") == btf::TraceState::Instance{"KeyframeTask14", 0});
+    REQUIRE(state.running_processes_.at("Core2") == btf::TraceState::Instance{"KeyframeTask15", 0});
+    REQUIRE(state.runnable_stacks_.at({"KeyframeTask14", 0}) == std::vector<btf::TraceState::Instance>{{"Runnable14", 1}});
+    REQUIRE(state.runnable_stacks_.at({"KeyframeTask15", 0}) == std::vector<btf::TraceState::Instance>{{"Runnable15", 1}});
+    REQUIRE(state.processes_.size() == 2);
+
+    // the result does not depend on the keyframe that is used
+    btf::StateKeyframes replay;
+    replay.build("keyframes.btf", 0);
+    REQUIRE(replay.getKeyframes().size() == 1);
+    for (uint64_t time = 0; time < 11000; time += 50)
+    {
+        REQUIRE(keyframes.stateAt(time) == replay.stateAt(time));
+    }
+    REQUIRE(keyframes.stateAt(11000).running_processes_.empty());
+
+    // events emitted by ID without names do not stop the keyframes
+    btf::BtfFile by_id("keyframes_by_id.btf");
+    by_id.setStateKeyframes(2);
+    for (uint64_t i = 0; i < 5; ++i)
+    {
+        REQUIRE(btf::ErrorCodes::success == by_id.processEvent(100 * i, 1, 2, i, btf::Process::Events::start));
+        REQUIRE(btf::ErrorCodes::success == by_id.processEvent(100 * i + 50, 1, 2, i, btf::Process::Events::terminate));
+    }
+    REQUIRE_NOTHROW(by_id.finish());
+    btf::StateKeyframes by_id_keyframes;
+    REQUIRE(by_id_keyframes.load("keyframes_by_id.btf"));
+    REQUIRE(by_id_keyframes.getKeyframes().size() > 1);
+
+    // keyframes of a modified file are rejected
+    std::ofstream("keyframes.btf", std::ios::app) << "21000,Core1,0,T,KeyframeTask0,0,activate\n";
+    REQUIRE_FALSE(keyframes.load("keyframes.btf"));
+    replay.build("keyframes.btf", 0, 1000);
+    REQUIRE(replay.save());
+    REQUIRE(keyframes.load("keyframes.btf"));
+    REQUIRE(keyframes.stateAt(21000).processes_.size() == 1);
+
+    // a count that is larger than the file is rejected before anything is allocated
+    btf::CheckpointWriter corrupted;
+    corrupted.writeU64(std::filesystem::file_size("keyframes.btf"));
+    corrupted.writeU64(uint64_t{1} << 60U);
+    REQUIRE(corrupted.save(btf::getStateKeyframesPath("keyframes.btf")));
+    REQUIRE_FALSE(keyframes.load("keyframes.btf"));
+}
+
+TEST_CASE("Parallel import", "[libBtf]")
+{
+    // preemptions, nested runnables, migrations and long running task instances cross the partition boundaries
+    std::vector<std::pair<uint64_t, std::string>> events;
+    const auto add = [&events](uint64_t time, const std::string& line) { events.emplace_back(time, std::to_string(time) + "," + line); };
+    for (uint64_t i = 0; i < 60; ++i)
+    {
+        const auto t = 1000 * i;
+        const auto id = std::to_string(i);
+        if (i % 5 == 0)
+        {
+            events.emplace_back(t, "#iteration " + id);
+        }
+        add(t, "Stim1,0,T,TaskA," + id + ",activate");
+        add(t + 10, "Core1,0,T,TaskA," + id + ",start");
+        add(t + 20, "TaskA," + id + ",R,RunnableA,0,start");
+        add(t + 30, "TaskA," + id + ",R,RunnableB,0,start");
+        add(t + 40, "Core1,0,T,TaskA," + id + ",preempt");
+        add(t + 40, "Core1,0,T,TaskB," + id + ",start");
+        add(t + 50, "TaskB," + id + ",R,RunnableC,0,start");
+        add(t + 60, "TaskB," + id + ",R,RunnableC,0,terminate");
+        add(t + 70, "Core1,0,T,TaskB," + id + ",terminate");
+        add(t + 80, "Core1,0,T,TaskA," + id + ",resume");
+        add(t + 90, "TaskA," + id + ",R,RunnableB,0,terminate");
+        add(t + 100, "TaskA," + id + ",R,RunnableA,0,terminate");
+        add(t + 110, "Core1,0,T,TaskA," + id + ",terminate");
+
+        // an instance of TaskC runs for three iterations and is interrupted by an ISR
+        const auto c = std::to_string(i / 3);
+        if (i % 3 == 0)
+        {
+            add(t + 5, "Core2,0,T,TaskC," + c + ",start");
+            add(t + 15, "TaskC," + c + ",R,RunnableD,0,start");
+        }
+        add(t + 500, "Core2,0,T,TaskC," + c + ",preempt");
+        add(t + 500, "Core2,0,I,Isr1," + id + ",start");
+        add(t + 510, "Core2,0,I,Isr1," + id + ",terminate");
+        add(t + 520, "Core2,0,T,TaskC," + c + ",resume");
+        if (i % 3 == 2)
+        {
+            add(t + 900, "TaskC," + c + ",R,RunnableD,0,terminate");
+            add(t + 900, "Core2,0,T,TaskC," + c + ",terminate");
+        }
+
+        // an instance of TaskE migrates from Core3 to Core4 in the next iteration
+        const auto e = std::to_string(i / 2);
+        if (i % 2 == 0)
+        {
+            add(t + 200, "Core3,0,T,TaskE," + e + ",start");
+            add(t + 300, "Core3,0,T,TaskE," + e + ",preempt");
+        }
+        else
+        {
+            add(t + 200, "Core3,0,T,TaskE," + e + ",enforcedmigration");
+            add(t + 200, "Core4,0,T,TaskE," + e + ",fullmigration");
+            add(t + 250, "Core4,0,T,TaskE," + e + ",resume");
+            add(t + 300, "Core4,0,T,TaskE," + e + ",terminate");
+        }
+
+        // runnables of a new task before its first start
+        if (i % 5 == 3)
+        {
+            add(t + 600, "TaskG" + id + ",0,R,RunnableG,0,start");
+            add(t + 610, "Core4,0,T,TaskG" + id + ",0,start");
+            add(t + 620, "TaskG" + id + ",0,R,RunnableG,0,terminate");
+            add(t + 630, "Core4,0,T,TaskG" + id + ",0,terminate");
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    const auto writeTrace = [&events](const std::string& path, const std::string& invalid_line) {
+        std::ofstream out(path);
+        out << "#version 2.2.1\n#creator test\n#timescale ns\n";
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            if (i == events.size() * 2 / 3 && !invalid_line.empty())
+            {
+                out << events[i].first << "," << invalid_line << "\n";
+            }
+            out << events[i].second << "\n";
+        }
+    };
+
+    // a rejected line is replayed, a migration without full_migration event is imported again with its partition
+    const std::vector<std::pair<std::string, size_t>> invalid_lines{
+        {"", 0}, {"Core1,0,T,TaskA,99,unknownevent", 0}, {"Core3,0,T,TaskE,99,enforcedmigration", 1}};
+    for (const auto& [invalid_line, reimported_partitions] : invalid_lines)
+    {
+        writeTrace("parallel_input.btf", invalid_line);
+        btf::BtfFile serial("parallel_serial.btf", btf::BtfFile::TimeScales::nano_seconds, false, false, false, false);
+        const auto serial_summary = serial.importFromFile("parallel_input.btf");
+        REQUIRE(serial_summary.categories_.empty() == invalid_line.empty());
+        serial.finish();
+        const auto should_be = readBtf("parallel_serial.btf");
+
+        for (size_t partitions : {2, 3, 5, 8})
+        {
+            btf::BtfFile parallel("parallel.btf", btf::BtfFile::TimeScales::nano_seconds, false, false, false, false);
+            const auto summary = parallel.importFromFileParallel("parallel_input.btf", partitions);
+            parallel.finish();
+            REQUIRE(summary.partitions_ == partitions);
+            REQUIRE_FALSE(summary.is_restarted_);
+            REQUIRE(summary.replayed_lines_ < serial_summary.lines_ / 2);
+            REQUIRE(summary.reimported_partitions_ == reimported_partitions);
+            REQUIRE(summary.import_.lines_ == serial_summary.lines_);
+            REQUIRE(summary.import_.rejected_lines_ == serial_summary.rejected_lines_);
+            REQUIRE(readBtf("parallel.btf") == should_be);
+        }
+    }
+
+    // a partition that reaches a state a serial import cannot reach (here a runnable that is started while it is on the stack of a
+    // task that is unknown in the partition) is imported again serially, the comment moves the partition boundary before 2968
+    {
+        std::ofstream out("parallel_input.btf");
+        out << "#version 2.2.1\n#creator test\n#timescale ns\n#" << std::string(400, 'x') << "\n"
+            << "100,Core2,0,T,Task4,0,start\n"
+               "2968,Core1,0,T,Task3,1,run\n"
+               "2982,Core1,0,T,Task0,2,poll\n"
+               "2994,Task4,3,R,Run1,0,suspend\n"
+               "3003,Core1,0,T,Task1,0,poll\n"
+               "3048,Task4,0,R,Run3,0,suspend\n"
+               "3059,Task0,3,R,Run2,0,start\n"
+               "3059,Task1,3,R,Run3,0,resume\n"
+               "3089,Task3,2,R,Run2,0,terminate\n"
+               "3184,Task4,0,R,Run3,0,start\n";
+    }
+    {
+        btf::BtfFile serial("parallel_serial.btf", btf::BtfFile::TimeScales::nano_seconds, false, false, false, false);
+        serial.importFromFile("parallel_input.btf");
+        serial.finish();
+        btf::BtfFile parallel("parallel.btf", btf::BtfFile::TimeScales::nano_seconds, false, false, false, false);
+        const auto summary = parallel.importFromFileParallel("parallel_input.btf", 2);
+        parallel.finish();
+        REQUIRE(summary.partitions_ == 2);
+        REQUIRE(summary.reimported_partitions_ == 1);
+        REQUIRE(readBtf("parallel.btf") == readBtf("parallel_serial.btf"));
+    }
+
+    // the error sink is restored if the import of a partition throws
+    {
+        writeTrace("parallel_input.btf", "Core1,0,T,Boom,0,start");
+        btf::BtfFile parallel("parallel.btf", btf::BtfFile::TimeScales::nano_seconds, false, false, false, false);
+        parallel.setEntityHasher([](std::string_view name) {
+            if (name == "Boom")
+            {
+                throw std::runtime_error("unexpected entity");
+            }
+            return btf::hashEntityName(name);
+        });
+        size_t errors{0};
+        parallel.setErrorSink([&errors](btf::ErrorCodes, const btf::BtfEntry&, bool) { ++errors; });
+        REQUIRE_THROWS_AS(parallel.importFromFileParallel("parallel_input.btf", 2), std::runtime_error);
+        REQUIRE(btf::ErrorCodes::descending_timestamp == parallel.processEvent(0, "Core1", "TaskA", 0, btf::Process::Events::start));
+        REQUIRE(errors == 1);
+    }
+
+    // with the default options (the source of runnables is a core), partitions with runnables are imported again serially
+    for (const bool has_runnables : {false, true})
+    {
+        std::ofstream out("parallel_input.btf");
+        out << "#version 2.2.1\n#creator test\n#timescale ns\n";
+        for (uint64_t i = 0; i < 40; ++i)
+        {
+            const auto t = 100 * i;
+            out << t << ",Core1,0,T,Task1," << i << ",start\n";
+            if (has_runnables)
+            {
+                out << t + 10 << ",Core1,0,R,Runnable1,0,start\n";
+                out << t + 20 << ",Core1,0,R,Runnable1,0,terminate\n";
+            }
+            out << t + 30 << ",Core1,0,T,Task1," << i << ",terminate\n";
+            out << t + 40 << ",Stim1,0,T,Task2," << i << ",activate\n";
+        }
+        out.close();
+
+        btf::BtfFile serial("parallel_serial.btf");
+        serial.importFromFile("parallel_input.btf");
+        serial.finish();
+        btf::BtfFile parallel("parallel.btf");
+        const auto summary = parallel.importFromFileParallel("parallel_input.btf", 4);
+        parallel.finish();
+        REQUIRE(summary.partitions_ == 4);
+        REQUIRE(summary.reimported_partitions_ == (has_runnables ? 3 : 0));
+        REQUIRE(readBtf("parallel.btf") == readBtf("parallel_serial.btf"));
+    }
+
+    // nothing to split: imported serially
+    btf::BtfFile single("parallel.btf");
+    REQUIRE(single.importFromFileParallel("parallel_input.btf", 1).partitions_ == 1);
+}
+
+TEST_CASE("Batch conversion", "[libBtf]")
+{
+    // the traces differ in length, so the worker threads reuse their BtfFiles for traces of different sizes
+    std::vector<btf::BatchJob> jobs;
+    for (uint64_t n : {40, 3, 25, 10})
+    {
+        const auto input = "batch_input" + std::to_string(n) + ".btf";
+        std::ofstream out(input);
+        out << "#version 2.2.1\n#creator test\n#timescale ns\n";
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            const auto t = 100 * i;
+            out << t << ",Core1,0,T,Task1," << i << ",start\n";
+            out << t + 10 << ",Core1,0,R,Runnable1,0,start\n";
+            out << t + 20 << ",Core1,0,R,Runnable1,0,terminate\n";
+            out << t + 30 << ",Core1,0,T,Task1," << i << ",terminate\n";
+            out << t + 40 << ",Stim1,0,T,Task2," << i << ",activate\n";
+        }
+        out << n * 100 << ",Core1,0,T,Task1," << n << ",terminate\n";
+        jobs.push_back({input, "batch_output" + std::to_string(n) + ".btf"});
+    }
+    jobs.push_back({"does_not_exist.btf", "batch_output_missing.btf"});
+    jobs.push_back({"batch_input3.btf", "no_such_directory/batch_output.btf"});
+    jobs.push_back({"batch_input3.btf", "batch_input3.btf"});
+
+    btf::BatchConversionOptions options;
+    options.number_of_threads_ = 3;
+    size_t finished_jobs{0};
+    const auto results = btf::convertBatch(jobs, options, [&finished_jobs](const btf::BatchJobResult&) { ++finished_jobs; });
+    REQUIRE(finished_jobs == jobs.size());
+    REQUIRE(results.size() == jobs.size());
+    for (size_t i = 0; i < 4; ++i)
+    {
+        REQUIRE(results[i].is_success_);
+        REQUIRE(results[i].job_.output_path_ == jobs[i].output_path_);
+        REQUIRE(results[i].import_.rejected_lines_ == 1);
+
+        btf::BtfFile serial("batch_serial.btf");
+        serial.importFromFile(jobs[i].input_path_);
+        serial.finish();
+        REQUIRE(readBtf(jobs[i].output_path_) == readBtf("batch_serial.btf"));
+    }
+
+    // failures are reported per job
+    REQUIRE_FALSE(results[4].is_success_);
+    REQUIRE(results[4].error_ == "could not open file");
+    REQUIRE_FALSE(results[5].is_success_);
+    REQUIRE(results[5].error_ == "could not open output file");
+    REQUIRE_FALSE(results[6].is_success_);
+    REQUIRE(results[6].error_ == "input and output are the same file");
+    REQUIRE(readBtf("batch_input3.btf").size() > 100);
+
+    // a BtfFile can be moved and reused after reset()
+    std::vector<btf::BtfFile> files;
+    files.emplace_back("batch_moved.btf");
+    files[0].importFromFile("batch_input40.btf");
+    btf::BtfFile moved(std::move(files[0]));
+    moved.finish();
+    REQUIRE(readBtf("batch_moved.btf") == readBtf("batch_output40.btf"));
+    moved.reset("batch_reset.btf");
+    moved.importFromFile("batch_input10.btf");
+    moved.finish();
+    REQUIRE(readBtf("batch_reset.btf") == readBtf("batch_output10.btf"));
+    files[0].reset("batch_reset.btf");
+    files[0].importFromFile("batch_input25.btf");
+    files[0].finish();
+    REQUIRE(readBtf("batch_reset.btf") == readBtf("batch_output25.btf"));
+}
+
+TEST_CASE("Conversion cache", "[libBtf]")
+{
+    const auto writeTrace = [](const std::string& path, uint64_t n) {
+        std::ofstream out(path);
+        out << "#version 2.2.1\n#creator test\n#timescale ns\n";
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            out << 100 * i << ",Core1,0,T,Task1," << i << ",start\n";
+            out << 100 * i + 50 << ",Core1,0,T,Task1," << i << ",terminate\n";
+        }
+        out << 100 * n << ",Core1,0,T,Task1," << n << ",terminate\n";
+    };
+    writeTrace("cache_input.btf", 50);
+    std::filesystem::remove_all("conversion_cache");
+
+    btf::BatchConversionOptions options;
+    options.cache_directory_ = "conversion_cache";
+    const std::vector<btf::BatchJob> jobs{{"cache_input.btf", "cache_output.btf"}};
+    auto result = btf::convertBatch(jobs, options)[0];
+    REQUIRE(result.is_success_);
+    REQUIRE_FALSE(result.is_cache_hit_);
+    const auto converted = readBtf("cache_output.btf");
+    const auto lines = result.import_.lines_;
+    const auto problems = result.import_.toString();
+
+    // unchanged input and options: the output is taken from the cache
+    std::filesystem::remove("cache_output.btf");
+    result = btf::convertBatch(jobs, options)[0];
+    REQUIRE(result.is_success_);
+    REQUIRE(result.is_cache_hit_);
+    REQUIRE(readBtf("cache_output.btf") == converted);
+    REQUIRE(result.import_.lines_ == lines);
+    REQUIRE(result.import_.rejected_lines_ == 1);
+    REQUIRE(result.import_.categories_.size() == 1);
+    REQUIRE(result.import_.categories_[0].sample_lines_ == std::vector<std::string>{"5000,Core1,0,T,Task1,50,terminate"});
+    REQUIRE(result.import_.toString() == problems);
+
+    // other options or another input are converted again
+    options.source_is_core_ = false;
+    REQUIRE_FALSE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    REQUIRE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    options.source_is_core_ = true;
+    writeTrace("cache_input.btf", 51);
+    result = btf::convertBatch(jobs, options)[0];
+    REQUIRE_FALSE(result.is_cache_hit_);
+    REQUIRE(result.import_.lines_ == lines + 2);
+
+    // a linked output is replaced, not overwritten, when its input changes, so the cached file stays intact
+    const auto converted_linked = readBtf("cache_output.btf");
+    options.link_cached_outputs_ = true;
+    REQUIRE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    writeTrace("cache_input.btf", 52);
+    REQUIRE_FALSE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    REQUIRE(readBtf("cache_output.btf") != converted_linked);
+    writeTrace("cache_input.btf", 51);
+    REQUIRE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    REQUIRE(readBtf("cache_output.btf") == converted_linked);
+    options.link_cached_outputs_ = false;
+    REQUIRE(btf::convertBatch(jobs, options)[0].is_cache_hit_);
+    REQUIRE(readBtf("cache_output.btf") == converted_linked);
+
+    // the block table of a compressed output is cached with the output
+    if (btf::isCompressionSupported(btf::Compressions::gzip))
+    {
+        options.output_compression_ = btf::Compressions::gzip;
+        const std::vector<btf::BatchJob> compressed_jobs{{"cache_input.btf", "cache_output.btf.gz"}};
+        REQUIRE_FALSE(btf::convertBatch(compressed_jobs, options)[0].is_cache_hit_);
+        std::filesystem::remove("cache_output.btf.gz");
+        std::filesystem::remove(btf::getBlockTablePath("cache_output.btf.gz"));
+        REQUIRE(btf::convertBatch(compressed_jobs, options)[0].is_cache_hit_);
+        btf::CompressedBtfFile compressed;
+        REQUIRE(compressed.load("cache_output.btf.gz"));
+    }
+
+    // the least recently used entry is removed when the cache is full
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const auto path = "cache_lru" + std::to_string(i) + ".btf";
+        std::ofstream(path) << std::string(1000, static_cast<char>('a' + i));
+        keys.push_back(btf::ConversionCache::computeKey(path, "options"));
+    }
+    REQUIRE(keys[0] != keys[1]);
+    REQUIRE(btf::ConversionCache::computeKey("cache_lru0.btf", "other options") != keys[0]);
+    std::filesystem::remove_all("conversion_cache_lru");
+    btf::ConversionCache cache("conversion_cache_lru", 2500);
+    btf::ImportSummary summary;
+    REQUIRE(cache.store(keys[0], {"cache_lru0.btf"}, summary));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(cache.store(keys[1], {"cache_lru1.btf"}, summary));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(cache.fetch(keys[0], {"cache_restored.btf"}, summary));
+    REQUIRE(readBtf("cache_restored.btf") == readBtf("cache_lru0.btf"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(cache.store(keys[2], {"cache_lru2.btf"}, summary));
+    REQUIRE(cache.getSize() <= 2500);
+    REQUIRE_FALSE(cache.fetch(keys[1], {"cache_restored.btf"}, summary));
+    REQUIRE(cache.fetch(keys[0], {"cache_restored.btf"}, summary));
+    REQUIRE(cache.fetch(keys[2], {"cache_restored.btf"}, summary));
+    REQUIRE_FALSE(cache.fetch(keys[2], {"cache_restored.btf", "cache_restored2.btf"}, summary));
+}
+
+TEST_CASE("Error sink", "[libBtf]")
+{
+    btf::BtfFile btf("test.btf", btf::BtfFile::TimeScales::nano_seconds, true, true, false, true);
+
+    std::vector<std::tuple<btf::ErrorCodes, btf::BtfEntry, bool>> errors;
+    btf.setErrorSink([&errors](btf::ErrorCodes error, const btf::BtfEntry& rejected_entry, bool is_generated) {
+        errors.emplace_back(error, rejected_entry, is_generated);
+    });
+
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(100, "Core1", "Task1", 0, btf::Process::Events::start));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(200, "Core2", "Isr1", 0, btf::Process::Events::start, true));
+    REQUIRE(btf::ErrorCodes::descending_timestamp == btf.processEvent(50, "Core1", "Task1", 0, btf::Process::Events::terminate));
+    REQUIRE(errors.size() == 1);
+    REQUIRE(std::get<0>(errors[0]) == btf::ErrorCodes::descending_timestamp);
+    REQUIRE(std::get<1>(errors[0]).time_ == 50);
+    REQUIRE(std::get<1>(errors[0]).type_ == btf::EntityTypes::task);
+    REQUIRE(std::get<1>(errors[0]).target_hash_ == btf::hashEntityName("Task1"));
+    REQUIRE(std::get<1>(errors[0]).event_.process_event == btf::Process::Events::terminate);
+    REQUIRE_FALSE(std::get<2>(errors[0]));
+
+    // the second set_event tries to release Task1 again => the generated release fails, but the conversion continues
+    REQUIRE(btf::ErrorCodes::success == btf.osEvent(300, "Core1", "OsEvent1", btf::OS::Events::wait_event));
+    REQUIRE(btf::ErrorCodes::success == btf.osEvent(400, "Core2", "OsEvent1", btf::OS::Events::set_event));
+    REQUIRE(errors.size() == 1);
+    REQUIRE(btf::ErrorCodes::success == btf.osEvent(500, "Core2", "OsEvent1", btf::OS::Events::set_event));
+    REQUIRE(errors.size() > 1);
+    REQUIRE(std::get<1>(errors[1]).time_ == 500);
+    REQUIRE(std::get<1>(errors[1]).event_.process_event == btf::Process::Events::release);
+    REQUIRE(std::get<2>(errors[1]));
+
+    const auto number_of_errors = errors.size();
+    btf.setErrorSink({});
+    REQUIRE(btf::ErrorCodes::invalid_type == btf.coreEvent(600, "Task1", btf::Core::Events::execute));
+    REQUIRE(errors.size() == number_of_errors);
+}
+
+TEST_CASE("Entity index", "[libBtf]")
+{
+    btf::BtfFile btf("test.btf");
+
+    // enough events for a parallel build of the index
+    constexpr uint64_t events_per_core = 40000;
+    const std::vector<std::string> cores{"Core1", "Core2", "Core3", "Core4"};
+    auto time = emitCoreEvents(btf, cores, events_per_core);
+
+    // first query builds the index
+    for (size_t c = 0; c < cores.size(); ++c)
+    {
+        auto events = btf.getEventsForEntity(cores[c]);
+        REQUIRE(events.size() == events_per_core);
+        REQUIRE(events.front()->time_ == c + 1);
+        REQUIRE(events.back()->time_ == time - cores.size() + c + 1);
+        REQUIRE(std::is_sorted(events.begin(), events.end(), [](auto a, auto b) { return a->time_ < b->time_; }));
+    }
+    REQUIRE(btf.getEventsForEntity("Unknown").empty());
+
+    // comments are not indexed
+    btf::BtfFile commented("commented.btf");
+    commented.comment("a comment");
+    REQUIRE(btf::ErrorCodes::success == commented.coreEvent(100, "Core1", btf::Core::Events::execute));
+    REQUIRE(commented.getEventsForEntity(size_t{0}).empty());
+    REQUIRE(commented.getEventsForEntity("Core1").size() == 1);
+
+    // afterwards, the index is kept up to date
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core1", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(++time, "Core1", "Task1", 0, btf::Process::Events::start));
+    REQUIRE(btf.getEventsForEntity("Core1").size() == events_per_core + 1);
+    REQUIRE(btf.getEntityEvents("Task1").size() == 1);
+    REQUIRE(btf.getEntityEvents("Task1").front()->time_ == time);
+}
+
+TEST_CASE("Event views", "[libBtf]")
+{
+    btf::BtfFile btf("test.btf");
+    constexpr uint64_t events_per_core = 1000;
+    auto time = emitCoreEvents(btf, {"Core1", "Core2", "Core3", "Core4"}, events_per_core);
+
+    // views expose the same events without copying them
+    auto all_events = btf.viewAllEvents();
+    REQUIRE(static_cast<size_t>(std::ranges::distance(all_events)) == btf.getNumberOfAllEvents());
+    REQUIRE(&*all_events.begin() == &*btf.getEventsForEntity("Core1").front());
+    auto core2_events = btf.viewEventsForEntity("Core2");
+    REQUIRE(static_cast<size_t>(std::ranges::distance(core2_events)) == events_per_core);
+    REQUIRE(std::ranges::all_of(core2_events, [&btf](const btf::BtfEntry& e) { return e.target_hash_ == btf.hashName("Core2"); }));
+    REQUIRE(&*std::ranges::next(core2_events.begin(), 2) == &**std::next(btf.getEventsForEntity("Core2").begin(), 2));
+
+    // views follow the events emitted later, also the view of an entity that had no events yet
+    auto unknown_events = btf.viewEventsForEntity("Unknown");
+    REQUIRE(std::ranges::empty(unknown_events));
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core2", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Unknown", btf::Core::Events::execute));
+    REQUIRE(static_cast<size_t>(std::ranges::distance(core2_events)) == events_per_core + 1);
+    REQUIRE(static_cast<size_t>(std::ranges::distance(unknown_events)) == 1);
+    REQUIRE((*unknown_events.begin()).time_ == time);
+}
+
+TEST_CASE("Time range queries", "[libBtf]")
+{
+    btf::BtfFile btf("test.btf");
+    constexpr uint64_t events_per_core = 40000;
+    auto time = emitCoreEvents(btf, {"Core1", "Core2", "Core3", "Core4"}, events_per_core);
+    auto all_events = btf.viewAllEvents();
+
+    // the end is exclusive
+    for (const auto& [start, end] : std::vector<std::pair<uint64_t, uint64_t>>{{0, 1}, {1, 2}, {1000, 1010}, {63, 200}, {5000, 4000}, {159990, 170000}})
+    {
+        auto range = btf.eventsInRange(start, end);
+        auto expected = std::ranges::count_if(all_events, [start, end](const btf::BtfEntry& e) { return e.time_ >= start && e.time_ < end; });
+        REQUIRE(std::ranges::distance(range) == expected);
+        REQUIRE(std::ranges::all_of(range, [start, end](const btf::BtfEntry& e) { return e.time_ >= start && e.time_ < end; }));
+
+        auto core_range = btf.eventsInRange("Core2", start, end);
+        auto core_events = btf.viewEventsForEntity("Core2");
+        auto core_expected = std::ranges::count_if(core_events, [start, end](const btf::BtfEntry& e) { return e.time_ >= start && e.time_ < end; });
+        REQUIRE(std::ranges::distance(core_range) == core_expected);
+        REQUIRE(std::ranges::all_of(core_range, [start, end](const btf::BtfEntry& e) { return e.time_ >= start && e.time_ < end; }));
+    }
+    REQUIRE(btf.eventsInRange(1000, 1010).begin()->time_ == 1000);
+    auto core2_range = btf.eventsInRange("Core2", 1000, 1010);
+    REQUIRE((*core2_range.begin()).time_ == 1002);
+    REQUIRE(std::ranges::empty(btf.eventsInRange("Unknown", 0, 1000)));
+
+    // the time indexes are kept up to date
+    REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core1", btf::Core::Events::execute));
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(++time, "Core1", "Task1", 0, btf::Process::Events::start));
+    REQUIRE(std::ranges::distance(btf.eventsInRange(time - 1, time + 1)) == 2);
+    REQUIRE(std::ranges::distance(btf.eventsInRange("Core1", time - 1, time + 1)) == 1);
+
+    // comments between the events of a range are part of it
+    btf.comment("between");
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(++time, "Core1", "Task1", 0, btf::Process::Events::terminate));
+    const auto with_comment = btf.eventsInRange(time - 1, time + 1);
+    REQUIRE(std::ranges::distance(with_comment) == 3);
+    REQUIRE(std::ranges::count_if(with_comment, [](const btf::BtfEntry& e) { return e.type_ == btf::EntityTypes::comment; }) == 1);
+}
+
+TEST_CASE("Sidecar index", "[libBtf]")
+{
+    // Core3 only appears at the end of the trace
+    auto emit = [](btf::BtfFile& btf) {
+        uint64_t time = 0;
+        for (uint64_t i = 0; i < 5000; ++i)
+        {
+            REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core1", i % 2 == 0 ? btf::Core::Events::execute : btf::Core::Events::idle));
+            REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core2", i % 2 == 0 ? btf::Core::Events::execute : btf::Core::Events::idle));
+        }
+        btf.comment("end of Core1 and Core2");
+        REQUIRE(btf::ErrorCodes::success == btf.coreEvent(++time, "Core3", btf::Core::Events::execute));
+    };
+    btf::BtfFile btf("test.btf");
+    btf.setWriteSidecarIndex(true);
+    emit(btf);
+    btf.finish();
+    btf::BtfFile plain_btf("plain.btf");
+    emit(plain_btf);
+    plain_btf.finish();
+
+    // the BTF file itself does not change
+    REQUIRE(readBtf("test.btf") == readBtf("plain.btf"));
+
+    btf::BtfIndex index;
+    REQUIRE(index.load("test.btf", true));
+    REQUIRE(index.getBlocks().size() == 3);
+    REQUIRE(index.getBlocks()[0].min_time_ == 1);
+    REQUIRE(index.getBlocks()[0].max_time_ == btf::BtfIndexWriter::lines_per_block_);
+    REQUIRE(index.getEntityNames().size() == 3);
+    REQUIRE(index.getEntityNames().at(btf::hashEntityName("Core3")) == "Core3");
+    REQUIRE(index.findBlocks(4000, 4200) == std::vector<size_t>{0, 1});
+    REQUIRE(index.findBlocks(0, 20000, {"Core3"}) == std::vector<size_t>{2});
+    REQUIRE(index.findBlocks(0, 20000, {"Unknown"}).empty());
+    REQUIRE(index.findBlocks(20000, 30000).empty());
+
+    std::ifstream file("test.btf", std::ios::binary);
+    std::string lines;
+    REQUIRE(index.readBlock(file, 2, lines));
+    REQUIRE(lines.find("# end of Core1 and Core2\n10001,Core3,0,C,Core3,0,execute\n") != std::string::npos);
+    file.close();
+
+    // a changed BTF file rejects the index
+    {
+        std::ofstream out("test.btf", std::ios::app | std::ios::binary);
+        out << "10002,Core3,0,C,Core3,0,idle\n";
+    }
+    REQUIRE_FALSE(index.load("test.btf"));
+    REQUIRE_FALSE(index.load("plain.btf"));
+}
+
+TEST_CASE("Seek and extract window", "[libBtf]")
+{
+    // two cores with the same timestamps, every event time is 10 * i
+    btf::BtfFile btf("test.btf");
+    for (uint64_t i = 1; i <= 20000; ++i)
+    {
+        REQUIRE(btf::ErrorCodes::success == btf.coreEvent(10 * i, "Core1", i % 2 == 1 ? btf::Core::Events::execute : btf::Core::Events::idle));
+        REQUIRE(btf::ErrorCodes::success == btf.coreEvent(10 * i, "Core2", i % 2 == 1 ? btf::Core::Events::execute : btf::Core::Events::idle));
+        if (i % 1000 == 0)
+        {
+            btf.comment("comment " + std::to_string(i));
+        }
+    }
+    btf.finish();
+
+    auto lines_in_window = [](const std::string& data, uint64_t start_time, uint64_t end_time) {
+        std::string ret;
+        std::stringstream ss(data);
+        std::string line;
+        bool is_in_window{false};
+        while (std::getline(ss, line))
+        {
+            if (line[0] == '#')
+            {
+                if (is_in_window || line.rfind("#version", 0) == 0 || line.rfind("#creator", 0) == 0 || line.rfind("#timescale", 0) == 0)
+                {
+                    ret += line + '\n';
+                }
+                continue;
+            }
+            const auto time = std::stoull(line.substr(0, line.find(',')));
+            is_in_window = time >= start_time && time <= end_time;
+            if (is_in_window)
+            {
+                ret += line + '\n';
+            }
+        }
+        return ret;
+    };
+
+    btf::BtfReader reader("test.btf");
+    REQUIRE(reader.getHeader() == "#version 2.2.1\n#creator libBtf\n#timescale ns\n");
+    REQUIRE(reader.seekToTime(0) == reader.getDataOffset());
+    REQUIRE(reader.seekToTime(10) == reader.getDataOffset());
+    REQUIRE(reader.seekToTime(200001) == reader.getFileSize());
+
+    const auto data = readBtf("test.btf");
+    for (const auto& [start, end] : std::vector<std::pair<uint64_t, uint64_t>>{{0, 5}, {15, 15}, {20, 20}, {9995, 20010}, {150000, 300000}, {300000, 400000}})
+    {
+        btf::extractWindow("test.btf", "window.btf", start, end);
+        REQUIRE(readBtf("window.btf") == lines_in_window(data, start, end));
+    }
+
+    // the seek lands on the first of the events with the same timestamp
+    const auto offset = reader.seekToTime(12340);
+    std::ifstream in("test.btf", std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(offset));
+    std::string line;
+    std::getline(in, line);
+    REQUIRE(line == "12340,Core1,0,C,Core1,0,idle");
+
+    // stream the decoded records from the seek position on
+    reader.seekToTime(12340);
+    auto it = reader.begin();
+    REQUIRE(it->time_ == 12340);
+    REQUIRE(it->source_ == "Core1");
+    REQUIRE(it->type_ == btf::EntityTypes::core);
+    REQUIRE(it->target_ == "Core1");
+    REQUIRE(it->event_.core_event == btf::Core::Events::idle);
+    REQUIRE(it->event_name_ == "idle");
+    uint64_t events{0};
+    uint64_t comments{0};
+    uint64_t last_time{0};
+    for (; it != reader.end(); ++it)
+    {
+        if (it->type_ == btf::EntityTypes::comment)
+        {
+            REQUIRE(it->note_.substr(0, 8) == " comment");
+            ++comments;
+            continue;
+        }
+        REQUIRE(it->time_ >= last_time);
+        last_time = it->time_;
+        ++events;
+    }
+    REQUIRE(events == 2 * (20000 - 1234 + 1));
+    REQUIRE(comments == 19);
+    REQUIRE(last_time == 200000);
+    REQUIRE(reader.getNumberOfSkippedLines() == 0);
+
+    // the note is the rest of the line, it may contain the delimiter
+    std::ofstream("note.btf") << "#version 2.2.1\n#creator test\n#timescale ns\n100,Core1,0,SIG,Signal1,0,read,a,b,c\n";
+    btf::BtfReader note_reader("note.btf");
+    auto note = note_reader.begin();
+    REQUIRE(note->event_name_ == "read");
+    REQUIRE(note->note_ == "a,b,c");
+}
+
+TEST_CASE("Entity hashing", "[libBtf]")
+{
+    // the IDs must be stable across compilers, platforms and runs
+    REQUIRE(btf::hashEntityName("") == 0x93228a4de0eec5a2ULL);
+    REQUIRE(btf::hashEntityName("Core1") == 0xe5d38d52b02625f6ULL);
+    REQUIRE(btf::hashEntityName("Runnable_With_A_Long_Name") == 0x3170cc4a6ee5f9a8ULL);
+    REQUIRE(btf::hashEntityName("The quick brown fox jumps over the lazy dog, 0123456789 times") == 0x7bc7f2559a5759bbULL);
+
+    btf::BtfFile btf("test.btf");
+    REQUIRE(btf.hashName("Task1") == btf::hashEntityName("Task1"));
+
+    // a hasher that maps names of the same length to the same ID => Task2_ collides with Task1_
+    btf.setEntityHasher([](std::string_view name) -> uint64_t { return name.size(); });
+    REQUIRE(btf::ErrorCodes::success == btf.processEvent(100, "Core1", "Task1_", 0, btf::Process::Events::start));
+    REQUIRE(btf::ErrorCodes::hash_collision == btf.processEvent(200, "Core1", "Task2_", 0, btf::Process::Events::start));
+}
+
+// Reference implementations of the state machines before they were converted to transition tables.
+namespace legacy
+{
+btf::ErrorCodes coreTransition(btf::Core::States& state_, btf::Core::Events core_event)
+{
+    using States = btf::Core::States;
+    using Events = btf::Core::Events;
+    using ErrorCodes = btf::ErrorCodes;
+    switch (state_)
+    {
+    case States::idle:
+        if (core_event == Events::idle)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else if (core_event == Events::execute)
+        {
+            state_ = States::execution;
+        }
+        break;
+    case States::execution:
+        if (core_event == Events::execute)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else if (core_event == Events::idle)
+        {
+            state_ = States::idle;
+        }
+        break;
+    case States::unknown:
+        if (core_event == Events::execute)
+        {
+            state_ = States::execution;
+        }
+        else if (core_event == Events::idle)
+        {
+            state_ = States::idle;
+        }
+        break;
+    default:
+        FATAL_INTERNAL_ERROR_MSG("unknown state")
+    }
+    return ErrorCodes::success;
+}
+
+btf::ErrorCodes processTransition(btf::Process::States& state_, bool& was_started_, btf::Process::Events ev)
+{
+    using States = btf::Process::States;
+    using Events = btf::Process::Events;
+    using ErrorCodes = btf::ErrorCodes;
+    switch (state_)
+    {
+    case States::running:
+        if (ev == Events::wait)
+        {
+            state_ = States::waiting;
+        }
+        else if (ev == Events::poll)
+        {
+            state_ = States::polling;
+        }
+        else if (ev == Events::preempt)
+        {
+            state_ = States::ready;
+        }
+        else if (ev == Events::terminate)
+        {
+            state_ = States::terminated;
+        }
+        else if (ev == Events::nowait)
+        {
+            state_ = States::running; // no transition
+        }
+        else if (ev == Events::start || ev == Events::resume || ev == Events::run)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::polling:
+        if (ev == Events::run)
+        {
+            state_ = States::running;
+        }
+        else if (ev == Events::park)
+        {
+            state_ = States::parking;
+        }
+        else if (ev == Events::poll_parking || ev == Events::poll)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::waiting:
+        if (ev == Events::release)
+        {
+            state_ = States::ready;
+        }
+        else if (ev == Events::wait)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::parking:
+        if (ev == Events::poll_parking)
+        {
+            state_ = States::polling;
+        }
+        else if (ev == Events::release_parking)
+        {
+            state_ = States::ready;
+        }
+        else if (ev == Events::park)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::ready:
+        if (ev == Events::resume)
+        {
+            state_ = States::running;
+        }
+        else if (ev == Events::preempt || ev == Events::release || ev == Events::release_parking)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::active:
+        if (ev == Events::start)
+        {
+            state_ = States::running;
+            was_started_ = true;
+        }
+        else if (ev == Events::interrupt_suspended)
+        {
+            state_ = States::active;
+        }
+        else if (ev == Events::activate)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::terminated:
+        if (ev == Events::activate)
+        {
+            state_ = States::active;
+        }
+        else if (ev == Events::mtalimitexceeded)
+        {
+            state_ = States::terminated;
+        }
+        else if (ev == Events::terminate)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::unknown:
+        if (ev == Events::activate || ev == Events::mtalimitexceeded)
+        {
+            state_ = States::active;
+        }
+        else if (ev == Events::start)
+        {
+            was_started_ = true;
+            state_ = States::running;
+        }
+        else if (ev == Events::resume || ev == Events::run)
+        {
+            state_ = States::running;
+        }
+        else if (ev == Events::poll || ev == Events::poll_parking)
+        {
+            state_ = States::polling;
+        }
+        else if (ev == Events::park)
+        {
+            state_ = States::parking;
+        }
+        else if (ev == Events::release_parking || ev == Events::preempt || ev == Events::release)
+        {
+            state_ = States::ready;
+        }
+        else if (ev == Events::wait)
+        {
+            state_ = States::waiting;
+        }
+        else if (ev == Events::terminate || ev == Events::mtalimitexceeded)
+        {
+            state_ = States::terminated;
+        }
+        break;
+    }
+    return ErrorCodes::success;
+}
+
+btf::ErrorCodes runnableTransition(btf::Runnable::States& state_, btf::Runnable::Events core_event)
+{
+    using States = btf::Runnable::States;
+    using Events = btf::Runnable::Events;
+    using ErrorCodes = btf::ErrorCodes;
+    switch (state_)
+    {
+    case States::terminated:
+        if (core_event == Events::terminate)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else if (core_event == Events::start)
+        {
+            state_ = States::running;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::running:
+        if (core_event == Events::start || core_event == Events::resume)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else if (core_event == Events::suspend)
+        {
+            state_ = States::suspended;
+        }
+        else if (core_event == Events::terminate)
+        {
+            state_ = States::terminated;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::suspended:
+        if (core_event == Events::suspend)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else if (core_event == Events::resume)
+        {
+            state_ = States::running;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::unknown:
+        if (core_event == Events::start || core_event == Events::resume)
+        {
+            state_ = States::running;
+        }
+        else if (core_event == Events::terminate)
+        {
+            state_ = States::terminated;
+        }
+        else if (core_event == Events::suspend)
+        {
+            state_ = States::suspended;
+        }
+        break;
+    default:
+        FATAL_INTERNAL_ERROR_MSG("unknown state")
+        break;
+    }
+    return ErrorCodes::success;
+}
+
+btf::ErrorCodes semaphoreTransition(btf::Semaphore::States& state_, btf::Semaphore::Events ev)
+{
+    using States = btf::Semaphore::States;
+    using Events = btf::Semaphore::Events;
+    using ErrorCodes = btf::ErrorCodes;
+    switch (state_)
+    {
+    case States::free:
+        if (ev == Events::used)
+        {
+            state_ = States::used;
+        }
+        else if (ev == Events::lock)
+        {
+            state_ = States::full;
+        }
+        else if (ev == Events::free || ev == Events::unlock)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::full:
+        if (ev == Events::unlock)
+        {
+            state_ = States::free;
+        }
+        else if (ev == Events::unlock_full)
+        {
+            state_ = States::used;
+        }
+        else if (ev == Events::overfull)
+        {
+            state_ = States::overfull;
+        }
+        else if (ev == Events::full || ev == Events::lock || ev == Events::lock_used)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::overfull:
+        if (ev == Events::full)
+        {
+            state_ = States::full;
+        }
+        else if (ev == Events::overfull)
+        {
+            state_ = States::overfull;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::used:
+        if (ev == Events::free)
+        {
+            state_ = States::free;
+        }
+        else if (ev == Events::lock_used)
+        {
+            state_ = States::full;
+        }
+        else if (ev == Events::used)
+        {
+            state_ = States::used;
+        }
+        else if (ev == Events::unlock_full)
+        {
+            return ErrorCodes::already_in_state;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    case States::unknown:
+        if (ev == Events::used || ev == Events::unlock_full)
+        {
+            state_ = States::used;
+        }
+        else if (ev == Events::free || ev == Events::unlock)
+        {
+            state_ = States::free;
+        }
+        else if (ev == Events::lock || ev == Events::lock_used || ev == Events::full)
+        {
+            state_ = States::full;
+        }
+        else if(ev == Events::overfull)
+        {
+            state_ = States::overfull;
+        }
+        else
+        {
+            return ErrorCodes::invalid_state_transition;
+        }
+        break;
+    }
+    return ErrorCodes::success;
+}
+} // namespace legacy
+
+template <typename Entity, typename Reference> void checkStateMachine(Reference reference)
+{
+    using States = typename Entity::States;
+    using Events = typename Entity::Events;
+    for (size_t s = 0; s <= static_cast<size_t>(States::unknown); ++s)
+    {
+        for (size_t e = 0; e <= static_cast<size_t>(Events::unknown); ++e)
+        {
+            const auto state = static_cast<States>(s);
+            const auto ev = static_cast<Events>(e);
+            auto expected_state = state;
+            bool expected_started{false};
+            const auto expected_result = reference(expected_state, expected_started, ev);
+
+            const auto& transition = Entity::getTransition(state, ev);
+            REQUIRE(transition.result_ == expected_result);
+            REQUIRE(transition.marks_started_ == expected_started);
+
+            Entity entity(state);
+            REQUIRE(entity.doStateTransition(ev) == expected_result);
+            REQUIRE(entity.getState() == expected_state);
+        }
+    }
+}
+
+TEST_CASE("State transition tables", "[libBtf]")
+{
+    checkStateMachine<btf::Core>([](auto& state, bool&, auto ev) { return legacy::coreTransition(state, ev); });
+    checkStateMachine<btf::Process>([](auto& state, bool& started, auto ev) { return legacy::processTransition(state, started, ev); });
+    checkStateMachine<btf::Runnable>([](auto& state, bool&, auto ev) { return legacy::runnableTransition(state, ev); });
+    checkStateMachine<btf::Semaphore>([](auto& state, bool&, auto ev) { return legacy::semaphoreTransition(state, ev); });
+}
+
 TEST_CASE("Logging", "[libhelper]")
 {
     helper::logging::initLogging(helper::logging::LogLevel::trace, "log.txt");
+    // the messages are written on the three lines after the location
+    const auto location = source_location::current();
     helper::logging::printTrace() << "This is a trace message" << '\n';
     helper::logging::printWarning() << "This is a warning message" << '\n';
     helper::logging::printError() << "This is an error message" << '\n';
@@ -1051,9 +2908,66 @@ TEST_CASE("Logging", "[libhelper]")
 
     auto data = readBtf("log.txt");
 
-    std::string should_be = "Trace [file: test\\libBtfTest.cpp: 1047 `____C_A_T_C_H____T_E_S_T____44`] This is a trace message\n"
-                            "Warning [file: test\\libBtfTest.cpp: 1048 `____C_A_T_C_H____T_E_S_T____44`] This is a warning message\n"
-                            "Error [file: test\\libBtfTest.cpp: 1049 `____C_A_T_C_H____T_E_S_T____44`] This is an error message\n";
+    const auto prefix = [&location](const std::string& log_level, unsigned line) {
+        return log_level + " [file: " + std::string(helper::logging::stripSourceFileName(location.file_name())) + ": " + std::to_string(line) + " `" +
+               location.function_name() + "`] ";
+    };
+    std::string should_be = prefix("Trace", location.line() + 1) + "This is a trace message\n" + prefix("Warning", location.line() + 2) +
+                            "This is a warning message\n" + prefix("Error", location.line() + 3) + "This is an error message\n";
 
     REQUIRE(should_be == data);
 }
+
+TEST_CASE("Logging from multiple threads", "[libhelper]")
+{
+    helper::logging::initLogging(helper::logging::LogLevel::warning, "log_threads.txt");
+
+    constexpr int num_threads{4};
+    constexpr int num_messages{5000};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < num_messages; ++i)
+            {
+                helper::logging::printWarning() << "thread " << t << " message " << i << '\n';
+                helper::logging::printTrace() << "not written\n";
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    // flush must drain all pending messages
+    helper::logging::flush();
+
+    std::ifstream in("log_threads.txt");
+    std::string line;
+    std::vector<int> next_message(num_threads, 0);
+    int num_lines{0};
+    while (std::getline(in, line))
+    {
+        auto pos = line.find("thread ");
+        REQUIRE(pos != std::string::npos);
+        std::istringstream fields(line.substr(pos));
+        std::string word;
+        int t{0};
+        int i{0};
+        fields >> word >> t >> word >> i;
+        // messages of one thread keep their order
+        REQUIRE(next_message[t] == i);
+        ++next_message[t];
+        ++num_lines;
+    }
+    REQUIRE(num_lines == num_threads * num_messages);
+
+    // a text for the standard output is written after the pending messages, in one piece
+    std::ostringstream output;
+    auto* const buffer = std::cout.rdbuf(output.rdbuf());
+    helper::logging::printOutput("converted 1 file\n");
+    std::cout.rdbuf(buffer);
+    REQUIRE(output.str() == "converted 1 file\n");
+
+    helper::logging::initLogging(helper::logging::LogLevel::warning, "log.txt");
+}